@@ -0,0 +1,174 @@
+// errorDB.xml downloads against the uartcodes.com stand-in (tools/dbserver), run in
+// process: a first fetch updates, a repeat costs one 304, a server without validators
+// sending the same bytes leaves the file and its mtime alone, a changed fixture updates
+// again and an aborted transfer leaves the existing file untouched.
+// Exits non-zero on the first step that does not behave.
+#include "databasedownloader.h"
+#include "errordbserver.h"
+#include <QCoreApplication>
+#include <QDir>
+#include <QEventLoop>
+#include <QFile>
+#include <QFileInfo>
+#include <QNetworkAccessManager>
+#include <QTemporaryDir>
+#include <QTimer>
+#include <cstdio>
+
+namespace {
+
+int failures = 0;
+
+void check(bool condition, const char *step, const QString &detail = QString())
+{
+    std::printf("  %-58s %s\n", step, condition ? "ok" : "FAILED");
+    if (!condition) {
+        ++failures;
+        if (!detail.isEmpty()) {
+            std::printf("    %s\n", qPrintable(detail));
+        }
+    }
+}
+
+QByteArray readFile(const QString &path)
+{
+    QFile file(path);
+    return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+}
+
+bool writeFile(const QString &path, const QByteArray &content)
+{
+    QFile file(path);
+    return file.open(QIODevice::WriteOnly) && file.write(content) == content.size();
+}
+
+const char *outcomeName(DatabaseDownloader::Outcome outcome)
+{
+    switch (outcome) {
+    case DatabaseDownloader::Outcome::Updated:
+        return "Updated";
+    case DatabaseDownloader::Outcome::Unchanged:
+        return "Unchanged";
+    default:
+        return "Failed";
+    }
+}
+
+// Runs one download to completion. With abortOnData the transfer is aborted as soon as
+// the first body bytes arrive; the downloader reports nothing then, so the loop ends on
+// a short grace timer instead.
+DatabaseDownloader::Result download(DatabaseDownloader &downloader, const QUrl &url, const QString &destination,
+                                    bool abortOnData = false, bool *finished = nullptr)
+{
+    DatabaseDownloader::Result result;
+    result.errorString = "Timed out";
+    bool done = false;
+    QEventLoop loop;
+    const QMetaObject::Connection onFinished = QObject::connect(&downloader, &DatabaseDownloader::finished, &loop,
+        [&](const DatabaseDownloader::Result &r) {
+            result = r;
+            done = true;
+            loop.quit();
+        });
+    QMetaObject::Connection onProgress;
+    if (abortOnData) {
+        onProgress = QObject::connect(&downloader, &DatabaseDownloader::progress, &loop, [&](qint64 received, qint64) {
+            if (received > 0 && downloader.isRunning()) {
+                downloader.abort();
+                QTimer::singleShot(500, &loop, &QEventLoop::quit); // Anything still queued lands meanwhile
+            }
+        });
+    }
+    QTimer::singleShot(15000, &loop, &QEventLoop::quit);
+    downloader.start(url, destination);
+    loop.exec();
+    QObject::disconnect(onFinished);
+    QObject::disconnect(onProgress);
+    if (finished) {
+        *finished = done;
+    }
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QTemporaryDir dir;
+    if (!dir.isValid() || !QDir(dir.path()).mkpath("server") || !QDir(dir.path()).mkpath("client")) {
+        std::fprintf(stderr, "download_check: no temporary directory\n");
+        return 1;
+    }
+    const QString fixturePath = dir.filePath("server/errorDB.xml");
+    const QString destination = dir.filePath("client/errorDB.xml");
+    const QByteArray original = readFile(":/fixtures/errorDB.xml");
+    if (original.isEmpty() || !writeFile(fixturePath, original)) {
+        std::fprintf(stderr, "download_check: could not prepare the fixture\n");
+        return 1;
+    }
+
+    ErrorDbServer server(fixturePath);
+    ErrorDbServer::Options plainOptions;
+    plainOptions.validators = false;
+    ErrorDbServer plainServer(fixturePath, plainOptions);
+    QString error;
+    if (!server.listen(QHostAddress::LocalHost, 0, &error) || !plainServer.listen(QHostAddress::LocalHost, 0, &error)) {
+        std::fprintf(stderr, "download_check: %s\n", qPrintable(error));
+        return 1;
+    }
+    const QUrl url(QString("http://127.0.0.1:%1/xml.php").arg(server.port()));
+    const QUrl plainUrl(QString("http://127.0.0.1:%1/xml.php").arg(plainServer.port()));
+
+    QNetworkAccessManager manager;
+    DatabaseDownloader downloader(&manager);
+    std::printf("DatabaseDownloader against tools/dbserver\n");
+
+    DatabaseDownloader::Result result = download(downloader, url, destination);
+    check(result.outcome == DatabaseDownloader::Outcome::Updated && readFile(destination) == original,
+          "first fetch: Updated", QString("%1 %2").arg(outcomeName(result.outcome), result.errorString));
+
+    const quint64 requestsBefore = server.requestCount();
+    const quint64 notModifiedBefore = server.notModifiedResponses();
+    result = download(downloader, url, destination);
+    check(result.outcome == DatabaseDownloader::Outcome::Unchanged && server.requestCount() == requestsBefore + 1
+              && server.notModifiedResponses() == notModifiedBefore + 1,
+          "repeat fetch: one request, 304, Unchanged",
+          QString("%1, %2 requests").arg(outcomeName(result.outcome)).arg(server.requestCount() - requestsBefore));
+
+    // Pushed into the past, so any rewrite of the file shows up however coarse the clock
+    const QDateTime past = QDateTime::currentDateTime().addDays(-1);
+    {
+        QFile file(destination);
+        file.open(QIODevice::ReadWrite);
+        file.setFileTime(past, QFileDevice::FileModificationTime);
+    }
+    const QDateTime mtimeBefore = QFileInfo(destination).lastModified();
+    result = download(downloader, plainUrl, destination);
+    check(result.outcome == DatabaseDownloader::Outcome::Unchanged && QFileInfo(destination).lastModified() == mtimeBefore,
+          "no validators, same bytes: Unchanged, mtime kept", outcomeName(result.outcome));
+
+    QByteArray changed = original;
+    changed.replace("Fixture: Fan stopped", "Fixture: Fan stopped (revised)");
+    writeFile(fixturePath, changed);
+    result = download(downloader, url, destination);
+    check(result.outcome == DatabaseDownloader::Outcome::Updated && readFile(destination) == changed,
+          "changed fixture: Updated", QString("%1 %2").arg(outcomeName(result.outcome), result.errorString));
+
+    // Large enough that the body arrives in several reads, so the abort lands mid-transfer
+    QByteArray large = changed;
+    const QByteArray filler = "    <!-- padding to make the transfer span many reads -->\n";
+    large.insert(large.indexOf("<errorCodes>") + 12, filler.repeated(16 * 1024 * 1024 / filler.size()));
+    writeFile(fixturePath, large);
+    const QDateTime mtimeBeforeAbort = QFileInfo(destination).lastModified();
+    bool finished = false;
+    download(downloader, url, destination, true, &finished);
+    const QStringList leftovers = QDir(dir.filePath("client")).entryList(QDir::Files);
+    check(!finished && readFile(destination) == changed && QFileInfo(destination).lastModified() == mtimeBeforeAbort
+              && leftovers == QStringList({ "errorDB.xml", "errorDB.xml.meta" }),
+          "aborted transfer: existing file untouched", leftovers.join(", "));
+
+    std::printf("%s\n", failures == 0 ? "All download checks passed" : "Download checks FAILED");
+    return failures == 0 ? 0 : 1;
+}
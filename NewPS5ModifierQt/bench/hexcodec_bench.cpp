@@ -0,0 +1,95 @@
+// Compares the HexCodec kernels with the Qt calls Backend used before
+// (QByteArray::toHex(' ') on open, remove(' ') + toUtf8() + fromHex() on save).
+#include "hexcodec.h"
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QString>
+#include <cstdio>
+#include <functional>
+
+namespace {
+
+// Best of `runs` wall-clock timings in milliseconds.
+double bestOf(int runs, const std::function<void()> &body)
+{
+    double best = 0;
+    for (int i = 0; i < runs; ++i) {
+        QElapsedTimer timer;
+        timer.start();
+        body();
+        const double ms = timer.nsecsElapsed() / 1e6;
+        if (i == 0 || ms < best) {
+            best = ms;
+        }
+    }
+    return best;
+}
+
+void report(const char *name, qsizetype bytes, double ms)
+{
+    std::printf("  %-28s %10.3f ms %10.1f MB/s\n", name, ms, bytes / 1024.0 / 1024.0 / (ms / 1000.0));
+}
+
+void runSize(qsizetype size, int runs)
+{
+    std::printf("%lld MB input, best of %d runs\n", static_cast<long long>(size / 1024 / 1024), runs);
+
+    QByteArray data(size, Qt::Uninitialized);
+    QRandomGenerator rng(0x5053354E); // Fixed seed keeps runs comparable
+    rng.fillRange(reinterpret_cast<quint32 *>(data.data()), size / sizeof(quint32));
+
+    QByteArray qtHex;
+    report("encode Qt toHex(' ')", size, bestOf(runs, [&] { qtHex = data.toHex(' '); }));
+
+    QByteArray hex(HexCodec::encodedLength(size), Qt::Uninitialized);
+    const HexCodec::Kernel kernels[] = { HexCodec::Kernel::Scalar, HexCodec::Kernel::Sse2, HexCodec::Kernel::Avx2 };
+    for (HexCodec::Kernel kernel : kernels) {
+        if (!HexCodec::isKernelSupported(kernel)) {
+            continue;
+        }
+        const QByteArray name = QByteArray("encode ") + HexCodec::kernelName(kernel);
+        report(name.constData(), size, bestOf(runs, [&] {
+            HexCodec::encode(reinterpret_cast<const uchar *>(data.constData()), size, hex.data(), ' ', kernel);
+        }));
+    }
+    if (hex != qtHex) {
+        std::printf("  ERROR: encode output differs from QByteArray::toHex\n");
+    }
+
+    // Saving starts from the QML text, i.e. a UTF-16 QString
+    const QString text = QString::fromLatin1(hex);
+    QByteArray decoded;
+    report("decode Qt remove+fromHex", size, bestOf(runs, [&] {
+        QString tempHex = text;
+        tempHex.remove(' ');
+        decoded = QByteArray::fromHex(tempHex.toUtf8());
+    }));
+
+    QByteArray out(HexCodec::maxDecodedLength(text.size()), Qt::Uninitialized);
+    for (HexCodec::Kernel kernel : kernels) {
+        if (!HexCodec::isKernelSupported(kernel)) {
+            continue;
+        }
+        HexCodec::DecodeResult result;
+        const QByteArray name = QByteArray("decode ") + HexCodec::kernelName(kernel) + " (utf-16)";
+        report(name.constData(), size, bestOf(runs, [&] {
+            result = HexCodec::decode(reinterpret_cast<const char16_t *>(text.utf16()), text.size(),
+                                      reinterpret_cast<uchar *>(out.data()), kernel);
+        }));
+        if (!result.ok() || qsizetype(result.bytesWritten) != size || out.left(size) != data) {
+            std::printf("  ERROR: %s decode mismatch\n", HexCodec::kernelName(kernel));
+        }
+    }
+    std::printf("\n");
+}
+
+} // namespace
+
+int main()
+{
+    std::printf("Active kernel: %s\n\n", HexCodec::kernelName(HexCodec::Kernel::Auto));
+    runSize(2 * 1024 * 1024, 20);   // Typical NOR dump
+    runSize(64 * 1024 * 1024, 3);   // Full flash image
+    return 0;
+}
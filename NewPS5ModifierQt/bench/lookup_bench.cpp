@@ -0,0 +1,128 @@
+// Online error lookups against the uartcodes.com stand-in (tools/dbserver), run in
+// process. Checks that duplicate lookups are coalesced, that cached codes never reach
+// the server and that a batch respects the concurrency limit; prints timings for a
+// cold batch, the same batch warm and a batch after reloading the persisted cache.
+// Exits non-zero if the server saw more requests than there were distinct codes.
+#include "errordbserver.h"
+#include "onlineerrorlookup.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QNetworkAccessManager>
+#include <QTemporaryDir>
+#include <QTimer>
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+
+// Runs one batch to completion, returns the elapsed time in ms or -1 on timeout.
+qint64 runBatch(OnlineErrorLookup &lookup, const QStringList &codes, int *failures, int *peakInFlight)
+{
+    QEventLoop loop;
+    QElapsedTimer timer;
+    int expectedId = 0;
+    QObject::connect(&lookup, &OnlineErrorLookup::batchFinished, &loop,
+                     [&](int batchId, const QList<OnlineErrorLookup::Result> &results) {
+                         if (batchId != expectedId) {
+                             return;
+                         }
+                         for (const OnlineErrorLookup::Result &result : results) {
+                             *failures += result.ok() ? 0 : 1;
+                         }
+                         loop.quit();
+                     });
+    QTimer probe; // Samples how many requests are on the wire
+    QObject::connect(&probe, &QTimer::timeout, &loop, [&]() { *peakInFlight = std::max(*peakInFlight, lookup.inFlightCount()); });
+    probe.start(1);
+    bool timedOut = false;
+    QTimer::singleShot(30000, &loop, [&]() { timedOut = true; loop.quit(); });
+
+    timer.start();
+    expectedId = lookup.lookupBatch(codes);
+    *peakInFlight = std::max(*peakInFlight, lookup.inFlightCount());
+    loop.exec();
+    QObject::disconnect(&lookup, &OnlineErrorLookup::batchFinished, &loop, nullptr);
+    return timedOut ? -1 : timer.elapsed();
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Online error lookup cache and coalescing benchmark.");
+    parser.addHelpOption();
+    QCommandLineOption delayOption("delay-ms", "Server delay per response.", "ms", "50");
+    QCommandLineOption concurrencyOption("concurrency", "OnlineErrorLookup::maxConcurrent.", "n",
+                                         QString::number(OnlineErrorLookup::DefaultMaxConcurrent));
+    parser.addOptions({ delayOption, concurrencyOption });
+    parser.process(app);
+
+    QTemporaryDir dir;
+    ErrorDbServer::Options serverOptions;
+    serverOptions.delayMs = parser.value(delayOption).toInt();
+    ErrorDbServer server(":/fixtures/errorDB.xml", serverOptions);
+    QString error;
+    if (!dir.isValid() || !server.listen(QHostAddress::LocalHost, 0, &error)) {
+        std::fprintf(stderr, "lookup_bench: %s\n", qPrintable(error));
+        return 1;
+    }
+    const QUrl url(QString("http://127.0.0.1:%1/xml.php").arg(server.port()));
+    const QString cachePath = dir.filePath("onlineErrorCache.json");
+    const int concurrency = parser.value(concurrencyOption).toInt();
+
+    // Six distinct codes, each asked for several times and in different spellings
+    const QStringList codes = { "80810001", "80801101", "80830000", "C0010001", "80C00140", "DEADBEEF" };
+    QStringList batch;
+    for (int round = 0; round < 4; ++round) {
+        for (const QString &code : codes) {
+            batch.append(round % 2 ? code.toLower() : code);
+        }
+    }
+
+    QNetworkAccessManager manager;
+    int failures = 0;
+    int peak = 0;
+    qint64 cold = 0;
+    qint64 warm = 0;
+    {
+        OnlineErrorLookup lookup(&manager);
+        lookup.setUrl(url);
+        lookup.setCachePath(cachePath);
+        lookup.setMaxConcurrent(concurrency);
+
+        // Duplicates of a code already on the wire share its reply
+        for (int i = 0; i < 5; ++i) {
+            lookup.lookup(codes.first());
+        }
+        cold = runBatch(lookup, batch, &failures, &peak);
+        warm = runBatch(lookup, batch, &failures, &peak);
+    } // Saves the cache
+
+    qint64 reloaded = 0;
+    int reloadPeak = 0;
+    {
+        OnlineErrorLookup lookup(&manager);
+        lookup.setUrl(url);
+        lookup.setCachePath(cachePath);
+        reloaded = runBatch(lookup, batch, &failures, &reloadPeak);
+    }
+
+    std::printf("%-28s %8s\n", "batch (24 lookups, 6 codes)", "ms");
+    std::printf("%-28s %8lld\n", "cold", static_cast<long long>(cold));
+    std::printf("%-28s %8lld\n", "warm (in-memory cache)", static_cast<long long>(warm));
+    std::printf("%-28s %8lld\n", "warm (reloaded from disk)", static_cast<long long>(reloaded));
+    std::printf("server requests %llu, peak in flight %d (limit %d), failed lookups %d\n",
+                static_cast<unsigned long long>(server.requestCount()), peak, concurrency, failures);
+
+    const bool ok = cold >= 0 && warm >= 0 && reloaded >= 0 && failures == 0
+        && server.requestCount() == quint64(codes.size()) && peak <= concurrency;
+    if (!ok) {
+        std::fprintf(stderr, "lookup_bench: expected exactly %lld requests and no failures\n",
+                     static_cast<long long>(codes.size()));
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,301 @@
+// Repeatable benchmarks of the norcore library on generated 2 MB and 64 MB images:
+// open+parse, hex encode/decode, diff, search, region analysis, error database lookups, patch+save
+// and the cost of a trace span. Results can be written as JSON and compared against a previous
+// run to fail a build that got slower than --tolerance.
+#include "errordatabaseindex.h"
+#include "hexcodec.h"
+#include "noranalysis.h"
+#include "nordiff.h"
+#include "norimage.h"
+#include "norlayout.h"
+#include "norpatch.h"
+#include "norsearch.h"
+#include "tracer.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+namespace {
+
+struct Measurement {
+    QString name;
+    double ms;
+};
+
+std::vector<Measurement> results;
+
+// Best of `runs` wall-clock timings in milliseconds, recorded under name.
+void measure(const QString &name, int runs, const std::function<void()> &body, double bytes = 0)
+{
+    double best = 0;
+    for (int i = 0; i < runs; ++i) {
+        QElapsedTimer timer;
+        timer.start();
+        body();
+        const double ms = timer.nsecsElapsed() / 1e6;
+        if (i == 0 || ms < best) {
+            best = ms;
+        }
+    }
+    results.push_back({ name, best });
+    if (bytes > 0) {
+        std::printf("  %-34s %10.3f ms %10.1f MB/s\n", qPrintable(name), best, bytes / 1024.0 / 1024.0 / (best / 1000.0));
+    } else {
+        std::printf("  %-34s %10.3f ms\n", qPrintable(name), best);
+    }
+}
+
+void put(QByteArray &image, quint32 offset, const QByteArray &bytes)
+{
+    std::memcpy(image.data() + offset, bytes.constData(), size_t(bytes.size()));
+}
+
+// Erased flash with a plausible identity, so parse() and the patcher do real work
+QByteArray generateImage(qsizetype size)
+{
+    QByteArray image(size, Qt::Uninitialized);
+    QRandomGenerator rng(0x5053354E); // Fixed seed keeps runs comparable
+    rng.fillRange(reinterpret_cast<quint32 *>(image.data()), size / sizeof(quint32));
+    using namespace NorLayout;
+    std::memset(image.data() + kSpanBegin, 0xFF, kSpanEnd - kSpanBegin);
+    put(image, descriptor(Field::LanMac).offset, QByteArray::fromHex("0CDDEF102030"));
+    put(image, descriptor(Field::EditionFlag).offset, QByteArray(reinterpret_cast<const char *>(kDiscEditionFlag), 4));
+    put(image, descriptor(Field::EditionFlagBackup).offset, QByteArray(reinterpret_cast<const char *>(kDiscEditionFlag), 4));
+    put(image, descriptor(Field::MoboSerial).offset, QByteArray("M00000000000001", 16));
+    put(image, descriptor(Field::BoardSerial).offset, QByteArray("A0000000000000001", 17));
+    put(image, descriptor(Field::Variant).offset, QByteArray("CFI-1016A"));
+    put(image, descriptor(Field::WifiMac).offset, QByteArray::fromHex("0CDDEF102031"));
+    return image;
+}
+
+bool writeFile(const QString &path, const QByteArray &data)
+{
+    QFile file(path);
+    return file.open(QIODevice::WriteOnly) && file.write(data) == data.size();
+}
+
+QByteArray generateDatabase(int codes)
+{
+    QByteArray xml = "<?xml version=\"1.0\"?>\n<errorCodes>\n";
+    for (int i = 0; i < codes; ++i) {
+        const QString code = QString::number(0x80800000u + quint32(i) * 7, 16).toUpper();
+        xml += QString("<errorCode><ErrorCode>%1</ErrorCode><Description>Generated description %2</Description></errorCode>\n")
+                   .arg(code).arg(i).toUtf8();
+    }
+    xml += "</errorCodes>\n";
+    return xml;
+}
+
+void runImage(const QTemporaryDir &dir, qsizetype size, int runs)
+{
+    const QString label = QString("%1MB").arg(size / 1024 / 1024);
+    std::printf("%s image, best of %d runs\n", qPrintable(label), runs);
+    const QString source = dir.filePath(label + ".bin");
+    const QByteArray image = generateImage(size);
+    if (!writeFile(source, image)) {
+        std::printf("  ERROR: could not write %s\n", qPrintable(source));
+        return;
+    }
+
+    NorLayout::NorDetails details;
+    measure(label + " open+parse", runs, [&] {
+        NorImage norImage;
+        norImage.open(source);
+        details = NorLayout::parse(norImage.view());
+    });
+    if (details.edition != NorLayout::Edition::Disc) {
+        std::printf("  ERROR: parse did not find the edition flag\n");
+    }
+
+    QByteArray hex(HexCodec::encodedLength(size), Qt::Uninitialized);
+    measure(label + " hex encode", runs, [&] {
+        HexCodec::encode(reinterpret_cast<const uchar *>(image.constData()), size, hex.data());
+    }, double(size));
+    QByteArray decoded(HexCodec::maxDecodedLength(hex.size()), Qt::Uninitialized);
+    measure(label + " hex decode", runs, [&] {
+        HexCodec::decode(hex.constData(), size_t(hex.size()), reinterpret_cast<uchar *>(decoded.data()));
+    }, double(size));
+    if (decoded.left(size) != image) {
+        std::printf("  ERROR: hex round trip mismatch\n");
+    }
+
+    // A dump from another console: identity fields and a few scattered blocks differ
+    QByteArray other = image;
+    put(other, NorLayout::descriptor(NorLayout::Field::BoardSerial).offset, QByteArray("B0000000000000002", 17));
+    put(other, NorLayout::descriptor(NorLayout::Field::WifiMac).offset, QByteArray::fromHex("0CDDEF405060"));
+    for (qsizetype offset = 0x10000; offset + 64 <= size; offset += size / 64) {
+        std::memset(other.data() + offset, 0xA5, 64);
+    }
+    NorDiff::Result diff;
+    measure(label + " diff", runs, [&] { diff = NorDiff::compare(image, other); }, double(size));
+    const quint32 boardSerialBit = 1u << int(NorLayout::Field::BoardSerial);
+    const bool labelled = std::any_of(diff.regions.cbegin(), diff.regions.cend(),
+                                      [&](const NorDiff::Region &region) { return region.fields & boardSerialBit; });
+    if (!labelled) {
+        std::printf("  ERROR: diff did not attribute a region to the board serial\n");
+    }
+
+    const QByteArray flag(reinterpret_cast<const char *>(NorLayout::kDiscEditionFlag), 4);
+    QList<qint64> hits;
+    measure(label + " search", runs, [&] { hits = NorSearch::findAll(image, flag); }, double(size));
+    if (!hits.contains(qint64(NorLayout::descriptor(NorLayout::Field::EditionFlag).offset))) {
+        std::printf("  ERROR: search did not find the edition flag\n");
+    }
+    NorSearch::PatternSet patterns;
+    patterns.build({ flag, QByteArray(reinterpret_cast<const char *>(NorLayout::kDigitalEditionFlag), 4),
+                     QByteArray("CFI-"), QByteArray::fromHex("0CDDEF") });
+    QList<NorSearch::Hit> patternHits;
+    measure(label + " search 4 patterns", runs, [&] { patternHits = patterns.findAll(image); }, double(size));
+    if (patternHits.size() < hits.size() + 3) {
+        std::printf("  ERROR: pattern set missed matches\n");
+    }
+
+    // Single threaded; the app spreads the blocks over a pool
+    QList<NorAnalysis::BlockStats> blocks(NorAnalysis::blockCount(size));
+    measure(label + " region analysis", runs, [&] {
+        NorAnalysis::analyzeBlocks(image, 0, blocks.size(), blocks.data());
+    }, double(size));
+    const NorAnalysis::Summary regions = NorAnalysis::summarize(blocks);
+    if (regions.erased == 0 || regions.random == 0) {
+        std::printf("  ERROR: region analysis missed the erased span or the random data\n");
+    }
+
+    const QString destination = dir.filePath(label + "-patched.bin");
+    QVariantMap modifications;
+    modifications["model"] = "Digital Edition";
+    modifications["boardSerial"] = "B0000000000000002";
+    measure(label + " patch+save", runs, [&] {
+        NorImage norImage;
+        norImage.open(source, NorImage::Mode::CopyOnWrite);
+        QList<NorPatch::Range> ranges;
+        QString error;
+        if (!NorPatch::applyModifications(norImage.data(), norImage.size(), modifications, &ranges, &error)
+            || !NorPatch::writePatchedCopy(source, destination, norImage, ranges, &error)) {
+            std::printf("  ERROR: %s\n", qPrintable(error));
+        }
+    });
+    std::printf("\n");
+}
+
+void runDatabase(const QTemporaryDir &dir, int codes, int lookups)
+{
+    std::printf("Error database, %d codes\n", codes);
+    const QString xmlPath = dir.filePath("errorDB.xml");
+    writeFile(xmlPath, generateDatabase(codes));
+
+    ErrorDatabaseIndex index;
+    measure("db index rebuild", 5, [&] { index.rebuild(xmlPath); });
+    measure("db index load (mapped sidecar)", 20, [&] { index.load(xmlPath); });
+
+    std::vector<QString> queries;
+    QRandomGenerator rng(42);
+    for (int i = 0; i < 1024; ++i) {
+        // One in four misses, like codes newer than the downloaded database
+        const quint32 n = rng.bounded(quint32(codes + codes / 3));
+        queries.push_back(QString::number(0x80800000u + n * 7, 16).toUpper());
+    }
+    int found = 0;
+    measure(QString("db %1 lookups").arg(lookups), 5, [&] {
+        QString description;
+        found = 0;
+        for (int i = 0; i < lookups; ++i) {
+            found += index.lookup(queries[size_t(i) & 1023], &description) ? 1 : 0;
+        }
+    });
+    std::printf("  %.1f%% hits, %.0f ns per lookup\n\n", 100.0 * found / lookups,
+                results.back().ms * 1e6 / lookups);
+}
+
+// What a TraceSpan adds to the code it wraps, with tracing off and on
+void runTracing(int spans)
+{
+    std::printf("Tracing, %d spans\n", spans);
+    for (const bool enabled : { false, true }) {
+        Tracer::setEnabled(enabled);
+        measure(QString("trace %1 spans %2").arg(spans).arg(enabled ? "enabled" : "disabled"), 5, [&] {
+            for (int i = 0; i < spans; ++i) {
+                TraceSpan span("bench");
+            }
+        });
+        std::printf("  %.1f ns per span\n", results.back().ms * 1e6 / spans);
+        Tracer::instance().clear();
+    }
+    Tracer::setEnabled(false);
+    std::printf("\n");
+}
+
+bool compareWithBaseline(const QString &path, double tolerance)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        std::printf("Baseline %s not readable\n", qPrintable(path));
+        return false;
+    }
+    const QJsonObject baseline = QJsonDocument::fromJson(file.readAll()).object();
+    bool ok = true;
+    std::printf("Against %s (tolerance %.0f%%)\n", qPrintable(path), tolerance * 100);
+    for (const Measurement &m : results) {
+        const double before = baseline.value(m.name).toDouble(-1);
+        if (before <= 0) {
+            continue;
+        }
+        const double change = m.ms / before - 1.0;
+        const bool regressed = change > tolerance;
+        ok = ok && !regressed;
+        std::printf("  %-34s %+7.1f%%%s\n", qPrintable(m.name), change * 100, regressed ? "  REGRESSION" : "");
+    }
+    return ok;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption jsonOption("json", "Write the timings (ms) to a JSON file.", "file");
+    QCommandLineOption baselineOption("baseline", "Compare with a JSON file from an earlier run.", "file");
+    QCommandLineOption toleranceOption("tolerance", "Allowed slowdown against the baseline.", "fraction", "0.25");
+    parser.addOptions({ jsonOption, baselineOption, toleranceOption });
+    parser.process(app);
+
+    QTemporaryDir dir;
+    if (!dir.isValid()) {
+        std::fprintf(stderr, "norcore_bench: no temporary directory\n");
+        return 1;
+    }
+    std::printf("Hex kernel: %s\n\n", HexCodec::kernelName(HexCodec::activeKernel()));
+    runImage(dir, 2 * 1024 * 1024, 20); // Typical NOR dump
+    runImage(dir, 64 * 1024 * 1024, 3); // Full flash image
+    runDatabase(dir, 20000, 1000000);
+    runTracing(1000000);
+
+    if (parser.isSet(jsonOption)) {
+        QJsonObject json;
+        for (const Measurement &m : results) {
+            json[m.name] = m.ms;
+        }
+        QFile file(parser.value(jsonOption));
+        if (!file.open(QIODevice::WriteOnly) || file.write(QJsonDocument(json).toJson()) < 0) {
+            std::fprintf(stderr, "norcore_bench: could not write %s\n", qPrintable(file.fileName()));
+            return 1;
+        }
+    }
+    if (parser.isSet(baselineOption)
+        && !compareWithBaseline(parser.value(baselineOption), parser.value(toleranceOption).toDouble())) {
+        return 2;
+    }
+    return 0;
+}
@@ -0,0 +1,191 @@
+// Round-trip latency and errlog throughput of the serial stack against the pty
+// console simulator (tools/uartsim). "direct" feeds the command engine straight from
+// QSerialPort::readyRead; "worker" is the app's path: port on its own thread, receive
+// ring, GUI side drain every SerialProtocol::DrainIntervalMs.
+#include "serialcommandengine.h"
+#include "serialprotocol.h"
+#include "serialworker.h"
+#include "spscringbuffer.h"
+#include "uartsimulator.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QSerialPort>
+#include <QThread>
+#include <QTimer>
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+namespace {
+
+// Serial stack under test: an engine plus whatever moves its bytes.
+class Link
+{
+public:
+    virtual ~Link() = default;
+    SerialCommandEngine engine;
+};
+
+class DirectLink : public Link
+{
+public:
+    bool open(const QString &portName)
+    {
+        port.setPortName(portName);
+        port.setBaudRate(QSerialPort::Baud115200);
+        QObject::connect(&port, &QSerialPort::readyRead, &engine, [this]() { engine.feed(port.readAll()); });
+        QObject::connect(&engine, &SerialCommandEngine::writeRequested, &port, [this](const QByteArray &data) { port.write(data); });
+        return port.open(QIODevice::ReadWrite);
+    }
+
+    QSerialPort port;
+};
+
+class WorkerLink : public Link
+{
+public:
+    ~WorkerLink() override
+    {
+        QMetaObject::invokeMethod(worker, [this]() { worker->close(); }, Qt::BlockingQueuedConnection);
+        thread.quit();
+        thread.wait();
+    }
+
+    bool open(const QString &portName)
+    {
+        worker = new SerialWorker(&rx);
+        worker->moveToThread(&thread);
+        QObject::connect(&thread, &QThread::finished, worker, &QObject::deleteLater);
+        thread.start();
+        QObject::connect(&engine, &SerialCommandEngine::writeRequested, worker, &SerialWorker::write);
+        QObject::connect(&drainTimer, &QTimer::timeout, &engine, [this]() {
+            char chunk[4096];
+            std::size_t n;
+            while ((n = rx.read(chunk, sizeof(chunk))) > 0) {
+                engine.feed(QByteArrayView(chunk, qsizetype(n)));
+            }
+        });
+        drainTimer.start(SerialProtocol::DrainIntervalMs);
+        bool opened = false;
+        QMetaObject::invokeMethod(worker, [&]() { opened = worker->open(portName, nullptr); }, Qt::BlockingQueuedConnection);
+        return opened;
+    }
+
+    SpscRingBuffer rx { 1 << 20 };
+    QThread thread;
+    SerialWorker *worker = nullptr;
+    QTimer drainTimer;
+};
+
+double percentile(std::vector<double> samples, double p)
+{
+    std::sort(samples.begin(), samples.end());
+    return samples[std::min(samples.size() - 1, size_t(p * (samples.size() - 1) + 0.5))];
+}
+
+void measureLatency(Link &link, int iterations)
+{
+    link.engine.setMaxInFlight(1);
+    std::vector<double> samples;
+    int failures = 0;
+    for (int i = 0; i < iterations; ++i) {
+        QEventLoop loop;
+        QElapsedTimer timer;
+        timer.start();
+        link.engine.submit("errlog 0", [&](const SerialCommandEngine::Response &response) {
+            if (response.answered()) {
+                samples.push_back(timer.nsecsElapsed() / 1e3);
+            } else {
+                ++failures;
+            }
+            loop.quit();
+        });
+        loop.exec();
+    }
+    if (samples.empty()) {
+        std::printf("  round trip: no replies (%d failures)\n", failures);
+        return;
+    }
+    std::printf("  round trip  min %8.0f us  median %8.0f us  p99 %8.0f us  (%d failures)\n",
+                percentile(samples, 0), percentile(samples, 0.5), percentile(samples, 0.99), failures);
+}
+
+void measureThroughput(Link &link, int depth, int rounds)
+{
+    link.engine.setMaxInFlight(depth);
+    QEventLoop loop;
+    int remaining = rounds * 11;
+    int failures = 0;
+    QElapsedTimer timer;
+    timer.start();
+    for (int r = 0; r < rounds; ++r) {
+        for (int slot = 0; slot <= 10; ++slot) {
+            link.engine.submit(QString("errlog %1").arg(slot), [&](const SerialCommandEngine::Response &response) {
+                failures += response.answered() ? 0 : 1;
+                if (--remaining == 0) {
+                    loop.quit();
+                }
+            });
+        }
+    }
+    loop.exec();
+    const double ms = timer.nsecsElapsed() / 1e6;
+    std::printf("  errlog 0..10 depth %2d  %8.1f ms per console  %8.1f commands/s  (%d failures)\n",
+                depth, ms / rounds, rounds * 11 / (ms / 1000.0), failures);
+}
+
+template <typename L>
+void runLink(const char *name, const QString &portName, int iterations, int rounds)
+{
+    L link;
+    if (!link.open(portName)) {
+        std::printf("%s: could not open %s\n", name, qPrintable(portName));
+        return;
+    }
+    std::printf("%s\n", name);
+    measureLatency(link, iterations);
+    for (int depth : { 1, 2, 4, 8, 11 }) {
+        measureThroughput(link, depth, rounds);
+    }
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption delayOption("byte-delay-us", "Simulated delay per byte (87 ~ 115200 baud).", "us", "87");
+    QCommandLineOption jitterOption("jitter-us", "Random extra delay per byte.", "us", "5");
+    QCommandLineOption iterationsOption("iterations", "Round trips for the latency test.", "n", "200");
+    QCommandLineOption roundsOption("rounds", "Full errlog reads per throughput test.", "n", "5");
+    parser.addOptions({ delayOption, jitterOption, iterationsOption, roundsOption });
+    parser.process(app);
+
+    UartSimulator::Options options;
+    options.byteDelayUs = parser.value(delayOption).toInt();
+    options.jitterUs = parser.value(jitterOption).toInt();
+    UartSimulator simulator(options);
+    QString error;
+    if (!simulator.start(&error)) {
+        std::fprintf(stderr, "serial_bench: %s\n", qPrintable(error));
+        return 1;
+    }
+    std::printf("Simulator on %s, %d us/byte + up to %d us jitter\n",
+                qPrintable(simulator.portName()), options.byteDelayUs, options.jitterUs);
+
+    const int iterations = parser.value(iterationsOption).toInt();
+    const int rounds = parser.value(roundsOption).toInt();
+    runLink<DirectLink>("direct", simulator.portName(), iterations, rounds);
+    runLink<WorkerLink>("worker", simulator.portName(), iterations, rounds);
+
+    std::printf("Simulator handled %llu commands, %llu checksum errors\n",
+                static_cast<unsigned long long>(simulator.commandsHandled()),
+                static_cast<unsigned long long>(simulator.checksumErrors()));
+    return simulator.checksumErrors() == 0 ? 0 : 1;
+}
@@ -0,0 +1,192 @@
+#include "batchprocessor.h"
+#include "errordatabaseindex.h"
+#include "norarchive.h"
+#include "norimage.h"
+#include "norpatch.h"
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+
+namespace {
+
+void processDump(BatchResult &result, const BatchOptions &options)
+{
+    const bool patching = !options.modifications.isEmpty();
+    NorImage image;
+    if (!image.open(result.filePath, patching ? NorImage::Mode::CopyOnWrite : NorImage::Mode::ReadOnly)) {
+        result.error = image.errorString();
+        return;
+    }
+
+    result.details = NorLayout::parse(image.view());
+    if (options.validate) {
+        result.issues = NorLayout::validate(result.details);
+    }
+    if (options.archive) {
+        // Archived as read, before any patch touches the copy-on-write mapping
+        NorArchive::IngestResult ingested;
+        QString error;
+        if (!options.archive->ingest(image.view(), QFileInfo(result.filePath).fileName(), &ingested, &error)) {
+            result.error = "Could not archive: " + error;
+            return;
+        }
+        result.archiveId = ingested.id;
+        result.archiveNewBytes = ingested.newBytes;
+    }
+    if (!patching) {
+        return;
+    }
+
+    const QString destination = QDir(options.outputDirectory).filePath(QFileInfo(result.filePath).fileName());
+    if (QFileInfo(destination).canonicalFilePath() == QFileInfo(result.filePath).canonicalFilePath()) {
+        result.error = "Refusing to patch a dump in place; choose another --out-dir";
+        return;
+    }
+    QList<NorPatch::Range> dirtyRanges;
+    QString error;
+    if (!NorPatch::applyModifications(image.data(), image.size(), options.modifications, &dirtyRanges, &error)
+        || !NorPatch::writePatchedCopy(result.filePath, destination, image, dirtyRanges, &error)) {
+        result.error = error;
+        return;
+    }
+    result.patchedPath = destination;
+    for (const NorPatch::Range &range : dirtyRanges) {
+        result.bytesPatched += range.length;
+    }
+}
+
+void processErrorLog(BatchResult &result, const BatchOptions &options)
+{
+    QFile file(result.filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        result.error = file.errorString();
+        return;
+    }
+    result.errorLog = ErrorLogModel::parse(QString::fromUtf8(file.readAll()));
+    ErrorLogModel::resolve(result.errorLog, [&options](const QString &code, QString *description) {
+        return options.errorIndex && options.errorIndex->lookup(code, description);
+    });
+}
+
+QString csvField(const QString &value)
+{
+    if (!value.contains(QLatin1Char(',')) && !value.contains(QLatin1Char('"')) && !value.contains(QLatin1Char('\n'))) {
+        return value;
+    }
+    QString quoted = value;
+    quoted.replace("\"", "\"\"");
+    return '"' + quoted + '"';
+}
+
+QString text(const NorLayout::FieldText &field)
+{
+    return field.present ? QString(field.view()) : QString();
+}
+
+} // namespace
+
+BatchResult::Kind kindForPath(const QString &filePath)
+{
+    const QString suffix = QFileInfo(filePath).suffix().toLower();
+    return suffix == QLatin1String("txt") || suffix == QLatin1String("log") ? BatchResult::Kind::ErrorLog
+                                                                            : BatchResult::Kind::NorDump;
+}
+
+BatchResult processFile(const QString &filePath, const BatchOptions &options)
+{
+    QElapsedTimer timer;
+    timer.start();
+    BatchResult result;
+    result.filePath = filePath;
+    result.kind = kindForPath(filePath);
+    if (result.kind == BatchResult::Kind::ErrorLog) {
+        processErrorLog(result, options);
+    } else {
+        processDump(result, options);
+    }
+    result.elapsedUs = timer.nsecsElapsed() / 1000;
+    return result;
+}
+
+QJsonObject toJson(const BatchResult &result)
+{
+    QJsonObject object;
+    object["file"] = result.filePath;
+    object["elapsedUs"] = result.elapsedUs;
+    if (!result.ok()) {
+        object["error"] = result.error;
+    }
+
+    if (result.kind == BatchResult::Kind::ErrorLog) {
+        object["type"] = "errlog";
+        QJsonArray entries;
+        for (const ErrorLogEntry &entry : result.errorLog) {
+            QJsonObject e;
+            e["slot"] = entry.slot;
+            e["code"] = entry.code;
+            e["rtc"] = entry.rtc;
+            e["fields"] = entry.fields;
+            e["description"] = entry.known ? QJsonValue(entry.description) : QJsonValue();
+            entries.append(e);
+        }
+        object["errors"] = entries;
+        return object;
+    }
+
+    object["type"] = "nor";
+    if (result.details.imageSize > 0) {
+        const NorLayout::NorDetails &d = result.details;
+        object["size"] = d.imageSize;
+        object["edition"] = NorLayout::editionName(d.edition);
+        object["backupEdition"] = NorLayout::editionName(d.backupEdition);
+        object["moboSerial"] = text(d.moboSerial);
+        object["boardSerial"] = text(d.boardSerial);
+        object["variant"] = text(d.variant);
+        object["region"] = NorLayout::regionForVariant(d.variant.view());
+        object["wifiMac"] = text(d.wifiMac);
+        object["lanMac"] = text(d.lanMac);
+        object["issues"] = QJsonArray::fromStringList(result.issues);
+    }
+    if (!result.archiveId.isEmpty()) {
+        object["archiveId"] = result.archiveId;
+        object["archiveNewBytes"] = result.archiveNewBytes;
+    }
+    if (!result.patchedPath.isEmpty()) {
+        object["patchedPath"] = result.patchedPath;
+        object["bytesPatched"] = result.bytesPatched;
+    }
+    return object;
+}
+
+void writeCsv(QTextStream &out, const QList<BatchResult> &results)
+{
+    out << "file,type,error,size,edition,backupEdition,moboSerial,boardSerial,variant,region,wifiMac,lanMac,"
+           "issues,patchedPath,bytesPatched,slot,code,rtc,description\n";
+    for (const BatchResult &result : results) {
+        const QString file = csvField(result.filePath);
+        if (result.kind == BatchResult::Kind::ErrorLog) {
+            if (!result.ok() || result.errorLog.isEmpty()) {
+                out << file << ",errlog," << csvField(result.error) << ",,,,,,,,,,,,,,,,\n";
+            }
+            for (const ErrorLogEntry &entry : result.errorLog) {
+                out << file << ",errlog,,,,,,,,,,,,,," << entry.slot << ',' << entry.code << ','
+                    << entry.rtc << ',' << csvField(entry.known ? entry.description : QString()) << '\n';
+            }
+            continue;
+        }
+        const NorLayout::NorDetails &d = result.details;
+        const bool parsed = d.imageSize > 0;
+        out << file << ",nor," << csvField(result.error) << ','
+            << (parsed ? QString::number(d.imageSize) : QString()) << ','
+            << (parsed ? NorLayout::editionName(d.edition) : "") << ','
+            << (parsed ? NorLayout::editionName(d.backupEdition) : "") << ','
+            << csvField(text(d.moboSerial)) << ',' << csvField(text(d.boardSerial)) << ','
+            << csvField(text(d.variant)) << ','
+            << csvField(parsed ? QString::fromLatin1(NorLayout::regionForVariant(d.variant.view())) : QString()) << ','
+            << text(d.wifiMac) << ',' << text(d.lanMac) << ','
+            << csvField(result.issues.join("; ")) << ',' << csvField(result.patchedPath) << ','
+            << (result.patchedPath.isEmpty() ? QString() : QString::number(result.bytesPatched)) << ",,,,\n";
+    }
+}
@@ -0,0 +1,54 @@
+#ifndef BATCHPROCESSOR_H
+#define BATCHPROCESSOR_H
+
+#include "errorlogmodel.h"
+#include "norlayout.h"
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QTextStream>
+#include <QVariantMap>
+
+class ErrorDatabaseIndex;
+class NorArchive;
+
+// What ps5nor-cli does with each input file. processFile() is self-contained and
+// only reads shared state, so any number of files can be processed concurrently.
+struct BatchOptions {
+    bool validate = true;
+    QVariantMap modifications;        // Same keys as the GUI's saveModifiedFile(); empty = read only
+    QString outputDirectory;          // Where patched copies are written
+    const ErrorDatabaseIndex *errorIndex = nullptr; // Resolves codes in UART logs, may be null
+    const NorArchive *archive = nullptr; // Dumps are also stored here when set
+};
+
+struct BatchResult {
+    enum class Kind {
+        NorDump,
+        ErrorLog // UART capture (.txt / .log) with errlog responses
+    };
+
+    QString filePath;
+    Kind kind = Kind::NorDump;
+    QString error;                 // Set when the file could not be processed at all
+    NorLayout::NorDetails details;
+    QStringList issues;            // NorLayout::validate() findings
+    QString patchedPath;
+    qint64 bytesPatched = 0;
+    QString archiveId;             // Set once the dump is in BatchOptions::archive
+    qint64 archiveNewBytes = 0;    // Chunk bytes the archive did not have yet
+    QList<ErrorLogEntry> errorLog;
+    qint64 elapsedUs = 0;
+
+    bool ok() const { return error.isEmpty(); }
+};
+
+BatchResult::Kind kindForPath(const QString &filePath);
+BatchResult processFile(const QString &filePath, const BatchOptions &options);
+
+QJsonObject toJson(const BatchResult &result);
+// One row per dump and one per decoded error log entry, with a shared header.
+void writeCsv(QTextStream &out, const QList<BatchResult> &results);
+
+#endif // BATCHPROCESSOR_H
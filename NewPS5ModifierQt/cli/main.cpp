@@ -0,0 +1,216 @@
+// Headless batch front end for the NOR and error-code core: parses, validates and
+// optionally patches whole directories of dumps on every core, and decodes UART
+// error log captures against the offline database. Results go out as JSON or CSV.
+#include "apppaths.h"
+#include "batchprocessor.h"
+#include "errordatabaseindex.h"
+#include "norarchive.h"
+#include "workstealingpool.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QTextStream>
+#include <QThread>
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+
+namespace {
+
+QStringList collectInputs(const QStringList &arguments, const QStringList &nameFilters)
+{
+    QStringList files;
+    for (const QString &argument : arguments) {
+        const QFileInfo info(argument);
+        if (info.isDir()) {
+            QDirIterator it(argument, nameFilters, QDir::Files, QDirIterator::Subdirectories);
+            QStringList found;
+            while (it.hasNext()) {
+                found << it.next();
+            }
+            found.sort(); // Stable output order regardless of directory listing order
+            files << found;
+        } else {
+            files << argument;
+        }
+    }
+    return files;
+}
+
+bool parseModifications(const QStringList &assignments, QVariantMap &modifications, QString *errorString)
+{
+    for (const QString &assignment : assignments) {
+        const qsizetype equals = assignment.indexOf('=');
+        if (equals <= 0) {
+            *errorString = QString("Expected KEY=VALUE, got \"%1\"").arg(assignment);
+            return false;
+        }
+        modifications[assignment.left(equals)] = assignment.mid(equals + 1);
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("ps5nor-cli");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        "Batch processing of PS5 NOR dumps (*.bin) and UART error log captures (*.txt, *.log).\n"
+        "Exit status: 0 ok, 1 a file could not be processed, 2 validation found issues.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("inputs", "Files or directories (searched recursively).", "<path>...");
+    QCommandLineOption jobsOption({ "j", "jobs" }, "Worker threads (default: all cores).", "n",
+                                  QString::number(QThread::idealThreadCount()));
+    QCommandLineOption formatOption({ "f", "format" }, "Output format: json or csv.", "format", "json");
+    QCommandLineOption outputOption({ "o", "output" }, "Write results to a file instead of stdout.", "file");
+    QCommandLineOption noValidateOption("no-validate", "Skip the dump sanity checks.");
+    QCommandLineOption setOption("set",
+        "Patch a field, e.g. model=\"Digital Edition\", boardSerial=..., variant=..., wifiMac=..., lanMac=... "
+        "Repeatable; requires --out-dir.", "key=value");
+    QCommandLineOption outDirOption("out-dir", "Directory for patched copies.", "dir");
+    QCommandLineOption databaseOption("database", "errorDB.xml used to describe error codes.", "file", AppPaths::errorDatabaseFile()); // The GUI's copy
+    QCommandLineOption filterOption("filter", "Name filters used inside directories.", "globs", "*.bin,*.txt,*.log");
+    QCommandLineOption archiveOption("archive", "Also store every dump in this deduplicating archive.", "dir");
+    QCommandLineOption restoreOption("restore", "Restore archived dump ID to the file given as the only input.", "id");
+    parser.addOptions({ jobsOption, formatOption, outputOption, noValidateOption, setOption, outDirOption,
+                        databaseOption, filterOption, archiveOption, restoreOption });
+    parser.process(app);
+
+    const QString format = parser.value(formatOption).toLower();
+    if (format != "json" && format != "csv") {
+        std::fprintf(stderr, "ps5nor-cli: unknown format \"%s\"\n", qPrintable(format));
+        return 1;
+    }
+
+    BatchOptions options;
+    options.validate = !parser.isSet(noValidateOption);
+    QString error;
+    if (!parseModifications(parser.values(setOption), options.modifications, &error)) {
+        std::fprintf(stderr, "ps5nor-cli: %s\n", qPrintable(error));
+        return 1;
+    }
+    if (!options.modifications.isEmpty()) {
+        options.outputDirectory = parser.value(outDirOption);
+        if (options.outputDirectory.isEmpty() || !QDir().mkpath(options.outputDirectory)) {
+            std::fprintf(stderr, "ps5nor-cli: --set needs a writable --out-dir\n");
+            return 1;
+        }
+    }
+
+    std::unique_ptr<NorArchive> archive;
+    if (parser.isSet(archiveOption)) {
+        archive = std::make_unique<NorArchive>(parser.value(archiveOption));
+        options.archive = archive.get();
+    }
+    if (parser.isSet(restoreOption)) {
+        if (!archive || parser.positionalArguments().size() != 1) {
+            std::fprintf(stderr, "ps5nor-cli: --restore needs --archive and one output file\n");
+            return 1;
+        }
+        if (!archive->restoreToFile(parser.value(restoreOption), parser.positionalArguments().constFirst(), &error)) {
+            std::fprintf(stderr, "ps5nor-cli: %s\n", qPrintable(error));
+            return 1;
+        }
+        return 0;
+    }
+
+    const QStringList inputs = collectInputs(parser.positionalArguments(), parser.value(filterOption).split(',', Qt::SkipEmptyParts));
+    if (inputs.isEmpty()) {
+        parser.showHelp(1);
+    }
+
+    // Loaded once up front; lookups from the workers only read the mapping
+    ErrorDatabaseIndex errorIndex;
+    const bool needsDatabase = std::any_of(inputs.cbegin(), inputs.cend(), [](const QString &path) {
+        return kindForPath(path) == BatchResult::Kind::ErrorLog;
+    });
+    if (needsDatabase) {
+        const QString database = parser.value(databaseOption);
+        if (QFile::exists(database) && errorIndex.load(database, &error)) {
+            options.errorIndex = &errorIndex;
+        } else {
+            std::fprintf(stderr, "ps5nor-cli: error database %s unavailable, codes stay undescribed\n", qPrintable(database));
+        }
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    QList<BatchResult> results(inputs.size());
+    BatchResult *slots = results.data(); // Detached once here; each task owns one element
+    std::vector<WorkStealingPool::Task> tasks;
+    tasks.reserve(size_t(inputs.size()));
+    for (qsizetype i = 0; i < inputs.size(); ++i) {
+        tasks.push_back([&, slots, i]() { slots[i] = processFile(inputs.at(i), options); });
+    }
+    WorkStealingPool pool(parser.value(jobsOption).toInt());
+    pool.run(std::move(tasks));
+    const qint64 elapsedMs = timer.elapsed();
+
+    QFile output;
+    if (parser.isSet(outputOption)) {
+        output.setFileName(parser.value(outputOption));
+        if (!output.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+            std::fprintf(stderr, "ps5nor-cli: %s: %s\n", qPrintable(output.fileName()), qPrintable(output.errorString()));
+            return 1;
+        }
+    } else {
+        output.open(stdout, QIODevice::WriteOnly | QIODevice::Text);
+    }
+
+    int failed = 0;
+    int withIssues = 0;
+    int patched = 0;
+    qint64 archivedNewBytes = 0;
+    for (const BatchResult &result : results) {
+        failed += result.ok() ? 0 : 1;
+        withIssues += result.issues.isEmpty() ? 0 : 1;
+        patched += result.patchedPath.isEmpty() ? 0 : 1;
+        archivedNewBytes += result.archiveNewBytes;
+    }
+
+    if (format == "csv") {
+        QTextStream out(&output);
+        writeCsv(out, results);
+    } else {
+        QJsonArray files;
+        for (const BatchResult &result : results) {
+            files.append(toJson(result));
+        }
+        QJsonObject summary;
+        summary["files"] = int(results.size());
+        summary["failed"] = failed;
+        summary["withIssues"] = withIssues;
+        summary["patched"] = patched;
+        summary["threads"] = pool.threadCount();
+        summary["elapsedMs"] = elapsedMs;
+        if (archive) {
+            summary["archiveNewBytes"] = archivedNewBytes;
+        }
+        QJsonObject root;
+        root["files"] = files;
+        root["summary"] = summary;
+        output.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+    }
+    output.close();
+
+    std::fprintf(stderr, "ps5nor-cli: %lld files in %lld ms on %d threads, %d failed, %d with issues, %d patched\n",
+                 static_cast<long long>(results.size()), static_cast<long long>(elapsedMs), pool.threadCount(),
+                 failed, withIssues, patched);
+    if (archive) {
+        const NorArchive::Stats stats = archive->stats();
+        std::fprintf(stderr, "ps5nor-cli: archive %s: %d dumps, %lld new bytes, %lld MB stored for %lld MB of dumps\n",
+                     qPrintable(archive->rootPath()), stats.dumps, static_cast<long long>(archivedNewBytes),
+                     static_cast<long long>(stats.storedBytes >> 20), static_cast<long long>(stats.logicalBytes >> 20));
+    }
+    return failed > 0 ? 1 : (withIssues > 0 ? 2 : 0);
+}
@@ -0,0 +1,62 @@
+#include "workstealingpool.h"
+#include <algorithm>
+#include <thread>
+
+WorkStealingPool::WorkStealingPool(int threadCount) : m_threadCount(std::max(1, threadCount))
+{
+    for (int i = 0; i < m_threadCount; ++i) {
+        m_queues.push_back(std::make_unique<Queue>());
+    }
+}
+
+void WorkStealingPool::run(std::vector<Task> tasks)
+{
+    for (std::size_t i = 0; i < tasks.size(); ++i) {
+        m_queues[i % m_queues.size()]->tasks.push_back(std::move(tasks[i]));
+    }
+
+    // Tasks never spawn tasks, so a worker that finds every queue empty is done
+    std::vector<std::thread> threads;
+    for (int i = 1; i < m_threadCount; ++i) {
+        threads.emplace_back(&WorkStealingPool::work, this, i);
+    }
+    work(0);
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+}
+
+void WorkStealingPool::work(int self)
+{
+    Task task;
+    while (popLocal(self, task) || steal(self, task)) {
+        task();
+        task = nullptr;
+    }
+}
+
+bool WorkStealingPool::popLocal(int self, Task &task)
+{
+    Queue &queue = *m_queues[self];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) {
+        return false;
+    }
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return true;
+}
+
+bool WorkStealingPool::steal(int self, Task &task)
+{
+    for (int offset = 1; offset < m_threadCount; ++offset) {
+        Queue &victim = *m_queues[(self + offset) % m_threadCount];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
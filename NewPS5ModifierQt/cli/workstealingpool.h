@@ -0,0 +1,40 @@
+#ifndef WORKSTEALINGPOOL_H
+#define WORKSTEALINGPOOL_H
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Runs a batch of independent tasks on a fixed set of threads. Every worker owns a
+// deque: it takes work from the back of its own and, once that is empty, steals from
+// the front of a busy neighbour. Dumps differ a lot in cost (a 2 MB parse vs. a patch
+// with fsync), so an idle thread never waits while another still holds a backlog.
+class WorkStealingPool
+{
+public:
+    using Task = std::function<void()>;
+
+    explicit WorkStealingPool(int threadCount);
+
+    int threadCount() const { return m_threadCount; }
+
+    // Distributes tasks round-robin and blocks until every one of them has run.
+    void run(std::vector<Task> tasks);
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void work(int self);
+    bool popLocal(int self, Task &task);
+    bool steal(int self, Task &task);
+
+    int m_threadCount;
+    std::vector<std::unique_ptr<Queue>> m_queues;
+};
+
+#endif // WORKSTEALINGPOOL_H
@@ -108,8 +108,6 @@ ApplicationWindow {
         color: currentPalette.windowBackground
     }
 
-    // To store the hex content of the currently opened file
-    property string currentFileHexContent: ""
     property string currentFilePath: ""
     property int currentTabIndex: 0 // To track active tab
 
@@ -125,6 +123,16 @@ ApplicationWindow {
     // Property for offline/online error parsing choice
     property bool useOfflineErrorDb: true
 
+    function applyNorDetails(details) {
+        consoleModel = details.model || "Unknown"
+        motherboardSerial = details.moboSerial || "Unknown"
+        boardSerial = details.boardSerial || "Unknown"
+        wifiMac = details.wifiMac || "Unknown"
+        lanMac = details.lanMac || "Unknown"
+        boardVariant = details.variant || "Unknown"
+        fileSize = details.size || "0 bytes (0MB)"
+    }
+
     MessageDialog {
         id: errorDialog
         title: "Error"
@@ -147,10 +155,18 @@ ApplicationWindow {
         onAccepted: {
             console.log("File selected: " + openFileDialog.file)
             currentFilePath = openFileDialog.file
-            var hexContent = backend.openFile(openFileDialog.file)
+            backend.openFile(openFileDialog.file)
         }
     }
 
+    FileDialog {
+        id: compareFileDialog
+        title: "Compare With NOR Dump"
+        currentFolder: StandardPaths.writableLocation(StandardPaths.DocumentsLocation)
+        nameFilters: ["Binary files (*.bin)", "All files (*)"]
+        onAccepted: backend.compareWithFile(compareFileDialog.file)
+    }
+
     FileDialog {
         id: saveFileDialog
         title: "Save Modified NOR File"
@@ -158,13 +174,33 @@ ApplicationWindow {
         nameFilters: ["Binary files (*.bin)", "All files (*)"]
         onAccepted: {
             console.log("Save to file: " + saveFileDialog.file)
-            if (backend.saveFile(saveFileDialog.file, fileContentArea.text)) {
+            if (backend.saveCurrentFile(saveFileDialog.file)) {
                 infoDialog.text = "File saved successfully to " + saveFileDialog.file
                 infoDialog.open()
             }
         }
     }
 
+    FileDialog {
+        id: traceFileDialog
+        title: "Export Trace"
+        fileMode: FileDialog.SaveFile
+        currentFolder: StandardPaths.writableLocation(StandardPaths.DocumentsLocation)
+        nameFilters: ["Chrome trace (*.json)", "All files (*)"]
+        onAccepted: backend.exportTrace(traceFileDialog.selectedFile)
+    }
+
+    Shortcut {
+        sequences: [StandardKey.Undo]
+        enabled: backend && backend.canUndo
+        onActivated: backend.undoEdit()
+    }
+    Shortcut {
+        sequences: [StandardKey.Redo]
+        enabled: backend && backend.canRedo
+        onActivated: backend.redoEdit()
+    }
+
     Connections {
         target: backend
         function onErrorOccurred(title, message) {
@@ -186,30 +222,48 @@ ApplicationWindow {
                 }
             }
         }
-        function onFileOpened(fileName, fileContentHex, details) {
+        function onFileOpened(fileName, details) {
             if (!backend) return;
             currentFilePath = fileName
-            currentFileHexContent = fileContentHex
-            fileContentArea.text = fileContentHex
-            
-            consoleModel = details.model || "Unknown"
-            motherboardSerial = details.moboSerial || "Unknown"
-            boardSerial = details.boardSerial || "Unknown"
-            wifiMac = details.wifiMac || "Unknown"
-            lanMac = details.lanMac || "Unknown"
-            boardVariant = details.variant || "Unknown"
-            fileSize = details.size || "0 bytes (0MB)"
+            hexView.positionViewAtBeginning()
+            searchBar.hits = [] // Offsets belonged to the previous image
+            searchBar.current = -1
+            applyNorDetails(details)
             
             statusBarLabel.text = "Opened: " + fileName
             infoDialog.text = "File opened: " + fileName;
             infoDialog.open();
         }
+        function onOnlineErrorResultReady(result) {
+            errorResultArea.text = result // Replaces the "Fetching..." placeholder
+        }
+        function onNorDetailsChanged(details) {
+            applyNorDetails(details) // An edit in the hex view touched an identity field
+        }
         function onSerialPortConnectedChanged(connected) {
             // This function is called by backend, so backend is valid.
             // Bindings that read backend.isSerialPortConnected need guards for initial setup.
             // connectButton.text, icon.name, etc., will be updated by their direct bindings.
             statusBarLabel.text = connected && backend ? "Connected to " + backend.currentSerialPort : "Disconnected";
         }
+        function onSerialResponseReceived(command, response) {
+            serialOutputArea.append("<< " + response + "\n")
+        }
+        function onSerialOutputReceived(text) {
+            serialOutputArea.append(text) // Already batched per frame by the backend
+        }
+        function onAllErrorLogsData(data) {
+            serialOutputArea.append(data)
+        }
+        function onConsoleErrorLogsCleared(result) {
+            serialOutputArea.append("<< " + result + "\n")
+        }
+        function onArchiveChanged() {
+            archiveCombo.model = backend.archivedDumps()
+        }
+        function onUartCaptureSegmentsChanged() {
+            captureSegmentCombo.model = backend.uartCaptureSegments()
+        }
         function onAvailableSerialPortsChanged() {
             if (!backend) return; // Guard
             var currentPort = backend.currentSerialPort
@@ -284,11 +338,11 @@ ApplicationWindow {
         RowLayout {
             spacing: 2
             Repeater {
-                model: ["File Operations", "Error Database", "Serial (UART)"]
+                model: ["File Operations", "Error Database", "Serial (UART)", "Diagnostics"]
                 delegate: Button {
                     property int buttonIndex: index
                     text: modelData
-                    icon.name: ["document-open", "help-faq", "preferences-system"][buttonIndex]
+                    icon.name: ["document-open", "help-faq", "preferences-system", "utilities-system-monitor"][buttonIndex]
                     onClicked: currentTabIndex = buttonIndex
                     flat: currentTabIndex !== buttonIndex
                     highlighted: currentTabIndex === buttonIndex
@@ -341,16 +395,113 @@ ApplicationWindow {
                     StyledButton {
                         text: "Save .bin File"
                         icon.name: "document-save-symbolic"
-                        enabled: fileContentArea.text !== ""
+                        enabled: backend && backend.hexModel.byteCount > 0
                         onClicked: saveFileDialog.open()
                         Layout.preferredWidth: 160 // Adjusted width slightly
                         Layout.preferredHeight: 40 // Standardized height
                         buttonStyle: "secondary" // Apply "secondary" style
                         buttonStyles: root.buttonStyles // Pass the styles map
                     }
+                    StyledButton {
+                        text: "Undo"
+                        icon.name: "edit-undo"
+                        enabled: backend && backend.canUndo
+                        onClicked: backend.undoEdit()
+                        Layout.preferredHeight: 40 // Standardized height
+                        buttonStyle: "secondary"
+                        buttonStyles: root.buttonStyles
+                    }
+                    StyledButton {
+                        text: "Redo"
+                        icon.name: "edit-redo"
+                        enabled: backend && backend.canRedo
+                        onClicked: backend.redoEdit()
+                        Layout.preferredHeight: 40 // Standardized height
+                        buttonStyle: "secondary"
+                        buttonStyles: root.buttonStyles
+                    }
+                    StyledButton {
+                        text: "Compare With..."
+                        icon.name: "document-compare"
+                        enabled: backend && backend.hexModel.byteCount > 0
+                        onClicked: compareFileDialog.open()
+                        Layout.preferredWidth: 160
+                        Layout.preferredHeight: 40 // Standardized height
+                        buttonStyle: "secondary"
+                        buttonStyles: root.buttonStyles
+                    }
+                    StyledButton {
+                        text: "Clear Comparison"
+                        icon.name: "edit-clear"
+                        visible: backend && backend.diffModel.active
+                        onClicked: backend.clearComparison()
+                        Layout.preferredHeight: 40 // Standardized height
+                        buttonStyle: "secondary"
+                        buttonStyles: root.buttonStyles
+                    }
+                }
+                RowLayout {
+                    spacing: 10
+                    Layout.fillWidth: true
+                    ComboBox {
+                        id: archiveCombo
+                        Layout.fillWidth: true
+                        Layout.preferredHeight: 40 // Standardized height
+                        model: backend ? backend.archivedDumps() : []
+                        textRole: "label"
+                        displayText: count > 0 ? currentText : "No archived dumps"
+                        background: Rectangle {
+                            color: currentPalette.controlBackground
+                            border.color: parent.activeFocus ? currentPalette.controlFocusBorder : currentPalette.controlBorder
+                            border.width: 1
+                            radius: 4
+                        }
+                        contentItem: Label {
+                            text: parent.displayText
+                            color: currentPalette.text
+                            elide: Text.ElideRight
+                            verticalAlignment: Text.AlignVCenter
+                            leftPadding: 8
+                        }
+                    }
+                    StyledButton {
+                        text: "Open Archived"
+                        icon.name: "document-open-recent"
+                        enabled: archiveCombo.currentIndex >= 0
+                        onClicked: backend.openArchivedDump(archiveCombo.model[archiveCombo.currentIndex].id)
+                        Layout.preferredWidth: 160
+                        Layout.preferredHeight: 40 // Standardized height
+                        buttonStyle: "secondary"
+                        buttonStyles: root.buttonStyles
+                    }
+                }
+                CheckBox { // Identical chunks are stored once, so this costs little disk
+                    text: "Archive every dump opened or saved"
+                    checked: backend ? backend.archiveDumps : false
+                    onToggled: backend.archiveDumps = checked
+                    indicator: Rectangle {
+                        implicitWidth: 20
+                        implicitHeight: 20
+                        radius: 3
+                        border.color: parent.checked ? accentColor : currentPalette.controlBorder
+                        color: parent.checked ? accentColor : "transparent"
+                        Text {
+                            text: "✔"
+                            anchors.centerIn: parent
+                            font.pixelSize: 12
+                            color: parent.parent.checked ? accentColorTextOnLight : "transparent"
+                            visible: parent.parent.checked
+                        }
+                    }
+                    contentItem: Label {
+                        text: parent.text
+                        color: currentPalette.text
+                        leftPadding: parent.indicator.width + parent.spacing
+                        verticalAlignment: Text.AlignVCenter
+                    }
                 }
                 Label {
-                    text: "File Path: " + (currentFilePath ? currentFilePath : "No file opened")
+                    text: "File Path: " + (currentFilePath ? currentFilePath : "No file opened") + (backend && backend.imageModified ? "  (modified)" : "")
                     font.bold: true
                     color: currentPalette.text
                 }
@@ -383,27 +534,283 @@ ApplicationWindow {
                     color: currentPalette.text
                 }
                 
+                Label {
+                    text: "Comparison: " + (backend ? backend.diffModel.summary : "")
+                    visible: backend && backend.diffModel.active
+                    font.bold: true
+                    color: currentPalette.text
+                }
+                Rectangle {
+                    Layout.fillWidth: true
+                    Layout.preferredHeight: 160
+                    visible: backend && backend.diffModel.count > 0
+                    color: currentPalette.textAreaReadOnlyBackground
+                    border.color: currentPalette.controlBorder
+                    border.width: 1
+                    radius: 4
+                    clip: true
+
+                    ListView { // One row per differing region; clicking one scrolls the hex view there
+                        id: diffView
+                        anchors.fill: parent
+                        anchors.margins: 4
+                        model: backend ? backend.diffModel : null
+                        boundsBehavior: Flickable.StopAtBounds
+                        ScrollBar.vertical: ScrollBar {}
+
+                        delegate: RowLayout {
+                            width: ListView.view.width - 16
+                            spacing: 12
+                            TapHandler {
+                                onTapped: hexView.positionViewAtIndex(backend.hexModel.rowForOffset(model.offset), ListView.Beginning)
+                            }
+                            Label {
+                                text: model.offsetText
+                                font.family: "Monospace"
+                                font.pixelSize: 12
+                                color: currentPalette.secondaryText
+                                Layout.preferredWidth: 70
+                            }
+                            Label {
+                                text: model.length + " B"
+                                font.family: "Monospace"
+                                font.pixelSize: 12
+                                color: currentPalette.secondaryText
+                                Layout.preferredWidth: 70
+                            }
+                            Label {
+                                text: model.fields !== "" ? model.fields : (model.kind === "changed" ? "" : (model.kind === "onlyInA" ? "Only in this dump" : "Only in the other dump"))
+                                font.bold: model.fields !== ""
+                                color: currentPalette.text
+                                Layout.preferredWidth: 160
+                                elide: Text.ElideRight
+                            }
+                            Label {
+                                text: model.bytesA + "  |  " + model.bytesB
+                                font.family: "Monospace"
+                                font.pixelSize: 12
+                                color: currentPalette.text
+                                elide: Text.ElideRight
+                                Layout.fillWidth: true
+                            }
+                        }
+                    }
+                }
+                Label {
+                    text: "Region Map: " + (backend ? backend.regionMap.summary : "")
+                    visible: backend && backend.regionMap.count > 0
+                    font.bold: true
+                    color: currentPalette.text
+                }
+                Rectangle {
+                    Layout.fillWidth: true
+                    Layout.preferredHeight: 90
+                    visible: backend && backend.regionMap.count > 0
+                    color: currentPalette.textAreaReadOnlyBackground
+                    border.color: currentPalette.controlBorder
+                    border.width: 1
+                    radius: 4
+                    clip: true
+
+                    GridView { // One cell per 4 KiB block, filled in as the background analysis streams in
+                        id: regionMapView
+                        anchors.fill: parent
+                        anchors.margins: 4
+                        model: backend ? backend.regionMap : null
+                        cellWidth: 8
+                        cellHeight: 8
+                        boundsBehavior: Flickable.StopAtBounds
+                        ScrollBar.vertical: ScrollBar {}
+
+                        delegate: Rectangle {
+                            width: 7
+                            height: 7
+                            color: model.kind === "erased" ? "#D8D8D8"
+                                 : model.kind === "zeroed" ? "#202020"
+                                 : model.kind === "random" ? "#1565C0"
+                                 : model.kind === "data" ? Qt.rgba(0.2, 0.3 + model.entropy / 16, 0.2, 1)
+                                 : "transparent"
+                            border.color: model.kind === "pending" ? currentPalette.controlBorder : "transparent"
+                            border.width: 1
+                            ToolTip.visible: regionHover.hovered
+                            ToolTip.text: model.offsetText + "  " + model.kind + "  " + model.entropy.toFixed(2) + " bits/byte  CRC " + model.crc
+                            HoverHandler {
+                                id: regionHover
+                            }
+                            TapHandler {
+                                onTapped: hexView.positionViewAtIndex(backend.hexModel.rowForOffset(model.offset), ListView.Beginning)
+                            }
+                        }
+                    }
+                }
                 Label {
                     text: "File Content (Hex View):"
                     font.bold: true
                     color: currentPalette.text
                 }
-                TextArea {
-                    id: fileContentArea
+                RowLayout { // Byte search over the whole image; hits are stepped through in the hex view
+                    id: searchBar
+                    spacing: 10
+                    Layout.fillWidth: true
+                    enabled: backend && backend.hexModel.byteCount > 0
+                    property var hits: []
+                    property int current: -1
+
+                    function showHit(index) {
+                        if (hits.length === 0) {
+                            return
+                        }
+                        current = (index + hits.length) % hits.length
+                        hexView.positionViewAtIndex(backend.hexModel.rowForOffset(hits[current]), ListView.Center)
+                    }
+                    function find() {
+                        var result = backend.findInImage(searchField.text)
+                        hits = result.offsets ? result.offsets : []
+                        current = -1
+                        showHit(0)
+                    }
+
+                    TextField {
+                        id: searchField
+                        placeholderText: "Find hex bytes (22 02 01 01) or \"text\""
+                        Layout.fillWidth: true
+                        Layout.preferredHeight: 40 // Standardized height
+                        Keys.onReturnPressed: searchBar.find()
+                        onTextChanged: { searchBar.hits = []; searchBar.current = -1 }
+                        color: currentPalette.text
+                        placeholderTextColor: currentPalette.placeholderText
+                        background: Rectangle {
+                            color: currentPalette.controlBackground
+                            border.color: parent.activeFocus ? currentPalette.controlFocusBorder : currentPalette.controlBorder
+                            border.width: 1
+                            radius: 4
+                        }
+                    }
+                    StyledButton {
+                        text: "Find"
+                        icon.name: "edit-find"
+                        enabled: searchField.text.trim() !== ""
+                        onClicked: searchBar.find()
+                        Layout.preferredHeight: 40 // Standardized height
+                        buttonStyle: "primary"
+                        buttonStyles: root.buttonStyles
+                    }
+                    StyledButton {
+                        text: "<"
+                        enabled: searchBar.hits.length > 1
+                        onClicked: searchBar.showHit(searchBar.current - 1)
+                        Layout.preferredHeight: 40 // Standardized height
+                        buttonStyle: "secondary"
+                        buttonStyles: root.buttonStyles
+                    }
+                    Label {
+                        text: searchBar.hits.length > 0 ? (searchBar.current + 1) + " / " + searchBar.hits.length : "0 / 0"
+                        color: currentPalette.text
+                        Layout.preferredWidth: 80
+                        horizontalAlignment: Text.AlignHCenter
+                    }
+                    StyledButton {
+                        text: ">"
+                        enabled: searchBar.hits.length > 1
+                        onClicked: searchBar.showHit(searchBar.current + 1)
+                        Layout.preferredHeight: 40 // Standardized height
+                        buttonStyle: "secondary"
+                        buttonStyles: root.buttonStyles
+                    }
+                    TextField {
+                        id: replaceField
+                        placeholderText: "Replace with (same length)"
+                        Layout.preferredWidth: 220
+                        Layout.preferredHeight: 40 // Standardized height
+                        color: currentPalette.text
+                        placeholderTextColor: currentPalette.placeholderText
+                        background: Rectangle {
+                            color: currentPalette.controlBackground
+                            border.color: parent.activeFocus ? currentPalette.controlFocusBorder : currentPalette.controlBorder
+                            border.width: 1
+                            radius: 4
+                        }
+                    }
+                    StyledButton {
+                        text: "Replace All"
+                        icon.name: "edit-find-replace"
+                        enabled: searchField.text.trim() !== "" && replaceField.text.trim() !== ""
+                        onClicked: {
+                            if (backend.replaceInImage(searchField.text, replaceField.text) > 0) {
+                                searchBar.find()
+                            }
+                        }
+                        Layout.preferredHeight: 40 // Standardized height
+                        buttonStyle: "danger"
+                        buttonStyles: root.buttonStyles
+                    }
+                }
+                Rectangle {
                     Layout.fillWidth: true
                     Layout.fillHeight: true
-                    placeholderText: "Open a .bin file to see its content in hex format..."
-                    wrapMode: Text.WordWrap
-                    font.family: "Monospace"
-                    font.pixelSize: 12
-                    readOnly: false
-                    color: currentPalette.text
-                    placeholderTextColor: currentPalette.placeholderText
-                    background: Rectangle {
-                        color: currentPalette.textAreaBackground
-                        border.color: currentPalette.controlBorder
-                        border.width: 1
-                        radius: 4
+                    color: currentPalette.textAreaBackground
+                    border.color: currentPalette.controlBorder
+                    border.width: 1
+                    radius: 4
+                    clip: true
+
+                    Label {
+                        anchors.centerIn: parent
+                        visible: hexView.count === 0
+                        text: "Open a .bin file to see its content in hex format..."
+                        color: currentPalette.placeholderText
+                    }
+
+                    ListView { // Rows come from backend.hexModel and are only built while visible
+                        id: hexView
+                        anchors.fill: parent
+                        anchors.margins: 4
+                        model: backend ? backend.hexModel : null
+                        reuseItems: true
+                        boundsBehavior: Flickable.StopAtBounds
+                        ScrollBar.vertical: ScrollBar { policy: ScrollBar.AlwaysOn }
+
+                        delegate: RowLayout {
+                            width: ListView.view.width - 16
+                            height: 24
+                            spacing: 12
+                            Label {
+                                text: model.offset
+                                font.family: "Monospace"
+                                font.pixelSize: 12
+                                color: currentPalette.secondaryText
+                                Layout.preferredWidth: 70
+                            }
+                            TextField {
+                                id: hexRowField
+                                text: model.hex
+                                font.family: "Monospace"
+                                font.pixelSize: 12
+                                color: currentPalette.text
+                                padding: 2
+                                selectByMouse: true
+                                Layout.preferredWidth: 360
+                                Layout.fillHeight: true
+                                background: Rectangle {
+                                    color: hexRowField.activeFocus ? currentPalette.controlBackground : "transparent"
+                                    border.color: hexRowField.activeFocus ? currentPalette.controlFocusBorder : "transparent"
+                                    border.width: 1
+                                }
+                                onEditingFinished: {
+                                    if (text !== model.hex) {
+                                        model.hex = text // Invalid rows are rejected by the model
+                                        text = Qt.binding(function() { return model.hex })
+                                    }
+                                }
+                            }
+                            Label {
+                                text: model.ascii
+                                font.family: "Monospace"
+                                font.pixelSize: 12
+                                color: currentPalette.text
+                                Layout.fillWidth: true
+                            }
+                        }
                     }
                 }
             }
@@ -471,7 +878,7 @@ ApplicationWindow {
                         spacing: 5
                         TextField {
                             id: errorCodeInput
-                            placeholderText: "Enter Error Code (e.g., SU-101312-8)"
+                            placeholderText: "Enter Error Code (e.g., SU-101312-8), or several separated by spaces"
                             Layout.fillWidth: true
                             Layout.preferredHeight: 40 // Standardized height
                             Keys.onReturnPressed: parseErrorCodeButton.clicked()
@@ -612,6 +1019,91 @@ ApplicationWindow {
                         Layout.preferredHeight: 40 // Standardized height
                     }
                 }
+                CheckBox { // The port list itself follows hotplug events
+                    text: "Auto-connect USB UART adapters when plugged in"
+                    checked: backend ? backend.autoConnectSerial : false
+                    onToggled: backend.autoConnectSerial = checked
+                    indicator: Rectangle {
+                        implicitWidth: 20
+                        implicitHeight: 20
+                        radius: 3
+                        border.color: parent.checked ? accentColor : currentPalette.controlBorder
+                        color: parent.checked ? accentColor : "transparent"
+                        Text {
+                            text: "✔"
+                            anchors.centerIn: parent
+                            font.pixelSize: 12
+                            color: parent.parent.checked ? accentColorTextOnLight : "transparent"
+                            visible: parent.parent.checked
+                        }
+                    }
+                    contentItem: Label {
+                        text: parent.text
+                        color: currentPalette.text
+                        leftPadding: parent.indicator.width + parent.spacing
+                        verticalAlignment: Text.AlignVCenter
+                    }
+                }
+                CheckBox { // Segments are compressed in the background; the oldest go once 256 MiB is used
+                    text: "Capture all UART output to disk"
+                    checked: backend ? backend.captureUart : false
+                    onToggled: backend.captureUart = checked
+                    indicator: Rectangle {
+                        implicitWidth: 20
+                        implicitHeight: 20
+                        radius: 3
+                        border.color: parent.checked ? accentColor : currentPalette.controlBorder
+                        color: parent.checked ? accentColor : "transparent"
+                        Text {
+                            text: "✔"
+                            anchors.centerIn: parent
+                            font.pixelSize: 12
+                            color: parent.parent.checked ? accentColorTextOnLight : "transparent"
+                            visible: parent.parent.checked
+                        }
+                    }
+                    contentItem: Label {
+                        text: parent.text
+                        color: currentPalette.text
+                        leftPadding: parent.indicator.width + parent.spacing
+                        verticalAlignment: Text.AlignVCenter
+                    }
+                }
+                RowLayout {
+                    spacing: 10
+                    Layout.fillWidth: true
+                    ComboBox {
+                        id: captureSegmentCombo
+                        Layout.fillWidth: true
+                        Layout.preferredHeight: 40 // Standardized height
+                        model: backend ? backend.uartCaptureSegments() : []
+                        textRole: "label"
+                        displayText: count > 0 ? currentText : "No captured output"
+                        background: Rectangle {
+                            color: currentPalette.controlBackground
+                            border.color: parent.activeFocus ? currentPalette.controlFocusBorder : currentPalette.controlBorder
+                            border.width: 1
+                            radius: 4
+                        }
+                        contentItem: Label {
+                            text: parent.displayText
+                            color: currentPalette.text
+                            elide: Text.ElideRight
+                            verticalAlignment: Text.AlignVCenter
+                            leftPadding: 8
+                        }
+                    }
+                    StyledButton {
+                        text: "Show Capture"
+                        icon.name: "document-preview"
+                        enabled: captureSegmentCombo.currentIndex >= 0
+                        onClicked: serialOutputArea.text = backend.uartCaptureText(captureSegmentCombo.currentIndex) // One segment at a time
+                        Layout.preferredWidth: 160
+                        Layout.preferredHeight: 40 // Standardized height
+                        buttonStyle: "secondary"
+                        buttonStyles: root.buttonStyles
+                    }
+                }
                 RowLayout {
                     spacing: 10
                     StyledButton {
@@ -638,6 +1130,17 @@ ApplicationWindow {
                         Layout.preferredWidth: 220 // Example width adjustment
                         Layout.preferredHeight: 40 // Standardized height
                     }
+                    Label {
+                        text: "Pipeline:"
+                        color: currentPalette.text
+                    }
+                    SpinBox { // errlog commands in flight at once; 1 = strictly sequential
+                        from: 1
+                        to: 11
+                        value: backend ? backend.serialPipelineDepth : 1
+                        onValueModified: backend.serialPipelineDepth = value
+                        Layout.preferredHeight: 40 // Standardized height
+                    }
                 }
 
                 GroupBox {
@@ -680,9 +1183,8 @@ ApplicationWindow {
                             enabled: backend && backend.isSerialPortConnected && serialCommandInput.text.trim() !== ""
                             onClicked: {
                                 if (!backend) return;
-                                var response = backend.sendSerialCommand(serialCommandInput.text.trim())
                                 serialOutputArea.append(">> " + serialCommandInput.text.trim() + "\n")
-                                serialOutputArea.append("<< " + response + "\n")
+                                backend.sendSerialCommand(serialCommandInput.text.trim()) // Reply arrives via onSerialResponseReceived
                             }
                             buttonStyle: "primary"
                             buttonStyles: root.buttonStyles
@@ -691,6 +1193,151 @@ ApplicationWindow {
                         }
                     }
                 }
+                GroupBox {
+                    title: "Consoles (" + (backend ? backend.serialSessions.count : 0) + " open)"
+                    Layout.fillWidth: true
+                    background: Rectangle {
+                        color: currentPalette.cardBackground
+                        border.color: currentPalette.controlBorder
+                        border.width: 1
+                        radius: 4
+                    }
+                    label: Label {
+                        text: parent.title
+                        color: currentPalette.text
+                        padding: 5
+                        font.bold: true
+                    }
+                    ColumnLayout {
+                        anchors.fill: parent
+                        spacing: 5
+                        RowLayout {
+                            spacing: 10
+                            Layout.fillWidth: true
+                            ComboBox {
+                                id: sessionPortCombo
+                                Layout.fillWidth: true
+                                Layout.preferredHeight: 40 // Standardized height
+                                model: backend ? backend.availableSerialPorts : []
+                                displayText: count > 0 ? currentText : "No serial ports"
+                                background: Rectangle {
+                                    color: currentPalette.controlBackground
+                                    border.color: parent.activeFocus ? currentPalette.controlFocusBorder : currentPalette.controlBorder
+                                    border.width: 1
+                                    radius: 4
+                                }
+                                contentItem: Label {
+                                    text: parent.displayText
+                                    color: currentPalette.text
+                                    elide: Text.ElideRight
+                                    verticalAlignment: Text.AlignVCenter
+                                    leftPadding: 8
+                                }
+                            }
+                            StyledButton {
+                                text: "Open Session"
+                                icon.name: "list-add"
+                                enabled: sessionPortCombo.currentIndex >= 0
+                                onClicked: backend.openSerialSession(sessionPortCombo.currentText)
+                                buttonStyle: "success"
+                                buttonStyles: root.buttonStyles
+                                Layout.preferredWidth: 160
+                                Layout.preferredHeight: 40 // Standardized height
+                            }
+                            StyledButton {
+                                text: "Read Error Logs on All"
+                                icon.name: "format-list-bulleted"
+                                enabled: backend && backend.serialSessions.count > 0 && !backend.serialSessions.readingErrorLogs
+                                onClicked: backend.readErrorLogsOnAllSessions()
+                                buttonStyle: "info"
+                                buttonStyles: root.buttonStyles
+                                Layout.preferredWidth: 220
+                                Layout.preferredHeight: 40 // Standardized height
+                            }
+                        }
+                        RowLayout {
+                            spacing: 10
+                            Layout.fillWidth: true
+                            visible: backend && backend.serialSessions.count > 0
+                            TextField {
+                                id: sessionCommandInput
+                                placeholderText: "Command for every console"
+                                Layout.fillWidth: true
+                                Layout.preferredHeight: 40 // Standardized height
+                                Keys.onReturnPressed: sendToAllButton.clicked()
+                                color: currentPalette.text
+                                placeholderTextColor: currentPalette.placeholderText
+                                background: Rectangle {
+                                    color: currentPalette.controlBackground
+                                    border.color: parent.activeFocus ? currentPalette.controlFocusBorder : currentPalette.controlBorder
+                                    border.width: 1
+                                    radius: 4
+                                }
+                            }
+                            StyledButton {
+                                id: sendToAllButton
+                                text: "Send to All"
+                                icon.name: "document-send"
+                                enabled: sessionCommandInput.text.trim() !== ""
+                                onClicked: backend.sendCommandToAllSessions(sessionCommandInput.text.trim())
+                                buttonStyle: "primary"
+                                buttonStyles: root.buttonStyles
+                                Layout.preferredWidth: 160
+                                Layout.preferredHeight: 40 // Standardized height
+                            }
+                        }
+                        ListView { // One row per console; the log column shows its latest output
+                            id: sessionView
+                            Layout.fillWidth: true
+                            Layout.preferredHeight: Math.min(count, 8) * 44
+                            visible: count > 0
+                            clip: true
+                            model: backend ? backend.serialSessions : null
+                            boundsBehavior: Flickable.StopAtBounds
+                            ScrollBar.vertical: ScrollBar {}
+
+                            delegate: RowLayout {
+                                width: ListView.view.width - 16
+                                height: 44
+                                spacing: 12
+                                Label {
+                                    text: model.portName
+                                    font.family: "Monospace"
+                                    font.bold: true
+                                    color: model.connected ? currentPalette.text : currentPalette.placeholderText
+                                    Layout.preferredWidth: 140
+                                    elide: Text.ElideMiddle
+                                }
+                                Label {
+                                    text: model.status + (model.pending > 0 ? " (" + model.pending + " queued)" : "")
+                                    color: currentPalette.secondaryText
+                                    Layout.preferredWidth: 220
+                                    elide: Text.ElideRight
+                                }
+                                Label {
+                                    text: model.log.trim().split("\n").pop()
+                                    font.family: "Monospace"
+                                    font.pixelSize: 12
+                                    color: currentPalette.text
+                                    elide: Text.ElideRight
+                                    Layout.fillWidth: true
+                                    ToolTip.visible: logHover.hovered && model.log !== ""
+                                    ToolTip.text: model.log.slice(-2000)
+                                    HoverHandler { id: logHover }
+                                }
+                                StyledButton {
+                                    text: "Close"
+                                    icon.name: "window-close"
+                                    onClicked: backend.closeSerialSession(index)
+                                    buttonStyle: "secondary"
+                                    buttonStyles: root.buttonStyles
+                                    Layout.preferredWidth: 100
+                                    Layout.preferredHeight: 36
+                                }
+                            }
+                        }
+                    }
+                }
                 RowLayout {
                     Layout.fillWidth: true
                     Label {
@@ -698,6 +1345,16 @@ ApplicationWindow {
                         color: currentPalette.text
                         Layout.fillWidth: true
                     }
+                    StyledButton {
+                        text: "Decode Output"
+                        icon.name: "system-search"
+                        enabled: backend && serialOutputArea.text !== ""
+                        onClicked: backend.decodeErrorLog(serialOutputArea.text) // Fills backend.errorLogModel
+                        buttonStyle: "info"
+                        buttonStyles: root.buttonStyles
+                        Layout.preferredWidth: 160
+                        Layout.preferredHeight: 40 // Standardized height
+                    }
                     StyledButton {
                         text: "Clear Output"
                         icon.name: "edit-clear-all"
@@ -726,6 +1383,235 @@ ApplicationWindow {
                         radius: 4
                     }
                 }
+                Label {
+                    text: "Decoded Error Logs (" + errorLogView.count + "):"
+                    font.bold: true
+                    color: currentPalette.text
+                    visible: errorLogView.count > 0
+                }
+                Rectangle {
+                    Layout.fillWidth: true
+                    Layout.preferredHeight: 180
+                    visible: errorLogView.count > 0
+                    color: currentPalette.textAreaReadOnlyBackground
+                    border.color: currentPalette.controlBorder
+                    border.width: 1
+                    radius: 4
+                    clip: true
+
+                    ListView { // One row per logged error, resolved against the offline database
+                        id: errorLogView
+                        anchors.fill: parent
+                        anchors.margins: 4
+                        model: backend ? backend.errorLogModel : null
+                        boundsBehavior: Flickable.StopAtBounds
+                        ScrollBar.vertical: ScrollBar {}
+
+                        delegate: RowLayout {
+                            width: ListView.view.width - 16
+                            spacing: 12
+                            Label { // Only set for entries read through the multi-console sessions
+                                text: model.source
+                                visible: model.source !== ""
+                                font.family: "Monospace"
+                                font.pixelSize: 12
+                                color: currentPalette.secondaryText
+                            }
+                            Label {
+                                text: model.slot >= 0 ? "#" + model.slot : "-"
+                                font.family: "Monospace"
+                                font.pixelSize: 12
+                                color: currentPalette.secondaryText
+                                Layout.preferredWidth: 30
+                            }
+                            Label {
+                                text: model.code
+                                font.family: "Monospace"
+                                font.pixelSize: 12
+                                font.bold: true
+                                color: currentPalette.text
+                                Layout.preferredWidth: 80
+                            }
+                            Label {
+                                text: model.rtc
+                                font.family: "Monospace"
+                                font.pixelSize: 12
+                                color: currentPalette.secondaryText
+                                Layout.preferredWidth: 80
+                                ToolTip.visible: fieldsHover.hovered && model.fields !== ""
+                                ToolTip.text: model.fields
+                                HoverHandler { id: fieldsHover }
+                            }
+                            Label {
+                                text: model.description
+                                color: model.known ? currentPalette.text : currentPalette.placeholderText
+                                wrapMode: Text.WordWrap
+                                Layout.fillWidth: true
+                            }
+                        }
+                    }
+                }
+            }
+            ColumnLayout { // Tab 4: Diagnostics
+                id: diagnosticsTab
+                Layout.margins: 5
+                spacing: 10
+                property var statistics: ({ spans: [], events: 0, maxEvents: 0 })
+                function refresh() {
+                    if (backend) statistics = backend.traceStatistics()
+                }
+
+                Timer { // Histograms only change while tracing, and only matter while visible
+                    interval: 1000
+                    repeat: true
+                    running: currentTabIndex === 3 && backend && backend.tracingEnabled
+                    triggeredOnStart: true
+                    onTriggered: diagnosticsTab.refresh()
+                }
+
+                RowLayout {
+                    spacing: 10
+                    Layout.fillWidth: true
+                    CheckBox { // Off by default; a disabled span costs one atomic load
+                        text: "Record traces"
+                        checked: backend ? backend.tracingEnabled : false
+                        onToggled: backend.tracingEnabled = checked
+                        indicator: Rectangle {
+                            implicitWidth: 20
+                            implicitHeight: 20
+                            radius: 3
+                            border.color: parent.checked ? accentColor : currentPalette.controlBorder
+                            color: parent.checked ? accentColor : "transparent"
+                            Text {
+                                text: "✔"
+                                anchors.centerIn: parent
+                                font.pixelSize: 12
+                                color: parent.parent.checked ? accentColorTextOnLight : "transparent"
+                                visible: parent.parent.checked
+                            }
+                        }
+                        contentItem: Label {
+                            text: parent.text
+                            color: currentPalette.text
+                            leftPadding: parent.indicator.width + parent.spacing
+                            verticalAlignment: Text.AlignVCenter
+                        }
+                    }
+                    Label {
+                        text: diagnosticsTab.statistics.events + " of " + diagnosticsTab.statistics.maxEvents + " events kept"
+                        color: currentPalette.secondaryText
+                        Layout.fillWidth: true
+                    }
+                    StyledButton {
+                        text: "Refresh"
+                        icon.name: "view-refresh"
+                        onClicked: diagnosticsTab.refresh()
+                        buttonStyle: "secondary"
+                        buttonStyles: root.buttonStyles
+                        Layout.preferredWidth: 130
+                        Layout.preferredHeight: 40 // Standardized height
+                    }
+                    StyledButton {
+                        text: "Export Trace..."
+                        icon.name: "document-save-as"
+                        enabled: diagnosticsTab.statistics.events > 0
+                        onClicked: traceFileDialog.open()
+                        buttonStyle: "primary"
+                        buttonStyles: root.buttonStyles
+                        Layout.preferredWidth: 170
+                        Layout.preferredHeight: 40 // Standardized height
+                    }
+                    StyledButton {
+                        text: "Clear"
+                        icon.name: "edit-clear"
+                        onClicked: {
+                            backend.clearTrace()
+                            diagnosticsTab.refresh()
+                        }
+                        buttonStyle: "warning"
+                        buttonStyles: root.buttonStyles
+                        Layout.preferredWidth: 110
+                        Layout.preferredHeight: 40 // Standardized height
+                    }
+                }
+                Label {
+                    text: "Latency per operation (ms). The bars are a log2 histogram, from under 1 \u00b5s on the left."
+                    color: currentPalette.secondaryText
+                    wrapMode: Text.WordWrap
+                    Layout.fillWidth: true
+                }
+                Rectangle {
+                    Layout.fillWidth: true
+                    Layout.fillHeight: true
+                    color: currentPalette.textAreaReadOnlyBackground
+                    border.color: currentPalette.controlBorder
+                    border.width: 1
+                    radius: 4
+                    clip: true
+
+                    ListView {
+                        anchors.fill: parent
+                        anchors.margins: 4
+                        model: diagnosticsTab.statistics.spans
+                        boundsBehavior: Flickable.StopAtBounds
+                        ScrollBar.vertical: ScrollBar {}
+                        header: RowLayout {
+                            width: ListView.view.width - 16
+                            spacing: 12
+                            Repeater {
+                                model: ["Operation", "Count", "Mean", "p50", "p90", "p99", "Max"]
+                                delegate: Label {
+                                    text: modelData
+                                    font.bold: true
+                                    color: currentPalette.text
+                                    Layout.preferredWidth: index === 0 ? 180 : 70
+                                }
+                            }
+                            Item { Layout.fillWidth: true }
+                        }
+
+                        delegate: RowLayout {
+                            width: ListView.view.width - 16
+                            spacing: 12
+                            Label {
+                                text: modelData.name
+                                font.family: "Monospace"
+                                font.pixelSize: 12
+                                color: currentPalette.text
+                                elide: Text.ElideRight
+                                Layout.preferredWidth: 180
+                            }
+                            Repeater {
+                                model: [modelData.count, modelData.meanMs.toFixed(2), modelData.p50Ms.toFixed(2),
+                                        modelData.p90Ms.toFixed(2), modelData.p99Ms.toFixed(2), modelData.maxMs.toFixed(2)]
+                                delegate: Label {
+                                    text: modelData
+                                    font.family: "Monospace"
+                                    font.pixelSize: 12
+                                    color: currentPalette.text
+                                    Layout.preferredWidth: 70
+                                }
+                            }
+                            Row {
+                                id: bucketBars
+                                property var buckets: modelData.buckets
+                                property real peak: Math.max.apply(null, buckets)
+                                spacing: 1
+                                Layout.fillWidth: true
+                                Layout.preferredHeight: 24
+                                Repeater {
+                                    model: bucketBars.buckets
+                                    delegate: Rectangle {
+                                        width: 6
+                                        height: modelData > 0 ? Math.max(2, 24 * modelData / bucketBars.peak) : 0
+                                        anchors.bottom: parent.bottom
+                                        color: accentColor
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
             }
         }
     }
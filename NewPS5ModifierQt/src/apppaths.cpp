@@ -0,0 +1,22 @@
+#include "apppaths.h"
+#include <QCoreApplication>
+#include <QDir>
+#include <QStandardPaths>
+
+QString AppPaths::appDataDirectory(const QString &applicationName)
+{
+    // QStandardPaths only resolves AppDataLocation for the running application's name
+    const QString current = QCoreApplication::applicationName();
+    if (current == applicationName) {
+        return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    }
+    QCoreApplication::setApplicationName(applicationName);
+    const QString directory = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    QCoreApplication::setApplicationName(current);
+    return directory;
+}
+
+QString AppPaths::errorDatabaseFile(const QString &applicationName)
+{
+    return QDir(appDataDirectory(applicationName)).filePath("errorDB.xml");
+}
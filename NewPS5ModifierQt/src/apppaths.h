@@ -0,0 +1,20 @@
+#ifndef APPPATHS_H
+#define APPPATHS_H
+
+#include <QString>
+
+// Where the GUI keeps its data, for the GUI itself and for tools that reuse that data
+// (the CLI reads the same errorDB.xml). Locations are resolved through
+// QStandardPaths::AppDataLocation for the given application name, so every platform
+// gets the directory Qt would give that application (Roaming on Windows).
+namespace AppPaths {
+
+// Set by the GUI's main(); the default for the functions below
+inline const char GuiApplicationName[] = "PS5NorModifierApp";
+
+QString appDataDirectory(const QString &applicationName = QString::fromLatin1(GuiApplicationName));
+QString errorDatabaseFile(const QString &applicationName = QString::fromLatin1(GuiApplicationName));
+
+} // namespace AppPaths
+
+#endif // APPPATHS_H
@@ -1,29 +1,140 @@
 #include "backend.h"
+#include "apppaths.h"
+#include "hexcodec.h"
+#include "noranalysis.h"
+#include "norlayout.h"
+#include "norsearch.h"
+#include "serialprotocol.h"
+#include "serialworker.h"
+#include "tracer.h"
 #include <QStandardPaths>
 #include <QDir>
 #include <QDebug>
 #include <QXmlStreamReader>
 #include <QIODevice>
+#include <QFileInfo>
+#include <QSaveFile>
 #include <QTextStream> // For reading file content as hex
 #include <QRegularExpression> // For hex string manipulation
 #include <QUrlQuery> // Ensure this line is present and processed
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QThread>
+#include <QThreadPool>
+#include <QTimer>
+#include <memory>
+#include <QQmlEngine>
+
+namespace {
+
+// Text handed to QML; failures keep the "Error: ..." strings of the old blocking API
+QString serialResponseText(const SerialCommandEngine::Response &response)
+{
+    switch (response.status) {
+    case SerialCommandEngine::Status::Timeout:
+        return "Error: No response";
+    case SerialCommandEngine::Status::Cancelled:
+        return "Error: Cancelled";
+    default:
+        return response.text();
+    }
+}
+
+} // namespace
 
 Backend::Backend(QObject *parent) : QObject(parent)
 {
     m_networkManager = new QNetworkAccessManager(this);
-    QString appDataPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
-    QDir dir(appDataPath);
-    if (!dir.exists()) {
-        dir.mkpath(".");
-    }
-    m_localDatabaseFile = dir.filePath("errorDB.xml");
+    m_databaseDownloader = new DatabaseDownloader(m_networkManager, this);
+    connect(m_databaseDownloader, &DatabaseDownloader::finished, this, &Backend::onDatabaseDownloadFinished);
+    m_onlineErrorLookup = new OnlineErrorLookup(m_networkManager, this);
+    m_onlineErrorLookup->setUrl(DatabaseDownloader::defaultUrl());
+    connect(m_onlineErrorLookup, &OnlineErrorLookup::resultReady, this, &Backend::onOnlineErrorResultReady);
+    connect(m_onlineErrorLookup, &OnlineErrorLookup::batchFinished, this, &Backend::onOnlineErrorBatchFinished);
+    m_hexModel = new HexViewModel(this);
+    m_hexModel->setEditHistory(&m_editHistory);
+    connect(m_hexModel, &HexViewModel::bytesAboutToBeEdited, this, &Backend::pauseRegionAnalysis);
+    connect(m_hexModel, &HexViewModel::bytesEdited, this, &Backend::onImageBytesEdited);
+    m_errorLogModel = new ErrorLogModel(this);
+    m_diffModel = new DiffModel(this);
+    m_regionMap = new RegionMapModel(this);
+    m_regionAnalyzer = new RegionAnalyzer(this);
+    connect(m_regionAnalyzer, &RegionAnalyzer::blocksReady, m_regionMap, &RegionMapModel::setBlocks);
+    connect(m_regionAnalyzer, &RegionAnalyzer::finished, m_regionMap, &RegionMapModel::setElapsedMs);
+    m_archivePool = new QThreadPool(this);
+    m_archivePool->setMaxThreadCount(2);
+    // Only the path is needed up front; the directory is created when the database is
+    // first downloaded and the index is mapped on first lookup
+    m_localDatabaseFile = AppPaths::errorDatabaseFile();
     qDebug() << "Local database will be stored at:" << m_localDatabaseFile;
+    m_archive = std::make_unique<NorArchive>(QDir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)).filePath("archive"));
+    if (qEnvironmentVariableIsSet("PS5NOR_TRACE")) {
+        Tracer::setEnabled(true); // Covers startup too, before the diagnostics panel can
+    }
+    m_onlineErrorLookup->setCachePath(QDir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)).filePath("onlineErrorCache.json"));
+
+    // The port lives on its own thread; received bytes come back through m_serialRx
+    m_serialThread = new QThread(this);
+    m_serialThread->setObjectName("SerialIO");
+    m_serialWorker = new SerialWorker(&m_serialRx, &m_serialRxStamps);
+    m_serialWorker->moveToThread(m_serialThread);
+    connect(m_serialThread, &QThread::finished, m_serialWorker, &QObject::deleteLater);
+    connect(m_serialWorker, &SerialWorker::errorOccurred, this, &Backend::handleSerialError);
+    connect(m_serialWorker, &SerialWorker::closedUnexpectedly, this, &Backend::handleSerialPortLost);
 
-    m_serialPort = new QSerialPort(this);
-    connect(m_serialPort, &QSerialPort::errorOccurred, this, &Backend::handleSerialError);
-    connect(m_serialPort, &QSerialPort::readyRead, this, &Backend::handleSerialDataReady);
+    // Port enumeration walks sysfs/udev, so it happens on the serial thread, after startup
+    qRegisterMetaType<QList<SerialPortDescription>>();
+    m_portWatcher = new SerialPortWatcher;
+    m_portWatcher->moveToThread(m_serialThread);
+    connect(m_serialThread, &QThread::finished, m_portWatcher, &QObject::deleteLater);
+    connect(m_portWatcher, &SerialPortWatcher::portsChanged, this, &Backend::onSerialPortsChanged);
+    m_serialThread->start();
+    QMetaObject::invokeMethod(m_portWatcher, &SerialPortWatcher::start, Qt::QueuedConnection);
 
-    updateAvailableSerialPorts(); // Initial population
+    m_serialDrainTimer = new QTimer(this);
+    m_serialDrainTimer->setInterval(SerialProtocol::DrainIntervalMs);
+    connect(m_serialDrainTimer, &QTimer::timeout, this, &Backend::drainSerialInput);
+
+    m_uartCapture = new UartCapture(this);
+    connect(m_uartCapture, &UartCapture::segmentWritten, this, &Backend::uartCaptureSegmentsChanged);
+    connect(m_uartCapture, &UartCapture::errorOccurred, this, [this](const QString &message) {
+        setStatusMessage("Error: " + message);
+        emit errorOccurred("UART Capture Error", message);
+    });
+
+    m_serialEngine = new SerialCommandEngine(this);
+    connect(m_serialEngine, &SerialCommandEngine::writeRequested, m_serialWorker, &SerialWorker::write); // Queued
+    connect(m_serialEngine, &SerialCommandEngine::unsolicitedLine, this, [this](const QString &line) {
+        m_pendingSerialOutput.append(line); // Flushed once per drain tick
+    });
+    m_serialEngine->setMaxInFlight(DefaultSerialPipelineDepth);
+
+    m_serialSessions = new SerialSessionModel(this);
+    m_serialSessions->setMaxInFlight(DefaultSerialPipelineDepth);
+    connect(m_serialSessions, &SerialSessionModel::errorLogEntriesRead, this, [this](QList<ErrorLogEntry> entries) {
+        resolveErrorLogEntries(entries);
+        m_errorLogModel->appendEntries(entries);
+    });
+    connect(m_serialSessions, &SerialSessionModel::allErrorLogsFinished, this,
+            [this](int sessions, int codes, bool anErrorOccurred, qint64 elapsedMs) {
+        setStatusMessage(QString("Read the error logs of %1 consoles in %2 ms (%3 codes)%4.")
+                             .arg(sessions).arg(elapsedMs).arg(codes)
+                             .arg(anErrorOccurred ? ", some slots failed" : ""));
+    });
+    connect(m_serialSessions, &SerialSessionModel::errorOccurred, this, [this](const QString &portName, const QString &message) {
+        setStatusMessage("Error: " + portName + ": " + message);
+        emit errorOccurred("Serial Session Error", portName + ": " + message);
+    });
+}
+
+Backend::~Backend()
+{
+    m_regionAnalyzer->cancel(); // Its workers read m_image, which goes away before the children
+    m_archivePool->waitForDone();
+    QMetaObject::invokeMethod(m_serialWorker, [this]() { m_serialWorker->close(); }, Qt::BlockingQueuedConnection);
+    m_uartCapture->stop(); // Writes the open segment
+    m_serialThread->quit();
+    m_serialThread->wait();
 }
 
 QString Backend::statusMessage() const
@@ -57,28 +168,152 @@ void Backend::setCurrentSerialPort(const QString &portName)
     }
 }
 
+int Backend::serialPipelineDepth() const
+{
+    return m_serialEngine->maxInFlight();
+}
+
+void Backend::setSerialPipelineDepth(int depth)
+{
+    depth = qBound(1, depth, 11);
+    if (depth != m_serialEngine->maxInFlight()) {
+        m_serialEngine->setMaxInFlight(depth);
+        m_serialSessions->setMaxInFlight(depth);
+        emit serialPipelineDepthChanged();
+    }
+}
+
 bool Backend::isSerialPortConnected() const
 {
-    return m_serialPort ? m_serialPort->isOpen() : false;
+    return m_serialConnected; // Cached; the port itself belongs to the serial thread
+}
+
+bool Backend::autoConnectSerial() const
+{
+    return m_autoConnectSerial;
+}
+
+void Backend::setAutoConnectSerial(bool enabled)
+{
+    if (m_autoConnectSerial != enabled) {
+        m_autoConnectSerial = enabled;
+        emit autoConnectSerialChanged();
+    }
+}
+
+void Backend::setCaptureUart(bool enabled)
+{
+    if (enabled == m_uartCapture->isActive()) {
+        return;
+    }
+    if (!enabled) {
+        m_uartCapture->stop();
+        setStatusMessage(QString("UART capture stopped, %1 bytes recorded").arg(m_uartCapture->bytesCaptured()));
+    } else {
+        // One directory per capture, named after its start time
+        const QString directory = QDir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation))
+                                      .filePath("captures/" + QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss"));
+        QString error;
+        if (!m_uartCapture->start(directory, &error)) {
+            setStatusMessage("Error: Could not start UART capture: " + error);
+            emit errorOccurred("UART Capture Error", "Could not start UART capture: " + error);
+            return;
+        }
+        m_uartCaptureDirectory = directory;
+        setStatusMessage("Capturing UART to " + QDir::toNativeSeparators(directory));
+    }
+    emit captureUartChanged();
+    emit uartCaptureSegmentsChanged();
+}
+
+QVariantList Backend::uartCaptureSegments() const
+{
+    QVariantList segments;
+    if (m_uartCaptureDirectory.isEmpty()) {
+        return segments;
+    }
+    const qint64 startedAt = UartCapture::startedAt(m_uartCaptureDirectory);
+    const auto label = [startedAt](qint64 firstNs, qint64 lastNs, qint64 rawBytes) {
+        return QString("%1 - %2  (%3 bytes)")
+            .arg(QDateTime::fromMSecsSinceEpoch(startedAt + firstNs / 1000000).toString("hh:mm:ss"),
+                 QDateTime::fromMSecsSinceEpoch(startedAt + lastNs / 1000000).toString("hh:mm:ss"))
+            .arg(rawBytes);
+    };
+    const QList<UartCapture::Segment> stored = UartCapture::readIndex(m_uartCaptureDirectory);
+    for (const UartCapture::Segment &segment : stored) {
+        QVariantMap entry;
+        entry["sequence"] = segment.sequence;
+        entry["rawBytes"] = segment.rawBytes;
+        entry["storedBytes"] = segment.storedBytes;
+        entry["label"] = label(segment.firstNs, segment.lastNs, segment.rawBytes);
+        segments.append(entry);
+    }
+    if (m_uartCapture->isActive()) {
+        QVariantMap entry;
+        entry["sequence"] = -1;
+        entry["label"] = "Current (not yet written)";
+        segments.append(entry);
+    }
+    return segments;
 }
 
-void Backend::updateAvailableSerialPorts()
+QString Backend::uartCaptureText(int index) const
 {
+    if (m_uartCaptureDirectory.isEmpty()) {
+        return QString();
+    }
+    const qint64 startedAt = UartCapture::startedAt(m_uartCaptureDirectory);
+    // Only the one segment is loaded, however long the capture is
+    const QList<UartCapture::Segment> stored = UartCapture::readIndex(m_uartCaptureDirectory);
+    if (index == stored.size() && m_uartCapture->isActive()) {
+        return UartCapture::formatText(m_uartCapture->openSegment(), startedAt);
+    }
+    if (index < 0 || index >= stored.size()) {
+        return QString();
+    }
+    QByteArray records;
+    QString error;
+    if (!UartCapture::readSegment(m_uartCaptureDirectory, stored.at(index), &records, &error)) {
+        return "Error: " + error;
+    }
+    return UartCapture::formatText(records, startedAt);
+}
+
+void Backend::onSerialPortsChanged(const QList<SerialPortDescription> &ports)
+{
+    const QStringList previous = m_availableSerialPorts;
     m_availableSerialPorts.clear();
-    const auto infos = QSerialPortInfo::availablePorts();
-    for (const QSerialPortInfo &info : infos) {
-        m_availableSerialPorts.append(info.portName());
+    for (const SerialPortDescription &port : ports) {
+        m_availableSerialPorts.append(port.name);
+    }
+    if (m_availableSerialPorts != previous) {
+        emit availableSerialPortsChanged();
+    }
+    if (m_refreshRequested) {
+        m_refreshRequested = false;
+        setStatusMessage("Serial ports refreshed.");
     }
-    emit availableSerialPortsChanged();
     if (!m_availableSerialPorts.isEmpty() && m_currentSerialPort.isEmpty()) {
         setCurrentSerialPort(m_availableSerialPorts.first());
     }
+
+    // A known USB-UART adapter was just plugged in
+    if (!m_autoConnectSerial || m_serialConnected) {
+        return;
+    }
+    for (const SerialPortDescription &port : ports) {
+        if (!previous.contains(port.name) && SerialPortWatcher::isKnownUartAdapter(port)) {
+            setCurrentSerialPort(port.name);
+            connectSerialPortByName(port.name);
+            return;
+        }
+    }
 }
 
 void Backend::refreshSerialPorts()
 {
-    updateAvailableSerialPorts();
-    setStatusMessage("Serial ports refreshed.");
+    m_refreshRequested = true; // Reported once the watcher answers
+    QMetaObject::invokeMethod(m_portWatcher, &SerialPortWatcher::rescan, Qt::QueuedConnection);
 }
 
 bool Backend::connectSerialPort()
@@ -92,38 +327,50 @@ bool Backend::connectSerialPort()
 
 bool Backend::connectSerialPortByName(const QString &portName)
 {
-    if (m_serialPort->isOpen()) {
-        if (m_serialPort->portName() == portName) {
+    if (m_serialConnected) {
+        if (m_connectedSerialPort == portName) {
             setStatusMessage("Already connected to " + portName);
             return true; // Already connected to this port
         }
-        m_serialPort->close(); // Close if open on a different port
+        closeSerialPort(); // Close if open on a different port
     }
 
-    m_serialPort->setPortName(portName);
-    m_serialPort->setBaudRate(QSerialPort::Baud115200); // Common baud rate
-    m_serialPort->setDataBits(QSerialPort::Data8);
-    m_serialPort->setParity(QSerialPort::NoParity);
-    m_serialPort->setStopBits(QSerialPort::OneStop);
-    m_serialPort->setFlowControl(QSerialPort::NoFlowControl);
+    // Opening is quick; waiting for it keeps the bool result for QML
+    bool opened = false;
+    QString error;
+    QMetaObject::invokeMethod(m_serialWorker, [&]() { opened = m_serialWorker->open(portName, &error); },
+                              Qt::BlockingQueuedConnection);
 
-    if (m_serialPort->open(QIODevice::ReadWrite)) {
+    if (opened) {
+        m_serialConnected = true;
+        m_connectedSerialPort = portName;
+        m_serialDrainTimer->start();
         setCurrentSerialPort(portName); // Update current port if different
         setStatusMessage("Connected to " + portName);
         emit serialPortConnectedChanged(true);
         return true;
     } else {
-        setStatusMessage("Error connecting to " + portName + ": " + m_serialPort->errorString());
-        emit errorOccurred("Serial Connection Failed", "Could not connect to " + portName + ": " + m_serialPort->errorString());
+        setStatusMessage("Error connecting to " + portName + ": " + error);
+        emit errorOccurred("Serial Connection Failed", "Could not connect to " + portName + ": " + error);
         emit serialPortConnectedChanged(false);
         return false;
     }
 }
 
+void Backend::closeSerialPort()
+{
+    QMetaObject::invokeMethod(m_serialWorker, [this]() { m_serialWorker->close(); }, Qt::BlockingQueuedConnection);
+    drainSerialInput(); // Whatever arrived before the close
+    m_serialDrainTimer->stop();
+    m_serialConnected = false;
+    m_connectedSerialPort.clear();
+    m_serialEngine->cancelAll();
+}
+
 void Backend::disconnectSerialPort()
 {
-    if (m_serialPort->isOpen()) {
-        m_serialPort->close();
+    if (m_serialConnected) {
+        closeSerialPort();
         setStatusMessage("Disconnected from serial port.");
         emit serialPortConnectedChanged(false);
     } else {
@@ -131,154 +378,120 @@ void Backend::disconnectSerialPort()
     }
 }
 
-QString Backend::sendSerialCommand(const QString &command)
+void Backend::sendSerialCommand(const QString &command)
 {
-    if (!m_serialPort->isOpen()) {
+    if (!m_serialConnected) {
         setStatusMessage("Serial port not connected.");
         emit errorOccurred("Serial Command Error", "Serial port is not connected.");
-        return "Error: Not connected";
-    }
-
-    int sum = 0;
-    for (QChar qc : command) {
-        sum += qc.unicode();
+        emit serialResponseReceived(command, "Error: Not connected");
+        return;
     }
-    QString checksum = QString::number(sum & 0xFF, 16).toUpper().rightJustified(2, '0');
-    QString commandWithChecksum = command + ":" + checksum;
 
-    qDebug() << "Sending serial command:" << commandWithChecksum;
-    m_serialPort->write(commandWithChecksum.toUtf8() + "\n"); // Assuming commands are newline terminated
-    
-    if (m_serialPort->waitForBytesWritten(1000)) {
-        if (m_serialPort->waitForReadyRead(3000)) { // Wait up to 3 seconds for a response
-            QByteArray responseData = m_serialPort->readAll();
-            while(m_serialPort->waitForReadyRead(100)){ // Keep reading if more data comes quickly
-                responseData += m_serialPort->readAll();
-            }
-            QString response = QString::fromUtf8(responseData).trimmed();
-            setStatusMessage("Command sent. Response: " + response);
-            qDebug() << "Serial response:" << response;
-            return response;
-        } else {
+    qDebug() << "Sending serial command:" << SerialProtocol::frame(command);
+    // Traced from the submit to the reply, queueing behind other commands included
+    const qint64 traceStartNs = Tracer::isEnabled() ? Tracer::now() : -1;
+    m_serialEngine->submit(command, [this, traceStartNs](const SerialCommandEngine::Response &response) {
+        if (traceStartNs >= 0) {
+            Tracer::instance().complete("sendSerialCommand", "serial", traceStartNs);
+        }
+        const QString text = serialResponseText(response);
+        if (response.status == SerialCommandEngine::Status::Timeout) {
             setStatusMessage("No response from serial device.");
-            emit errorOccurred("Serial Command Error", "No response from serial device for command: " + command);
-            return "Error: No response";
+            emit errorOccurred("Serial Command Error", "No response from serial device for command: " + response.command);
+        } else if (response.answered()) {
+            setStatusMessage("Command sent. Response: " + text);
         }
-    } else {
-        setStatusMessage("Timeout writing to serial port.");
-        emit errorOccurred("Serial Command Error", "Timeout writing to serial port for command: " + command);
-        return "Error: Write timeout";
-    }
+        qDebug() << "Serial response:" << text << "after" << response.elapsedMs << "ms";
+        emit serialResponseReceived(response.command, text);
+    });
 }
 
-void Backend::handleSerialError(QSerialPort::SerialPortError error)
+void Backend::handleSerialError(const QString &message)
 {
-    if (error != QSerialPort::NoError && error != QSerialPort::TimeoutError) { // TimeoutError might be frequent with waitForReadyRead
-        QString errorMsg = "Serial port error: " + m_serialPort->errorString();
-        setStatusMessage(errorMsg);
-        emit errorOccurred("Serial Port Error", errorMsg);
+    setStatusMessage(message);
+    emit errorOccurred("Serial Port Error", message);
+}
+
+void Backend::handleSerialPortLost()
+{
+    if (m_serialConnected) {
+        closeSerialPort();
+        emit serialPortConnectedChanged(false);
     }
 }
 
-void Backend::handleSerialDataReady()
+// Runs once per frame while connected: everything received since the last tick is framed
+// in one go and console chatter reaches QML as a single text block. Chunks come with the
+// time the serial thread read them, so a stalled GUI thread does not skew the capture.
+void Backend::drainSerialInput()
 {
-    // This slot is connected but sendSerialCommand uses blocking reads for now.
-    // For a fully async approach, data reading logic would go here,
-    // and sendSerialCommand would not block.
+    char chunk[4096];
+    SerialWorker::ReadStamp stamp;
+    while (m_serialRxStamps.read(reinterpret_cast<char *>(&stamp), sizeof(stamp)) == sizeof(stamp)) {
+        qint64 remaining = stamp.bytes;
+        std::size_t n;
+        while (remaining > 0 && (n = m_serialRx.read(chunk, std::size_t(qMin<qint64>(remaining, sizeof(chunk))))) > 0) {
+            m_uartCapture->append(QByteArrayView(chunk, qsizetype(n)), stamp.steadyNs);
+            m_serialEngine->feed(QByteArrayView(chunk, qsizetype(n)));
+            remaining -= qint64(n);
+        }
+    }
+    if (!m_pendingSerialOutput.isEmpty()) {
+        emit serialOutputReceived(m_pendingSerialOutput.join('\n'));
+        m_pendingSerialOutput.clear();
+    }
 }
 
 void Backend::downloadDatabaseAsync()
 {
-    QUrl url("http://uartcodes.com/xml.php"); // Same URL as in C#
-    QNetworkRequest request(url);
-    // request.setAttribute(QNetworkRequest::FollowRedirectsAttribute, true); // Allow redirects
-    // In Qt 6, redirects are followed by default. If specific handling is needed,
-    // it's done by checking the redirectionTarget attribute on the reply.
-    // For now, we assume default behavior is sufficient.
-
+    if (m_databaseDownloader->isRunning()) {
+        setStatusMessage("Database download already in progress...");
+        return;
+    }
     setStatusMessage("Downloading database...");
-    QNetworkReply *reply = m_networkManager->get(request);
-    connect(reply, &QNetworkReply::finished, this, [this, reply]() {
-        onDownloadFinished(reply);
-    });
+    m_databaseDownloader->start(DatabaseDownloader::defaultUrl(), m_localDatabaseFile);
 }
 
-void Backend::onDownloadFinished(QNetworkReply *reply)
-{
-    if (reply->error() == QNetworkReply::NoError) {
-        QByteArray data = reply->readAll();
-        QFile file(m_localDatabaseFile);
-        if (file.open(QIODevice::WriteOnly)) {
-            file.write(data);
-            file.close();
-            setStatusMessage("Offline database updated successfully.");
-            emit databaseDownloadFinished(true);
-        } else {
-            setStatusMessage("Error: Could not save database file: " + file.errorString());
-            emit errorOccurred("Database Save Error", "Could not save database file: " + file.errorString());
-            emit databaseDownloadFinished(false);
-        }
-    } else {
-        setStatusMessage("Error downloading database: " + reply->errorString());
-        emit errorOccurred("Download Error", "Error downloading database: " + reply->errorString());
+void Backend::onDatabaseDownloadFinished(const DatabaseDownloader::Result &result)
+{
+    switch (result.outcome) {
+    case DatabaseDownloader::Outcome::Updated:
+        // Index now rather than on the first lookup; a bad download surfaces there again
+        m_errorIndex.rebuild(m_localDatabaseFile);
+        setStatusMessage(QString("Offline database updated successfully (%1 KB).").arg(result.bytesReceived / 1024));
+        emit databaseDownloadFinished(true);
+        break;
+    case DatabaseDownloader::Outcome::Unchanged:
+        setStatusMessage("Offline database is already up to date.");
+        emit databaseDownloadFinished(true);
+        break;
+    case DatabaseDownloader::Outcome::Failed:
+        setStatusMessage("Error: " + result.errorString);
+        emit errorOccurred("Download Error", result.errorString);
         emit databaseDownloadFinished(false);
+        break;
     }
-    reply->deleteLater();
 }
 
 QString Backend::parseErrorsOffline(const QString &errorCode)
 {
+    TraceSpan span("parseErrorsOffline");
     if (!QFile::exists(m_localDatabaseFile)) {
         setStatusMessage("Error: Local database file not found.");
         emit errorOccurred("Database Error", "Local database (errorDB.xml) not found. Please download it first.");
         return "Error: Local database file not found.";
     }
 
-    QFile file(m_localDatabaseFile);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        setStatusMessage("Error: Could not open local database file: " + file.errorString());
-        emit errorOccurred("Database Error", "Could not open local database file: " + file.errorString());
-        return "Error: Could not open local database file.";
-    }
-
-    QXmlStreamReader xml(&file);
-    QString description = "Error code not found.";
-    bool found = false;
-
-    while (!xml.atEnd() && !xml.hasError()) {
-        QXmlStreamReader::TokenType token = xml.readNext();
-        if (token == QXmlStreamReader::StartElement) {
-            if (xml.name().toString() == "errorCode") { // Assuming <errorCode> tag from C#
-                QString currentErrorCode;
-                QString currentDescription;
-                while (!(xml.tokenType() == QXmlStreamReader::EndElement && xml.name().toString() == "errorCode")) {
-                    if (xml.tokenType() == QXmlStreamReader::StartElement) {
-                        if (xml.name().toString() == "ErrorCode") { // Tag from C#
-                            xml.readNext();
-                            currentErrorCode = xml.text().toString();
-                        } else if (xml.name().toString() == "Description") { // Tag from C#
-                            xml.readNext();
-                            currentDescription = xml.text().toString();
-                        }
-                    }
-                    xml.readNext();
-                }
-                if (currentErrorCode == errorCode) {
-                    description = currentDescription;
-                    found = true;
-                    break;
-                }
-            }
-        }
-    }
-    file.close();
-
-    if (xml.hasError()) {
-        setStatusMessage("Error parsing XML: " + xml.errorString());
-        emit errorOccurred("Database Error", "Error parsing local database XML: " + xml.errorString());
+    QString indexError;
+    if (!ensureErrorIndex(&indexError)) {
+        setStatusMessage("Error parsing XML: " + indexError);
+        emit errorOccurred("Database Error", "Error parsing local database XML: " + indexError);
         return "Error parsing XML.";
     }
 
+    QString description;
+    const bool found = m_errorIndex.lookup(errorCode, &description);
+
     if (found) {
         setStatusMessage("Error code " + errorCode + " found: " + description);
         return "Error code: " + errorCode + "\nDescription: " + description;
@@ -288,56 +501,503 @@ QString Backend::parseErrorsOffline(const QString &errorCode)
     }
 }
 
-// Helper function to parse NOR details (stubbed)
-QVariantMap Backend::parseNorDetails(const QByteArray &fileData) {
-    QVariantMap details;
-    // Placeholder values - actual parsing logic is complex and hardware-specific
-    // This logic would replicate the C# version's offset reading and string conversions.
-    details["model"] = "Unknown (Parsing not implemented)";
-    details["moboSerial"] = "Unknown (Parsing not implemented)";
-    details["boardSerial"] = "Unknown (Parsing not implemented)";
-    details["wifiMac"] = "Unknown (Parsing not implemented)";
-    details["lanMac"] = "Unknown (Parsing not implemented)";
-    details["variant"] = "Unknown (Parsing not implemented)";
-    details["size"] = QString("%1 bytes (%2MB)").arg(fileData.size()).arg(fileData.size() / 1024.0 / 1024.0, 0, 'f', 2);
+// Fills in descriptions; false when there is no offline database to resolve against
+bool Backend::resolveErrorLogEntries(QList<ErrorLogEntry> &entries)
+{
+    QString indexError;
+    const bool haveIndex = QFile::exists(m_localDatabaseFile) && ensureErrorIndex(&indexError);
+    ErrorLogModel::resolve(entries, [this, haveIndex](const QString &code, QString *description) {
+        if (haveIndex && m_errorIndex.lookup(code, description)) {
+            return true;
+        }
+        *description = haveIndex ? "Not found in local database." : "Local database not available.";
+        return false;
+    });
+    return haveIndex;
+}
+
+// Tokenizes a whole errlog dump and resolves every distinct code once against the offline index
+ErrorLogModel *Backend::decodeErrorLog(const QString &raw)
+{
+    QList<ErrorLogEntry> entries = ErrorLogModel::parse(raw);
+    const bool haveIndex = resolveErrorLogEntries(entries);
+
+    int known = 0;
+    for (const ErrorLogEntry &entry : entries) {
+        known += entry.known ? 1 : 0;
+    }
+    if (entries.isEmpty()) {
+        setStatusMessage("No error codes found in the log.");
+    } else if (!haveIndex) {
+        setStatusMessage(QString("Decoded %1 error codes; download the database to resolve them.").arg(entries.size()));
+    } else {
+        setStatusMessage(QString("Decoded %1 error codes, %2 found in local database.").arg(entries.size()).arg(known));
+    }
+
+    m_errorLogModel->setEntries(std::move(entries));
+    QQmlEngine::setObjectOwnership(m_errorLogModel, QQmlEngine::CppOwnership);
+    return m_errorLogModel;
+}
+
+// The index is mapped from its sidecar on first use and rebuilt whenever the XML changes
+bool Backend::ensureErrorIndex(QString *errorString)
+{
+    if (m_errorIndex.isLoaded() && m_errorIndex.xmlPath() == m_localDatabaseFile && m_errorIndex.isCurrent()) {
+        return true;
+    }
+    return m_errorIndex.load(m_localDatabaseFile, errorString);
+}
 
-    return details;
+// Every field is decoded in one forward walk over the mapped image (see norlayout.h)
+QVariantMap Backend::parseNorDetails(QByteArrayView fileData) {
+    TraceSpan span("parseNorDetails");
+    return NorLayout::toVariantMap(NorLayout::parse(fileData));
+}
+
+void Backend::onImageBytesEdited(qint64 offset, qint64 length)
+{
+    imageRangesChanged({ NorPatch::Range{ offset, length } });
 }
 
-QString Backend::openFile(const QString &filePath)
+// Everything that follows the image bytes, after a hex edit, a replace-all, an undo or a redo
+void Backend::imageRangesChanged(const QList<NorPatch::Range> &ranges)
+{
+    bool detailsTouched = false;
+    for (const NorPatch::Range &range : ranges) {
+        NorPatch::addRange(m_imageDirtyRanges, range.offset, range.length);
+        m_hexModel->refreshBytes(range.offset, range.length);
+        detailsTouched = detailsTouched || (range.offset < NorLayout::kSpanEnd && range.end() > NorLayout::kSpanBegin);
+    }
+    if (detailsTouched) {
+        emit norDetailsChanged(parseNorDetails(m_image.view()));
+    }
+    if (!ranges.isEmpty() && m_diffModel->isActive()) {
+        // Only the edited stretches are re-diffed, the list keeps its rows and scroll
+        // position and the edit's own status message stays up
+        bool updated = true;
+        for (const NorPatch::Range &range : ranges) {
+            if (!m_diffModel->updateRange(range.offset, range.length)) {
+                updated = false;
+                break;
+            }
+        }
+        if (!updated) { // Truncated list, which only a full compare keeps exact
+            m_diffModel->setResult(NorDiff::compare(m_image.view(), m_compareImage.view()), &m_image, &m_compareImage);
+        }
+    }
+    refreshRegions(ranges);
+    emit editHistoryChanged();
+}
+
+void Backend::startRegionAnalysis()
+{
+    m_regionAnalysisPaused = false;
+    m_regionMap->reset(NorAnalysis::blockCount(m_image.size()));
+    m_regionAnalyzer->start(m_image.view());
+}
+
+// The analyzer's workers read m_image, so a running pass is cancelled before anything
+// writes into it and started over afterwards
+void Backend::pauseRegionAnalysis()
+{
+    if (m_regionAnalyzer->isRunning()) {
+        m_regionAnalyzer->cancel();
+        m_regionAnalysisPaused = true;
+    }
+}
+
+void Backend::resumeRegionAnalysis()
+{
+    if (m_regionAnalysisPaused) {
+        m_regionAnalysisPaused = false;
+        startRegionAnalysis();
+    }
+}
+
+// Edited blocks are re-analyzed in place; a pass interrupted by the edit is restarted so
+// no batch computed before the edit can land afterwards
+void Backend::refreshRegions(const QList<NorPatch::Range> &ranges)
+{
+    if (m_regionAnalysisPaused) {
+        resumeRegionAnalysis();
+        return;
+    }
+    if (ranges.isEmpty()) {
+        return;
+    }
+    for (const NorPatch::Range &range : ranges) {
+        const qint64 first = range.offset / NorAnalysis::BlockSize;
+        const qint64 last = std::min(NorAnalysis::blockCount(m_image.size()), (range.end() + NorAnalysis::BlockSize - 1) / NorAnalysis::BlockSize);
+        if (first >= last || last > m_regionMap->count()) {
+            continue;
+        }
+        QList<NorAnalysis::BlockStats> blocks(last - first);
+        NorAnalysis::analyzeBlocks(m_image.view(), first, last - first, blocks.data());
+        m_regionMap->setBlocks(first, blocks);
+    }
+}
+
+bool Backend::openFile(const QString &filePath)
 {
     QString cleanFilePath = filePath;
     if (cleanFilePath.startsWith("file:///")) {
         cleanFilePath = QUrl(filePath).toLocalFile();
     }
+    return openImage(cleanFilePath, true);
+}
 
-    QFile file(cleanFilePath);
-    if (!file.open(QIODevice::ReadOnly)) {
-        setStatusMessage("Error: Could not open file: " + file.errorString());
-        emit errorOccurred("File Error", "Could not open file: " + file.errorString());
-        return "";
+bool Backend::openImage(const QString &cleanFilePath, bool archive)
+{
+    TraceSpan span("openFile");
+    m_hexModel->setImage(nullptr); // Drop rows that still point into the old mapping
+    m_diffModel->clear();
+    m_regionAnalyzer->cancel();
+    m_regionMap->clear();
+    m_editHistory.clear(); // Recorded offsets belong to the old image
+    emit editHistoryChanged();
+    m_imageDirtyRanges.clear();
+    if (!m_image.open(cleanFilePath, NorImage::Mode::CopyOnWrite)) {
+        setStatusMessage("Error: Could not open file: " + m_image.errorString());
+        emit errorOccurred("File Error", "Could not open file: " + m_image.errorString());
+        return false;
     }
+    m_hexModel->setImage(&m_image); // Rows are formatted lazily by the view
+    startRegionAnalysis(); // Results stream into regionMap while the user looks around
 
-    QByteArray fileData = file.readAll();
-    file.close();
-
-    QString hexData = QString(fileData.toHex(' ')); // Space separated hex
-    QVariantMap details = parseNorDetails(fileData);
+    QVariantMap details = parseNorDetails(m_image.view());
+    if (archive) {
+        archiveAsync(cleanFilePath); // From the file on disk, which hex edits never reach
+    }
     
     setStatusMessage("File opened successfully: " + cleanFilePath);
-    emit fileOpened(cleanFilePath, hexData, details); // Emit with details
-    return hexData;
+    emit fileOpened(cleanFilePath, details); // Emit with details
+    return true;
+}
+
+bool Backend::compareWithFile(const QString &filePath)
+{
+    TraceSpan span("compareWithFile");
+    QString cleanFilePath = filePath;
+    if (cleanFilePath.startsWith("file:///")) {
+        cleanFilePath = QUrl(filePath).toLocalFile();
+    }
+    if (!m_image.isOpen()) {
+        emit errorOccurred("Compare Error", "Open a NOR dump first, then pick the dump to compare it with.");
+        return false;
+    }
+
+    m_diffModel->clear();
+    if (!m_compareImage.open(cleanFilePath, NorImage::Mode::ReadOnly)) {
+        setStatusMessage("Error: Could not open file: " + m_compareImage.errorString());
+        emit errorOccurred("Compare Error", "Could not open file: " + m_compareImage.errorString());
+        return false;
+    }
+    updateComparison();
+    return true;
+}
+
+void Backend::clearComparison()
+{
+    m_diffModel->clear();
+    m_compareImage.close();
 }
 
-// Helper function to apply NOR modifications (stubbed)
-QByteArray Backend::applyNorModifications(QByteArray originalData, const QVariantMap &modifications) {
+void Backend::updateComparison()
+{
+    QElapsedTimer timer;
+    timer.start();
+    NorDiff::Result result = NorDiff::compare(m_image.view(), m_compareImage.view());
+    const qint64 elapsedMs = timer.elapsed();
+    m_diffModel->setResult(std::move(result), &m_image, &m_compareImage);
+    setStatusMessage(QString("Compared with %1: %2 (%3 ms).")
+                         .arg(QFileInfo(m_compareImage.filePath()).fileName(), m_diffModel->summary())
+                         .arg(elapsedMs));
+}
+
+// Hit offsets for the search box; the hex view jumps between them with rowForOffset()
+QVariantMap Backend::findInImage(const QString &pattern)
+{
+    constexpr qsizetype maxHits = 10000; // Enough to page through, small enough for QML
+    QVariantMap result;
+    QByteArray bytes;
+    QString error;
+    if (!NorSearch::parsePattern(pattern, &bytes, &error)) {
+        setStatusMessage("Error: " + error);
+        return result;
+    }
+    QElapsedTimer timer;
+    timer.start();
+    const QList<qint64> hits = NorSearch::findAll(m_image.view(), bytes, maxHits + 1);
+    const qint64 elapsedUs = timer.nsecsElapsed() / 1000;
+
+    QVariantList offsets;
+    offsets.reserve(qMin(hits.size(), maxHits));
+    for (qsizetype i = 0; i < hits.size() && i < maxHits; ++i) {
+        offsets.append(hits.at(i));
+    }
+    result["offsets"] = offsets;
+    result["truncated"] = hits.size() > maxHits;
+    setStatusMessage(QString("Found %1%2 matches of %3 bytes in %4 ms.")
+                         .arg(offsets.size()).arg(hits.size() > maxHits ? "+" : "")
+                         .arg(bytes.size()).arg(elapsedUs / 1000.0, 0, 'f', 2));
+    return result;
+}
+
+// Same length replacements straight into the copy-on-write mapping, recorded like hex edits
+int Backend::replaceInImage(const QString &pattern, const QString &replacement)
+{
+    QByteArray find;
+    QByteArray replace;
+    QString error;
+    if (!NorSearch::parsePattern(pattern, &find, &error) || !NorSearch::parsePattern(replacement, &replace, &error)) {
+        setStatusMessage("Error: " + error);
+        return -1;
+    }
+    QList<NorPatch::Range> ranges;
+    int replaced = 0;
+    pauseRegionAnalysis();
+    if (!NorSearch::replaceAll(m_image.data(), m_image.size(), find, replace, &ranges, &replaced, &error, &m_editHistory)) {
+        resumeRegionAnalysis();
+        setStatusMessage("Error: Could not replace: " + error);
+        emit errorOccurred("Replace Error", error);
+        return -1;
+    }
+
+    imageRangesChanged(ranges);
+    setStatusMessage(QString("Replaced %1 matches, %2 byte ranges changed. Save to keep them.").arg(replaced).arg(ranges.size()));
+    return replaced;
+}
+
+bool Backend::undoEdit()
+{
+    QList<NorPatch::Range> ranges;
+    pauseRegionAnalysis();
+    if (!m_editHistory.undo(m_image.data(), &ranges)) {
+        resumeRegionAnalysis();
+        return false;
+    }
+    imageRangesChanged(ranges);
+    setStatusMessage(QString("Undone, %1 byte ranges restored.").arg(ranges.size()));
+    return true;
+}
+
+bool Backend::redoEdit()
+{
+    QList<NorPatch::Range> ranges;
+    pauseRegionAnalysis();
+    if (!m_editHistory.redo(m_image.data(), &ranges)) {
+        resumeRegionAnalysis();
+        return false;
+    }
+    imageRangesChanged(ranges);
+    setStatusMessage(QString("Redone, %1 byte ranges written again.").arg(ranges.size()));
+    return true;
+}
+
+bool Backend::tracingEnabled() const
+{
+    return Tracer::isEnabled();
+}
+
+void Backend::setTracingEnabled(bool enabled)
+{
+    if (Tracer::isEnabled() != enabled) {
+        Tracer::setEnabled(enabled);
+        emit tracingEnabledChanged();
+    }
+}
+
+QVariantMap Backend::traceStatistics() const
+{
+    QVariantList spans;
+    const QList<Tracer::Histogram> histograms = Tracer::instance().histograms();
+    for (const Tracer::Histogram &histogram : histograms) {
+        QVariantList buckets;
+        int lastBucket = 0;
+        for (int i = 0; i < Tracer::BucketCount; ++i) {
+            if (histogram.buckets[i] > 0) {
+                lastBucket = i;
+            }
+        }
+        for (int i = 0; i <= lastBucket; ++i) {
+            buckets.append(histogram.buckets[i]);
+        }
+        QVariantMap span;
+        span["name"] = histogram.name;
+        span["category"] = histogram.category;
+        span["count"] = histogram.count;
+        span["meanMs"] = histogram.meanUs() / 1000.0;
+        span["p50Ms"] = double(histogram.percentileUs(0.50)) / 1000.0;
+        span["p90Ms"] = double(histogram.percentileUs(0.90)) / 1000.0;
+        span["p99Ms"] = double(histogram.percentileUs(0.99)) / 1000.0;
+        span["maxMs"] = double(histogram.maxUs) / 1000.0;
+        span["buckets"] = buckets; // Bucket k: below 2^k microseconds
+        spans.append(span);
+    }
+    QVariantMap statistics;
+    statistics["spans"] = spans;
+    statistics["events"] = Tracer::instance().eventCount();
+    statistics["maxEvents"] = Tracer::MaxEvents;
+    return statistics;
+}
+
+bool Backend::exportTrace(const QString &filePath)
+{
+    QString cleanFilePath = filePath;
+    if (cleanFilePath.startsWith("file:///")) {
+        cleanFilePath = QUrl(filePath).toLocalFile();
+    }
+    QString error;
+    if (!Tracer::instance().writeChromeTrace(cleanFilePath, &error)) {
+        setStatusMessage("Error: Could not write trace: " + error);
+        emit errorOccurred("Trace Export Error", "Could not write " + cleanFilePath + ": " + error);
+        return false;
+    }
+    setStatusMessage(QString("Trace with %1 events written to %2").arg(Tracer::instance().eventCount()).arg(cleanFilePath));
+    return true;
+}
+
+void Backend::clearTrace()
+{
+    Tracer::instance().clear();
+    setStatusMessage("Trace cleared.");
+}
+
+bool Backend::archiveDumps() const
+{
+    return m_archiveDumps;
+}
+
+void Backend::setArchiveDumps(bool enabled)
+{
+    if (m_archiveDumps != enabled) {
+        m_archiveDumps = enabled;
+        emit archiveDumpsChanged();
+    }
+}
+
+// The pool maps filePath read-only and hashes it there; no copy of the image is made.
+// The path stays in m_archivingPaths until then, so replacing it waits for that ingest only.
+void Backend::archiveAsync(const QString &filePath)
+{
+    if (!m_archiveDumps) {
+        return;
+    }
+    const QString canonicalPath = QFileInfo(filePath).canonicalFilePath();
+    {
+        QMutexLocker locker(&m_archivingMutex);
+        ++m_archivingPaths[canonicalPath];
+    }
+    const NorArchive *archive = m_archive.get();
+    m_archivePool->start([this, archive, filePath, canonicalPath]() {
+        NorArchive::IngestResult result;
+        QString error;
+        const bool ok = archive->ingestFile(filePath, &result, &error);
+        {
+            QMutexLocker locker(&m_archivingMutex);
+            if (--m_archivingPaths[canonicalPath] == 0) {
+                m_archivingPaths.remove(canonicalPath);
+            }
+            m_archivingDone.wakeAll();
+        }
+        const QString name = QFileInfo(filePath).fileName();
+        QMetaObject::invokeMethod(this, [this, ok, result, error, name]() {
+            if (!ok) {
+                qWarning() << "Could not archive" << name << ":" << error;
+            } else if (!result.alreadyArchived) {
+                qDebug() << "Archived" << name << "as" << result.id << "with" << result.newBytes << "new bytes";
+                emit archiveChanged();
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+QVariantList Backend::archivedDumps() const
+{
+    QVariantList dumps;
+    const QList<NorArchive::Manifest> manifests = m_archive->manifests();
+    for (const NorArchive::Manifest &manifest : manifests) {
+        QVariantMap dump;
+        dump["id"] = manifest.id;
+        dump["name"] = manifest.name;
+        dump["size"] = manifest.size;
+        dump["created"] = QDateTime::fromSecsSinceEpoch(manifest.createdAt).toString("yyyy-MM-dd hh:mm");
+        dump["model"] = manifest.details.value("model");
+        dump["boardSerial"] = manifest.details.value("boardSerial");
+        dump["label"] = QString("%1  %2  %3").arg(dump["created"].toString(), manifest.details.value("boardSerial").toString(), manifest.name);
+        dumps.append(dump);
+    }
+    return dumps;
+}
+
+bool Backend::openArchivedDump(const QString &id)
+{
+    // Restored into the cache and opened like any other file, so editing and saving work as usual
+    const QString path = QDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation)).filePath("archive/" + id + ".bin");
+    releaseImageFor(path);
+    QElapsedTimer timer;
+    timer.start();
+    QString error;
+    if (!m_archive->restoreToFile(id, path, &error)) {
+        setStatusMessage("Error: Could not restore archived dump: " + error);
+        emit errorOccurred("Archive Error", "Could not restore archived dump: " + error);
+        return false;
+    }
+    const qint64 restoreMs = timer.elapsed();
+    if (!openImage(path, false)) { // Its content is the archived dump, ingesting again would only re-hash it
+        return false;
+    }
+    setStatusMessage(QString("Archived dump restored in %1 ms: %2").arg(restoreMs).arg(path));
+    return true;
+}
+
+// Edits go straight into the copy-on-write mapping, so only touched pages get copied,
+// and every byte range that really changed is reported for the patch writer.
+bool Backend::applyNorModifications(NorImage &image, const QVariantMap &modifications, QList<NorPatch::Range> *dirtyRanges) {
     qDebug() << "applyNorModifications called with: " << modifications;
-    setStatusMessage("NOR modification logic not fully implemented in backend.");
-    return originalData; 
+    QString error;
+    if (!NorPatch::applyModifications(image.data(), image.size(), modifications, dirtyRanges, &error)) {
+        setStatusMessage("Error: Could not apply modifications: " + error);
+        emit errorOccurred("Modification Error", error);
+        return false;
+    }
+    return true;
+}
+
+// A mapped file must not be replaced underneath its mapping (Windows refuses the
+// rename, POSIX would leave us reading a stale inode), so copy it out first.
+void Backend::releaseImageFor(const QString &filePath, NorImage *other)
+{
+    const QString target = QFileInfo(filePath).canonicalFilePath();
+    if (target.isEmpty()) {
+        return; // Destination does not exist yet, nothing can be mapping it
+    }
+    {
+        // An ingest may still map the file being replaced; ingests of other files carry on
+        QMutexLocker locker(&m_archivingMutex);
+        while (m_archivingPaths.contains(target)) {
+            m_archivingDone.wait(&m_archivingMutex);
+        }
+    }
+    if (m_image.isMapped() && QFileInfo(m_image.filePath()).canonicalFilePath() == target) {
+        const bool analyzing = m_regionAnalyzer->isRunning();
+        m_regionAnalyzer->cancel(); // Its workers hold pointers into the mapping
+        m_image.detach();
+        if (analyzing) {
+            startRegionAnalysis();
+        }
+    }
+    if (other && other->isMapped() && QFileInfo(other->filePath()).canonicalFilePath() == target) {
+        other->detach();
+    }
+    if (m_compareImage.isMapped() && QFileInfo(m_compareImage.filePath()).canonicalFilePath() == target) {
+        m_compareImage.detach(); // The diff model reads through the NorImage, so it follows along
+    }
 }
 
 bool Backend::saveModifiedFile(const QString &filePathToSave, const QString &originalFilePath, const QVariantMap &modifications)
 {
+    TraceSpan span("saveModifiedFile");
     QString cleanFilePathToSave = filePathToSave;
     if (cleanFilePathToSave.startsWith("file:///")) {
         cleanFilePathToSave = QUrl(filePathToSave).toLocalFile();
@@ -348,33 +1008,33 @@ bool Backend::saveModifiedFile(const QString &filePathToSave, const QString &ori
         cleanOriginalFilePath = QUrl(originalFilePath).toLocalFile();
     }
 
-    QFile origFile(cleanOriginalFilePath);
-    if (!origFile.open(QIODevice::ReadOnly)) {
-        setStatusMessage("Error: Could not open original file for reading: " + origFile.errorString());
-        emit errorOccurred("File Error", "Could not open original file: " + origFile.errorString());
+    NorImage image;
+    if (!image.open(cleanOriginalFilePath, NorImage::Mode::CopyOnWrite)) {
+        setStatusMessage("Error: Could not open original file for reading: " + image.errorString());
+        emit errorOccurred("File Error", "Could not open original file: " + image.errorString());
         return false;
     }
-    QByteArray originalData = origFile.readAll();
-    origFile.close();
-
-    QByteArray modifiedData = applyNorModifications(originalData, modifications);
 
-    QFile file(cleanFilePathToSave);
-    if (!file.open(QIODevice::WriteOnly)) {
-        setStatusMessage("Error: Could not open file for writing: " + file.errorString());
-        emit errorOccurred("File Error", "Could not open file for writing: " + file.errorString());
+    QList<NorPatch::Range> dirtyRanges;
+    if (!applyNorModifications(image, modifications, &dirtyRanges)) {
         return false;
     }
 
-    if (file.write(modifiedData) == -1) {
-        setStatusMessage("Error: Could not write to file: " + file.errorString());
-        emit errorOccurred("File Error", "Could not write to file: " + file.errorString());
-        file.close();
+    // Copy the original (reflink where possible), patch only the dirty ranges, then rename into place
+    releaseImageFor(cleanFilePathToSave, &image);
+    QString error;
+    if (!NorPatch::writePatchedCopy(cleanOriginalFilePath, cleanFilePathToSave, image, dirtyRanges, &error)) {
+        setStatusMessage("Error: Could not write to file: " + error);
+        emit errorOccurred("File Error", "Could not write to file: " + error);
         return false;
     }
 
-    file.close();
-    setStatusMessage("File saved successfully with modifications: " + cleanFilePathToSave);
+    archiveAsync(cleanFilePathToSave);
+    qint64 patchedBytes = 0;
+    for (const NorPatch::Range &range : dirtyRanges) {
+        patchedBytes += range.length;
+    }
+    setStatusMessage(QString("File saved successfully with modifications (%1 bytes changed): %2").arg(patchedBytes).arg(cleanFilePathToSave));
     return true;
 }
 
@@ -385,131 +1045,228 @@ bool Backend::saveFile(const QString &filePath, const QString &hexData)
         cleanFilePath = QUrl(filePath).toLocalFile();
     }
 
-    QFile file(cleanFilePath);
+    // Decode straight from the UTF-16 text, skipping whitespace, in one pass
+    QByteArray fileData(HexCodec::maxDecodedLength(hexData.size()), Qt::Uninitialized);
+    const HexCodec::DecodeResult decoded = HexCodec::decode(reinterpret_cast<const char16_t *>(hexData.utf16()), hexData.size(),
+                                                            reinterpret_cast<uchar *>(fileData.data()));
+    if (!decoded.ok()) {
+        const QString message = QString("Invalid hex data at character %1.").arg(decoded.errorOffset);
+        setStatusMessage("Error: " + message);
+        emit errorOccurred("File Error", message);
+        return false;
+    }
+    fileData.truncate(decoded.bytesWritten);
+
+    releaseImageFor(cleanFilePath);
+    QSaveFile file(cleanFilePath);
     if (!file.open(QIODevice::WriteOnly)) {
         setStatusMessage("Error: Could not open file for writing: " + file.errorString());
         emit errorOccurred("File Error", "Could not open file for writing: " + file.errorString());
         return false;
     }
 
-    QString tempHex = hexData;
-    tempHex.remove(' '); // Remove spaces if any
-    QByteArray fileData = QByteArray::fromHex(tempHex.toUtf8());
-
-    if (file.write(fileData) == -1) {
+    if (file.write(fileData) == -1 || !file.commit()) {
         setStatusMessage("Error: Could not write to file: " + file.errorString());
         emit errorOccurred("File Error", "Could not write to file: " + file.errorString());
-        file.close();
         return false;
     }
 
-    file.close();
+    archiveAsync(cleanFilePath);
+    setStatusMessage("File saved successfully: " + cleanFilePath);
+    return true;
+}
+
+bool Backend::saveCurrentFile(const QString &filePath)
+{
+    TraceSpan span("saveCurrentFile");
+    QString cleanFilePath = filePath;
+    if (cleanFilePath.startsWith("file:///")) {
+        cleanFilePath = QUrl(filePath).toLocalFile();
+    }
+
+    if (!m_image.isOpen()) {
+        setStatusMessage("Error: No file is currently open.");
+        emit errorOccurred("File Error", "No file is currently open.");
+        return false;
+    }
+
+    // Only a still mapped image is known to match its file outside the edited ranges
+    const QString sourcePath = m_image.isMapped() ? m_image.filePath() : QString();
+    releaseImageFor(cleanFilePath);
+    QString error;
+    if (!NorPatch::writePatchedCopy(sourcePath, cleanFilePath, m_image, m_imageDirtyRanges, &error)) {
+        setStatusMessage("Error: Could not write to file: " + error);
+        emit errorOccurred("File Error", "Could not write to file: " + error);
+        return false;
+    }
+
+    archiveAsync(cleanFilePath);
+    m_editHistory.markClean();
+    emit editHistoryChanged();
     setStatusMessage("File saved successfully: " + cleanFilePath);
     return true;
 }
 
 QString Backend::parseErrorsOnline(const QString &errorCode) {
-    if (errorCode.isEmpty()) {
+    if (errorCode.trimmed().isEmpty()) {
         emit errorOccurred("Input Error", "Error code cannot be empty.");
         return "Error: Empty error code"; 
     }
-    QUrl url("http://uartcodes.com/xml.php");
-    QUrlQuery query; // This requires <QUrlQuery> to be included
-    query.addQueryItem("errorCode", errorCode);
-    url.setQuery(query);
+    // Several codes (e.g. pasted from an errlog dump) are resolved as one batch
+    static const QRegularExpression separators("[\\s,;]+");
+    const QStringList codes = errorCode.split(separators, Qt::SkipEmptyParts);
+    if (codes.size() > 1) {
+        m_onlineErrorLookup->lookupBatch(codes);
+        setStatusMessage(QString("Fetching online descriptions for %1 error codes...").arg(codes.size()));
+        return "Fetching descriptions...";
+    }
 
-    QNetworkRequest request(url);
-    setStatusMessage("Fetching online description for " + errorCode + "...");
-    QNetworkReply *reply = m_networkManager->get(request);
-    connect(reply, &QNetworkReply::finished, this, [this, reply, errorCode]() {
-        onOnlineErrorCheckFinished(reply);
-    });
+    OnlineErrorLookup::Result cached;
+    if (m_onlineErrorLookup->cached(errorCode, &cached)) {
+        setStatusMessage("Online check for " + cached.code + " complete (cached).");
+        return onlineResultText(cached);
+    }
+    m_pendingOnlineLookups.insert(OnlineErrorCache::normalizeCode(errorCode));
+    m_onlineErrorLookup->lookup(errorCode);
+    setStatusMessage("Fetching online description for " + errorCode.trimmed() + "...");
     return "Fetching description..."; 
 }
 
-void Backend::onOnlineErrorCheckFinished(QNetworkReply *reply) {
-    QString resultText;
-    if (reply->error() == QNetworkReply::NoError) {
-        QByteArray data = reply->readAll();
-        QXmlStreamReader xml(data);
-        QString description = "Description not found or error parsing response.";
-        
-        // Construct QUrlQuery from the reply URL's query string
-        QUrlQuery query(reply->url().query());
-        QString parsedErrorCode = query.queryItemValue("errorCode"); 
-
-        bool inErrorCodeOuter = false;
-        QString currentCode, currentDesc;
-
-        while (!xml.atEnd() && !xml.hasError()) {
-            QXmlStreamReader::TokenType token = xml.readNext();
-            if (token == QXmlStreamReader::StartElement) {
-                if (xml.name().toString() == "errorCodes") { // Root
-                    // continue
-                } else if (xml.name().toString() == "errorCode") {
-                    inErrorCodeOuter = true;
-                    currentCode.clear();
-                    currentDesc.clear();
-                } else if (inErrorCodeOuter && xml.name().toString() == "ErrorCode") {
-                    currentCode = xml.readElementText();
-                } else if (inErrorCodeOuter && xml.name().toString() == "Description") {
-                    currentDesc = xml.readElementText();
-                }
-            } else if (token == QXmlStreamReader::EndElement) {
-                if (xml.name().toString() == "errorCode") {
-                    if (currentCode == parsedErrorCode || parsedErrorCode.isEmpty()) { // If only one result, it's ours
-                        description = currentDesc;
-                        // If parsedErrorCode was empty and we got a code, update it
-                        if (parsedErrorCode.isEmpty() && !currentCode.isEmpty()) parsedErrorCode = currentCode;
-                        break; 
-                    }
-                    inErrorCodeOuter = false;
-                }
-            }
-        }
-        if (xml.hasError()) {
-            description = "Error parsing XML response: " + xml.errorString();
-        }
-        resultText = "Error code: " + parsedErrorCode + "\nDescription: " + description;
-        setStatusMessage("Online check for " + parsedErrorCode + " complete.");
+void Backend::onOnlineErrorResultReady(const OnlineErrorLookup::Result &result) {
+    if (!m_pendingOnlineLookups.remove(result.code)) {
+        return; // Part of a batch, reported by onOnlineErrorBatchFinished
+    }
+    if (result.ok()) {
+        setStatusMessage("Online check for " + result.code + " complete.");
     } else {
-        resultText = "Error fetching online description: " + reply->errorString();
-        setStatusMessage(resultText);
+        setStatusMessage(onlineResultText(result));
     }
-    emit onlineErrorResultReady(resultText);
-    reply->deleteLater();
+    emit onlineErrorResultReady(onlineResultText(result));
+}
+
+void Backend::onOnlineErrorBatchFinished(int batchId, const QList<OnlineErrorLookup::Result> &results) {
+    Q_UNUSED(batchId);
+    QStringList blocks;
+    int failures = 0;
+    for (const OnlineErrorLookup::Result &result : results) {
+        blocks.append(onlineResultText(result));
+        failures += result.ok() ? 0 : 1;
+    }
+    setStatusMessage(QString("Online check for %1 error codes complete (%2 failed).").arg(results.size()).arg(failures));
+    emit onlineErrorResultReady(blocks.join("\n\n"));
+}
+
+QString Backend::onlineResultText(const OnlineErrorLookup::Result &result) {
+    if (!result.ok()) {
+        return "Error fetching online description for " + result.code + ": " + result.errorString;
+    }
+    const QString description = result.found ? result.description : "Description not found or error parsing response.";
+    return "Error code: " + result.code + "\nDescription: " + description;
 }
 
 void Backend::readAllErrorLogs() {
-    if (!m_serialPort->isOpen()) {
+    if (!m_serialConnected) {
         setStatusMessage("Serial port not connected.");
         emit errorOccurred("Serial Command Error", "Serial port is not connected.");
         emit allErrorLogsData("Error: Not connected");
         return;
     }
-    QString aggregatedLogs = "Reading all error logs:\n";
-    bool anErrorOccurred = false;
 
+    // All slots are queued at once; the engine keeps serialPipelineDepth of them on the
+    // wire and every reply is decoded into errorLogModel as soon as it is framed
+    struct Progress {
+        QString aggregatedLogs = "Reading all error logs:\n";
+        int remaining = 0;
+        bool anErrorOccurred = false;
+        QElapsedTimer elapsed;
+        qint64 traceStartNs = -1;
+    };
+    auto progress = std::make_shared<Progress>();
+    progress->traceStartNs = Tracer::isEnabled() ? Tracer::now() : -1;
+    progress->remaining = 11;
+    progress->elapsed.start();
+    m_errorLogModel->setEntries({});
     for (int i = 0; i <= 10; ++i) {
         QString command = QString("errlog %1").arg(i);
-        QString response = sendSerialCommand(command); // sendSerialCommand is blocking
-        aggregatedLogs += QString("Cmd: %1 -> Response: %2\n").arg(command).arg(response);
-        if (response.startsWith("Error:")) {
-            anErrorOccurred = true;
-        }
+        m_serialEngine->submit(command, [this, progress, i](const SerialCommandEngine::Response &response) {
+            const QString text = serialResponseText(response);
+            progress->aggregatedLogs += QString("Cmd: %1 -> Response: %2\n").arg(response.command).arg(text);
+            if (text.startsWith("Error:")) {
+                progress->anErrorOccurred = true;
+            }
+            if (response.answered()) {
+                QList<ErrorLogEntry> entries = ErrorLogModel::parse(text);
+                for (ErrorLogEntry &entry : entries) {
+                    entry.slot = i;
+                }
+                resolveErrorLogEntries(entries);
+                m_errorLogModel->appendEntries(entries);
+            }
+            if (--progress->remaining > 0) {
+                return;
+            }
+            if (progress->traceStartNs >= 0) {
+                Tracer::instance().complete("readAllErrorLogs", "serial", progress->traceStartNs);
+            }
+            const QString summary = progress->anErrorOccurred ? "Finished reading logs with some errors" : "Finished reading all error logs";
+            setStatusMessage(QString("%1 in %2 ms (%3 codes).").arg(summary).arg(progress->elapsed.elapsed()).arg(m_errorLogModel->count()));
+            emit allErrorLogsData(progress->aggregatedLogs);
+        });
     }
-    setStatusMessage(anErrorOccurred ? "Finished reading logs with some errors." : "Finished reading all error logs.");
-    emit allErrorLogsData(aggregatedLogs);
 }
 
 void Backend::clearConsoleErrorLogs() {
-    if (!m_serialPort->isOpen()) {
+    if (!m_serialConnected) {
         setStatusMessage("Serial port not connected.");
         emit errorOccurred("Serial Command Error", "Serial port is not connected.");
         emit consoleErrorLogsCleared("Error: Not connected");
         return;
     }
-    QString response = sendSerialCommand("errlog clear");
-    setStatusMessage("Clear error logs command sent. Response: " + response);
-    emit consoleErrorLogsCleared(response);
+    m_serialEngine->submit("errlog clear", [this](const SerialCommandEngine::Response &response) {
+        const QString text = serialResponseText(response);
+        setStatusMessage("Clear error logs command sent. Response: " + text);
+        emit consoleErrorLogsCleared(text);
+    });
+}
+
+bool Backend::openSerialSession(const QString &portName)
+{
+    if (m_serialConnected && m_connectedSerialPort == portName) {
+        setStatusMessage(portName + " is already the main connection.");
+        return false;
+    }
+    QString error;
+    if (!m_serialSessions->open(portName, &error)) {
+        setStatusMessage("Error opening session on " + portName + ": " + error);
+        emit errorOccurred("Serial Session Error", "Could not open " + portName + ": " + error);
+        return false;
+    }
+    setStatusMessage(QString("Session opened on %1 (%2 open).").arg(portName).arg(m_serialSessions->count()));
+    return true;
+}
+
+void Backend::closeSerialSession(int row)
+{
+    m_serialSessions->close(row);
+}
+
+void Backend::sendCommandToAllSessions(const QString &command)
+{
+    if (m_serialSessions->count() == 0) {
+        setStatusMessage("No serial sessions are open.");
+        return;
+    }
+    m_serialSessions->sendToAll(command);
+}
+
+void Backend::readErrorLogsOnAllSessions()
+{
+    if (m_serialSessions->isReadingErrorLogs()) {
+        setStatusMessage("Error logs are already being read.");
+        return;
+    }
+    m_errorLogModel->setEntries({});
+    const int sessions = m_serialSessions->readErrorLogsOnAll();
+    setStatusMessage(sessions > 0 ? QString("Reading error logs of %1 consoles...").arg(sessions)
+                                  : QString("No serial sessions are open."));
 }
@@ -6,12 +6,40 @@
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
 #include <QFile>
+#include <QHash>
+#include <QMutex>
 #include <QXmlStreamReader> 
 #include <QSerialPort>
 #include <QSerialPortInfo>
+#include <QSet>
 #include <QStringList>
 #include <QUrl> 
+#include <QVariantList>
 #include <QVariantMap> 
+#include <QWaitCondition>
+#include <memory>
+#include "databasedownloader.h"
+#include "diffmodel.h"
+#include "norarchive.h"
+#include "noredithistory.h"
+#include "norimage.h"
+#include "onlineerrorlookup.h"
+#include "regionanalyzer.h"
+#include "regionmapmodel.h"
+#include "hexviewmodel.h"
+#include "norpatch.h"
+#include "errordatabaseindex.h"
+#include "errorlogmodel.h"
+#include "serialcommandengine.h"
+#include "serialportwatcher.h"
+#include "serialsessionmodel.h"
+#include "spscringbuffer.h"
+#include "uartcapture.h"
+
+class QThread;
+class QThreadPool;
+class QTimer;
+class SerialWorker;
 
 class Backend : public QObject
 {
@@ -20,10 +48,27 @@ class Backend : public QObject
     Q_PROPERTY(QString localDatabaseFile READ localDatabaseFile CONSTANT)
     Q_PROPERTY(QStringList availableSerialPorts READ availableSerialPorts NOTIFY availableSerialPortsChanged)
     Q_PROPERTY(QString currentSerialPort READ currentSerialPort WRITE setCurrentSerialPort NOTIFY currentSerialPortChanged)
+    Q_PROPERTY(int serialPipelineDepth READ serialPipelineDepth WRITE setSerialPipelineDepth NOTIFY serialPipelineDepthChanged)
+    Q_PROPERTY(bool autoConnectSerial READ autoConnectSerial WRITE setAutoConnectSerial NOTIFY autoConnectSerialChanged)
+    Q_PROPERTY(bool captureUart READ captureUart WRITE setCaptureUart NOTIFY captureUartChanged)
+    Q_PROPERTY(bool tracingEnabled READ tracingEnabled WRITE setTracingEnabled NOTIFY tracingEnabledChanged)
+    Q_PROPERTY(bool archiveDumps READ archiveDumps WRITE setArchiveDumps NOTIFY archiveDumpsChanged)
     Q_PROPERTY(bool isSerialPortConnected READ isSerialPortConnected NOTIFY serialPortConnectedChanged)
+    Q_PROPERTY(HexViewModel *hexModel READ hexModel CONSTANT)
+    Q_PROPERTY(ErrorLogModel *errorLogModel READ errorLogModel CONSTANT)
+    Q_PROPERTY(DiffModel *diffModel READ diffModel CONSTANT)
+    Q_PROPERTY(RegionMapModel *regionMap READ regionMap CONSTANT)
+    Q_PROPERTY(SerialSessionModel *serialSessions READ serialSessions CONSTANT)
+    Q_PROPERTY(bool canUndo READ canUndo NOTIFY editHistoryChanged)
+    Q_PROPERTY(bool canRedo READ canRedo NOTIFY editHistoryChanged)
+    Q_PROPERTY(bool imageModified READ imageModified NOTIFY editHistoryChanged)
 
 public:
+    // errlog commands kept on the wire at once by readAllErrorLogs
+    static constexpr int DefaultSerialPipelineDepth = 4;
+
     explicit Backend(QObject *parent = nullptr);
+    ~Backend() override;
 
     QString statusMessage() const;
     void setStatusMessage(const QString &message);
@@ -32,52 +77,162 @@ public:
     QStringList availableSerialPorts() const;
     QString currentSerialPort() const;
     void setCurrentSerialPort(const QString &portName);
+    int serialPipelineDepth() const;
+    // Connect automatically when a known USB-UART adapter is plugged in
+    bool autoConnectSerial() const;
+    void setAutoConnectSerial(bool enabled);
+    void setSerialPipelineDepth(int depth);
     bool isSerialPortConnected() const;
+    // Record everything the console sends into rotating compressed segments
+    bool captureUart() const { return m_uartCapture->isActive(); }
+    void setCaptureUart(bool enabled);
+    // Timed spans around file, lookup, serial and network work, see Tracer
+    bool tracingEnabled() const;
+    void setTracingEnabled(bool enabled);
+    // Store every dump opened or saved in the deduplicating archive
+    bool archiveDumps() const;
+    void setArchiveDumps(bool enabled);
+    HexViewModel *hexModel() const { return m_hexModel; }
+    ErrorLogModel *errorLogModel() const { return m_errorLogModel; }
+    DiffModel *diffModel() const { return m_diffModel; }
+    RegionMapModel *regionMap() const { return m_regionMap; }
+    SerialSessionModel *serialSessions() const { return m_serialSessions; }
+    bool canUndo() const { return m_editHistory.canUndo(); }
+    bool canRedo() const { return m_editHistory.canRedo(); }
+    bool imageModified() const { return !m_editHistory.isClean(); }
 
     Q_INVOKABLE void downloadDatabaseAsync();
     Q_INVOKABLE QString parseErrorsOffline(const QString &errorCode);
-    Q_INVOKABLE QString parseErrorsOnline(const QString &errorCode); 
-    Q_INVOKABLE QString openFile(const QString &filePath); 
+    Q_INVOKABLE QString parseErrorsOnline(const QString &errorCode); // Answered by onlineErrorResultReady unless cached
+    Q_INVOKABLE ErrorLogModel *decodeErrorLog(const QString &raw);
+    Q_INVOKABLE bool openFile(const QString &filePath); 
     Q_INVOKABLE bool saveFile(const QString &filePath, const QString &hexData); 
+    Q_INVOKABLE bool saveCurrentFile(const QString &filePath); 
+    // Diffs the open dump against filePath into diffModel; redone after every hex edit.
+    Q_INVOKABLE bool compareWithFile(const QString &filePath);
+    Q_INVOKABLE void clearComparison();
+    // Patterns are hex bytes ("22 02 01 01") or quoted ASCII, see NorSearch::parsePattern()
+    Q_INVOKABLE QVariantMap findInImage(const QString &pattern);
+    Q_INVOKABLE int replaceInImage(const QString &pattern, const QString &replacement);
+    // Hex edits and replace-all are undone one step at a time, back to the opened file
+    Q_INVOKABLE bool undoEdit();
+    Q_INVOKABLE bool redoEdit();
+    // Latency per span name: count, mean, p50/p90/p99 and max in ms, and the bucket counts
+    Q_INVOKABLE QVariantMap traceStatistics() const;
+    // Chrome trace-event JSON, for chrome://tracing or Perfetto
+    Q_INVOKABLE bool exportTrace(const QString &filePath);
+    Q_INVOKABLE void clearTrace();
+    Q_INVOKABLE QVariantList archivedDumps() const;
+    Q_INVOKABLE bool openArchivedDump(const QString &id);
     Q_INVOKABLE bool saveModifiedFile(const QString &filePath, const QString &originalFilePath, const QVariantMap &modifications); 
 
     Q_INVOKABLE void refreshSerialPorts();
     Q_INVOKABLE bool connectSerialPort(); 
     Q_INVOKABLE bool connectSerialPortByName(const QString &portName); 
     Q_INVOKABLE void disconnectSerialPort();
-    Q_INVOKABLE QString sendSerialCommand(const QString &command); 
+    Q_INVOKABLE void sendSerialCommand(const QString &command); // Answered by serialResponseReceived
     Q_INVOKABLE void readAllErrorLogs(); 
     Q_INVOKABLE void clearConsoleErrorLogs(); 
+    // Extra consoles next to the main connection, e.g. a bench of several UART adapters
+    Q_INVOKABLE bool openSerialSession(const QString &portName);
+    Q_INVOKABLE void closeSerialSession(int row);
+    Q_INVOKABLE void sendCommandToAllSessions(const QString &command);
+    // errlog 0..10 on every session at once, decoded into errorLogModel with the port of each entry
+    Q_INVOKABLE void readErrorLogsOnAllSessions();
+    // Segments of the current or last UART capture, oldest first; the open segment comes last
+    Q_INVOKABLE QVariantList uartCaptureSegments() const;
+    Q_INVOKABLE QString uartCaptureText(int index) const;
 
 signals:
     void statusMessageChanged();
     void databaseDownloadFinished(bool success);
     void availableSerialPortsChanged();
+    void serialPipelineDepthChanged();
+    void autoConnectSerialChanged();
+    void captureUartChanged();
+    void uartCaptureSegmentsChanged();
+    void archiveDumpsChanged();
+    void tracingEnabledChanged();
+    void archiveChanged();
+    void editHistoryChanged();
     void currentSerialPortChanged();
     void serialPortConnectedChanged(bool connected);
     void errorOccurred(const QString &title, const QString &message); 
-    void fileOpened(const QString &fileName, const QString &fileContentHex, const QVariantMap &details); 
+    void fileOpened(const QString &fileName, const QVariantMap &details); 
+    void norDetailsChanged(const QVariantMap &details); 
     void onlineErrorResultReady(const QString &result); 
+    void serialResponseReceived(const QString &command, const QString &response);
+    void serialOutputReceived(const QString &text); // Console output outside any command response, batched per frame
     void allErrorLogsData(const QString &data); 
     void consoleErrorLogsCleared(const QString &result); 
 
 private slots:
-    void onDownloadFinished(QNetworkReply *reply);
-    void onOnlineErrorCheckFinished(QNetworkReply *reply); 
-    void handleSerialError(QSerialPort::SerialPortError error);
-    void handleSerialDataReady(); 
+    void onDatabaseDownloadFinished(const DatabaseDownloader::Result &result);
+    void onOnlineErrorResultReady(const OnlineErrorLookup::Result &result);
+    void onOnlineErrorBatchFinished(int batchId, const QList<OnlineErrorLookup::Result> &results);
+    void handleSerialError(const QString &message);
+    void handleSerialPortLost();
+    void drainSerialInput();
+    void onSerialPortsChanged(const QList<SerialPortDescription> &ports);
+    void onImageBytesEdited(qint64 offset, qint64 length);
 
 private:
     QNetworkAccessManager *m_networkManager;
+    DatabaseDownloader *m_databaseDownloader;
+    OnlineErrorLookup *m_onlineErrorLookup;
+    QSet<QString> m_pendingOnlineLookups; // Single lookups to report through onlineErrorResultReady
     QString m_statusMessage;
     QString m_localDatabaseFile; 
-    QSerialPort *m_serialPort = nullptr;
+    QThread *m_serialThread = nullptr;
+    SerialWorker *m_serialWorker = nullptr; // Lives on m_serialThread
+    SerialPortWatcher *m_portWatcher = nullptr; // Lives on m_serialThread
+    bool m_autoConnectSerial = false;
+    bool m_refreshRequested = false;
+    SpscRingBuffer m_serialRx { 1 << 20 };  // Worker -> GUI receive bytes
+    SpscRingBuffer m_serialRxStamps { 1 << 20 }; // One SerialWorker::ReadStamp per chunk in m_serialRx
+    QTimer *m_serialDrainTimer = nullptr;
+    UartCapture *m_uartCapture = nullptr;
+    QString m_uartCaptureDirectory; // Current or last capture, kept after it stops for browsing
+    SerialCommandEngine *m_serialEngine = nullptr;
+    SerialSessionModel *m_serialSessions = nullptr;
+    QStringList m_pendingSerialOutput;
+    bool m_serialConnected = false;
+    QString m_connectedSerialPort;
     QStringList m_availableSerialPorts;
     QString m_currentSerialPort;
+    NorImage m_image; // Currently opened dump, mapped copy-on-write so the hex view can edit it
+    HexViewModel *m_hexModel;
+    ErrorLogModel *m_errorLogModel; // Last decodeErrorLog() result
+    NorImage m_compareImage; // Dump m_image is compared with, read-only
+    DiffModel *m_diffModel;
+    RegionMapModel *m_regionMap;
+    RegionAnalyzer *m_regionAnalyzer;
+    bool m_regionAnalysisPaused = false; // Cancelled for an edit, restarted once it is written
+    std::unique_ptr<NorArchive> m_archive;
+    QThreadPool *m_archivePool = nullptr;
+    bool m_archiveDumps = false; // Opt-in: dumps are copied into AppData
+    QMutex m_archivingMutex;
+    QWaitCondition m_archivingDone;
+    QHash<QString, int> m_archivingPaths; // Canonical path -> queued ingests mapping it
+    QList<NorPatch::Range> m_imageDirtyRanges; // Bytes edited in the hex view since openFile
+    NorEditHistory m_editHistory; // Undo/redo of the edits in m_imageDirtyRanges
+    ErrorDatabaseIndex m_errorIndex;
 
-    void updateAvailableSerialPorts();
-    QVariantMap parseNorDetails(const QByteArray &fileData); 
-    QByteArray applyNorModifications(QByteArray originalData, const QVariantMap &modifications); 
+    void closeSerialPort();
+    bool ensureErrorIndex(QString *errorString);
+    bool resolveErrorLogEntries(QList<ErrorLogEntry> &entries);
+    static QString onlineResultText(const OnlineErrorLookup::Result &result);
+    void updateComparison();
+    void startRegionAnalysis();
+    void pauseRegionAnalysis();
+    void resumeRegionAnalysis();
+    void refreshRegions(const QList<NorPatch::Range> &ranges);
+    void imageRangesChanged(const QList<NorPatch::Range> &ranges);
+    void archiveAsync(const QString &filePath);
+    bool openImage(const QString &cleanFilePath, bool archive);
+    void releaseImageFor(const QString &filePath, NorImage *other = nullptr);
+    QVariantMap parseNorDetails(QByteArrayView fileData); 
+    bool applyNorModifications(NorImage &image, const QVariantMap &modifications, QList<NorPatch::Range> *dirtyRanges); 
 };
 
 #endif // BACKEND_H
@@ -0,0 +1,228 @@
+#include "databasedownloader.h"
+#include "tracer.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QSaveFile>
+#include <QtGlobal>
+
+namespace {
+
+constexpr char kDefaultUrl[] = "http://uartcodes.com/xml.php"; // Same URL as in C#
+constexpr char kUrlEnvironmentVariable[] = "PS5NOR_DATABASE_URL";
+
+} // namespace
+
+DatabaseDownloader::DatabaseDownloader(QNetworkAccessManager *manager, QObject *parent)
+    : QObject(parent), m_manager(manager)
+{
+    qRegisterMetaType<DatabaseDownloader::Result>();
+}
+
+DatabaseDownloader::~DatabaseDownloader()
+{
+    if (m_reply) {
+        m_reply->disconnect(this);
+        m_reply->abort();
+        m_reply->deleteLater();
+    }
+    // m_file discards its temporary file if it was never committed
+}
+
+QUrl DatabaseDownloader::defaultUrl()
+{
+    const QString overridden = qEnvironmentVariable(kUrlEnvironmentVariable);
+    return QUrl(overridden.isEmpty() ? QString::fromLatin1(kDefaultUrl) : overridden);
+}
+
+QString DatabaseDownloader::metadataPath(const QString &xmlPath)
+{
+    return xmlPath + ".meta";
+}
+
+void DatabaseDownloader::start(const QUrl &url, const QString &destinationPath)
+{
+    abort();
+    m_destinationPath = destinationPath;
+    m_bytesReceived = 0;
+    m_writeFailed = false;
+    m_hash.reset();
+
+    // Validators only count while the file they describe is still there
+    m_previous = Metadata();
+    if (QFile::exists(destinationPath)) {
+        m_previous = readMetadata(destinationPath);
+    }
+
+    QNetworkRequest request(url);
+    if (m_previous.url == url.toString()) {
+        if (!m_previous.etag.isEmpty()) {
+            request.setRawHeader("If-None-Match", m_previous.etag);
+        }
+        if (!m_previous.lastModified.isEmpty()) {
+            request.setRawHeader("If-Modified-Since", m_previous.lastModified);
+        }
+    }
+
+    QDir().mkpath(QFileInfo(destinationPath).absolutePath());
+    m_file = std::make_unique<QSaveFile>(destinationPath);
+    if (!m_file->open(QIODevice::WriteOnly)) {
+        const QString error = m_file->errorString();
+        m_file.reset();
+        emit finished({ Outcome::Failed, 0, error });
+        return;
+    }
+
+    m_traceStartNs = Tracer::isEnabled() ? Tracer::now() : -1;
+    m_reply = m_manager->get(request);
+    connect(m_reply, &QNetworkReply::readyRead, this, &DatabaseDownloader::onReadyRead);
+    connect(m_reply, &QNetworkReply::downloadProgress, this, &DatabaseDownloader::progress);
+    connect(m_reply, &QNetworkReply::finished, this, &DatabaseDownloader::onFinished);
+}
+
+void DatabaseDownloader::abort()
+{
+    if (m_reply) {
+        m_reply->disconnect(this);
+        m_reply->abort();
+        m_reply->deleteLater();
+        m_reply.clear();
+    }
+    m_file.reset();
+}
+
+void DatabaseDownloader::onReadyRead()
+{
+    // Only a full 200 body replaces the database; anything else is drained and dropped
+    const int status = m_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    const QByteArray chunk = m_reply->readAll();
+    if (status != 200 || m_writeFailed) {
+        return;
+    }
+    m_bytesReceived += chunk.size();
+    m_hash.addData(chunk);
+    if (m_file->write(chunk) != chunk.size()) {
+        m_writeFailed = true;
+        m_reply->abort(); // Reported from onFinished
+    }
+}
+
+void DatabaseDownloader::onFinished()
+{
+    if (m_writeFailed) {
+        finish(Outcome::Failed, "Could not save database file: " + m_file->errorString());
+        return;
+    }
+    if (m_reply->error() != QNetworkReply::NoError) {
+        finish(Outcome::Failed, "Error downloading database: " + m_reply->errorString());
+        return;
+    }
+    onReadyRead(); // Whatever arrived after the last readyRead
+
+    Metadata metadata;
+    metadata.url = m_reply->request().url().toString(); // Not a redirect target
+    metadata.etag = m_reply->rawHeader("ETag");
+    metadata.lastModified = m_reply->rawHeader("Last-Modified");
+
+    const int status = m_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (status == 304) {
+        metadata.sha256 = m_previous.sha256;
+        if (metadata.etag.isEmpty()) {
+            metadata.etag = m_previous.etag;
+        }
+        if (metadata.lastModified.isEmpty()) {
+            metadata.lastModified = m_previous.lastModified;
+        }
+        writeMetadata(m_destinationPath, metadata);
+        finish(Outcome::Unchanged);
+        return;
+    }
+    if (status != 200) {
+        finish(Outcome::Failed, QString("Unexpected HTTP status %1").arg(status));
+        return;
+    }
+    if (m_bytesReceived == 0) {
+        finish(Outcome::Failed, "The server returned an empty database.");
+        return;
+    }
+    metadata.sha256 = m_hash.result().toHex();
+
+    // Servers without validators still send the full body; identical bytes leave the
+    // file, its mtime and therefore the error index alone. The file on disk is hashed
+    // rather than trusting the sidecar, in case it was edited by hand.
+    if (QFile::exists(m_destinationPath) && fileSha256(m_destinationPath) == metadata.sha256) {
+        writeMetadata(m_destinationPath, metadata);
+        finish(Outcome::Unchanged);
+        return;
+    }
+
+    if (!m_file->commit()) {
+        finish(Outcome::Failed, "Could not save database file: " + m_file->errorString());
+        return;
+    }
+    writeMetadata(m_destinationPath, metadata);
+    finish(Outcome::Updated);
+}
+
+void DatabaseDownloader::finish(Outcome outcome, const QString &errorString)
+{
+    const Result result { outcome, m_bytesReceived, errorString };
+    if (m_traceStartNs >= 0) {
+        Tracer::instance().complete("databaseDownload", "network", m_traceStartNs);
+        m_traceStartNs = -1;
+    }
+    if (m_reply) {
+        m_reply->disconnect(this);
+        m_reply->deleteLater();
+        m_reply.clear();
+    }
+    m_file.reset(); // Uncommitted: the temporary file is removed, the destination untouched
+    emit finished(result);
+}
+
+DatabaseDownloader::Metadata DatabaseDownloader::readMetadata(const QString &xmlPath)
+{
+    Metadata metadata;
+    QFile file(metadataPath(xmlPath));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return metadata;
+    }
+    const QJsonObject object = QJsonDocument::fromJson(file.readAll()).object();
+    metadata.url = object.value("url").toString();
+    metadata.etag = object.value("etag").toString().toLatin1();
+    metadata.lastModified = object.value("lastModified").toString().toLatin1();
+    metadata.sha256 = object.value("sha256").toString().toLatin1();
+    return metadata;
+}
+
+bool DatabaseDownloader::writeMetadata(const QString &xmlPath, const Metadata &metadata)
+{
+    QJsonObject object;
+    object.insert("url", metadata.url);
+    object.insert("etag", QString::fromLatin1(metadata.etag));
+    object.insert("lastModified", QString::fromLatin1(metadata.lastModified));
+    object.insert("sha256", QString::fromLatin1(metadata.sha256));
+
+    QSaveFile file(metadataPath(xmlPath));
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    file.write(QJsonDocument(object).toJson());
+    return file.commit();
+}
+
+QByteArray DatabaseDownloader::fileSha256(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    hash.addData(&file);
+    return hash.result().toHex();
+}
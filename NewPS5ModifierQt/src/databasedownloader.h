@@ -0,0 +1,83 @@
+#ifndef DATABASEDOWNLOADER_H
+#define DATABASEDOWNLOADER_H
+
+#include <QByteArray>
+#include <QCryptographicHash>
+#include <QObject>
+#include <QPointer>
+#include <QString>
+#include <QUrl>
+#include <memory>
+
+class QNetworkAccessManager;
+class QNetworkReply;
+class QSaveFile;
+
+// Fetches errorDB.xml. The body is streamed into a QSaveFile next to the destination
+// and hashed on the way in; the destination is only replaced (atomically, by rename)
+// when the content differs from what is on disk. The ETag / Last-Modified of the last
+// download are kept in a small JSON sidecar (errorDB.xml.meta) and sent back as
+// If-None-Match / If-Modified-Since, so an unchanged database costs a single 304.
+class DatabaseDownloader : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class Outcome {
+        Updated,   // Destination replaced with new content
+        Unchanged, // 304, or the same bytes as before; destination untouched
+        Failed
+    };
+
+    struct Result {
+        Outcome outcome = Outcome::Failed;
+        qint64 bytesReceived = 0;
+        QString errorString;
+    };
+
+    explicit DatabaseDownloader(QNetworkAccessManager *manager, QObject *parent = nullptr);
+    ~DatabaseDownloader() override;
+
+    // uartcodes.com, unless PS5NOR_DATABASE_URL points somewhere else (e.g. a local test server).
+    static QUrl defaultUrl();
+    static QString metadataPath(const QString &xmlPath);
+
+    bool isRunning() const { return !m_reply.isNull(); }
+
+    void start(const QUrl &url, const QString &destinationPath);
+    void abort();
+
+signals:
+    void progress(qint64 bytesReceived, qint64 bytesTotal);
+    void finished(const DatabaseDownloader::Result &result);
+
+private:
+    struct Metadata {
+        QString url;
+        QByteArray etag;
+        QByteArray lastModified;
+        QByteArray sha256; // Hex
+    };
+
+    static Metadata readMetadata(const QString &xmlPath);
+    static bool writeMetadata(const QString &xmlPath, const Metadata &metadata);
+    static QByteArray fileSha256(const QString &path);
+
+    void onReadyRead();
+    void onFinished();
+    void finish(Outcome outcome, const QString &errorString = QString());
+
+    QNetworkAccessManager *m_manager;
+    QPointer<QNetworkReply> m_reply;
+    std::unique_ptr<QSaveFile> m_file;
+    QCryptographicHash m_hash { QCryptographicHash::Sha256 };
+    QString m_destinationPath;
+    Metadata m_previous;
+    qint64 m_bytesReceived = 0;
+    bool m_writeFailed = false;
+    qint64 m_traceStartNs = -1; // Set while tracing
+};
+
+Q_DECLARE_METATYPE(DatabaseDownloader::Result)
+
+#endif // DATABASEDOWNLOADER_H
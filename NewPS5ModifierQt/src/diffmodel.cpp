@@ -0,0 +1,147 @@
+#include "diffmodel.h"
+#include "hexcodec.h"
+#include "norimage.h"
+#include <algorithm>
+
+DiffModel::DiffModel(QObject *parent) : QAbstractListModel(parent)
+{
+}
+
+void DiffModel::setResult(NorDiff::Result result, const NorImage *a, const NorImage *b)
+{
+    beginResetModel();
+    m_result = std::move(result);
+    m_a = a;
+    m_b = b;
+    endResetModel();
+    emit resultChanged();
+}
+
+void DiffModel::clear()
+{
+    if (!m_a && m_result.regions.isEmpty()) {
+        return;
+    }
+    setResult(NorDiff::Result(), nullptr, nullptr);
+}
+
+bool DiffModel::updateRange(qint64 offset, qint64 length)
+{
+    NorDiff::Update update;
+    if (!m_a || !m_b || !NorDiff::rediff(m_result, m_a->view(), m_b->view(), offset, length, &update)) {
+        return false;
+    }
+    if (update.isEmpty()) {
+        return true;
+    }
+
+    // Rows both before and after the edit change in place; only the difference is removed or inserted
+    const int first = int(update.first);
+    const int kept = int(std::min(update.removed, update.regions.size()));
+    const int removed = int(update.removed) - kept;
+    const int inserted = int(update.regions.size()) - kept;
+    if (removed > 0) {
+        beginRemoveRows(QModelIndex(), first + kept, first + kept + removed - 1);
+    } else if (inserted > 0) {
+        beginInsertRows(QModelIndex(), first + kept, first + kept + inserted - 1);
+    }
+    NorDiff::apply(m_result, update);
+    if (removed > 0) {
+        endRemoveRows();
+    } else if (inserted > 0) {
+        endInsertRows();
+    }
+    if (kept > 0) {
+        emit dataChanged(index(first), index(first + kept - 1));
+    }
+    emit resultChanged();
+    return true;
+}
+
+QString DiffModel::summary() const
+{
+    if (!m_a) {
+        return QString();
+    }
+    if (m_result.identical()) {
+        return QString("Identical (%1 bytes)").arg(m_result.sizeA);
+    }
+    QString text = QString("%1 bytes differ in %2 regions").arg(m_result.differingBytes).arg(count());
+    if (m_result.truncated) {
+        text += " (list truncated)";
+    }
+    if (m_result.sizeA != m_result.sizeB) {
+        text += QString(", sizes %1 / %2 bytes").arg(m_result.sizeA).arg(m_result.sizeB);
+    }
+    return text;
+}
+
+int DiffModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : count();
+}
+
+QVariant DiffModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= count()) {
+        return QVariant();
+    }
+
+    const NorDiff::Region &region = m_result.regions.at(index.row());
+    switch (role) {
+    case OffsetRole:
+        return region.offset;
+    case Qt::DisplayRole:
+    case OffsetTextRole:
+        return QString::number(region.offset, 16).toUpper().rightJustified(8, '0'); // As in the hex view
+    case LengthRole:
+        return region.length;
+    case DifferingBytesRole:
+        return region.differingBytes;
+    case FieldsRole:
+        return NorDiff::describeFields(region.fields);
+    case KindRole:
+        switch (region.kind) {
+        case NorDiff::RegionKind::OnlyInA:
+            return QStringLiteral("onlyInA");
+        case NorDiff::RegionKind::OnlyInB:
+            return QStringLiteral("onlyInB");
+        default:
+            return QStringLiteral("changed");
+        }
+    case BytesARole:
+        return preview(m_a, region);
+    case BytesBRole:
+        return preview(m_b, region);
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> DiffModel::roleNames() const
+{
+    return {
+        { OffsetRole, "offset" },
+        { OffsetTextRole, "offsetText" },
+        { LengthRole, "length" },
+        { DifferingBytesRole, "differingBytes" },
+        { FieldsRole, "fields" },
+        { KindRole, "kind" },
+        { BytesARole, "bytesA" },
+        { BytesBRole, "bytesB" }
+    };
+}
+
+QString DiffModel::preview(const NorImage *image, const NorDiff::Region &region)
+{
+    if (!image || region.offset >= image->size()) {
+        return QString();
+    }
+    const QByteArrayView bytes = image->view(region.offset, qMin<qint64>(region.length, PreviewBytes));
+    QByteArray text(qsizetype(HexCodec::encodedLength(bytes.size())), Qt::Uninitialized);
+    HexCodec::encode(reinterpret_cast<const unsigned char *>(bytes.data()), bytes.size(), text.data());
+    if (region.length > PreviewBytes) {
+        text += " ...";
+    }
+    return QString::fromLatin1(text);
+}
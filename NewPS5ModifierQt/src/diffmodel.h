@@ -0,0 +1,64 @@
+#ifndef DIFFMODEL_H
+#define DIFFMODEL_H
+
+#include "nordiff.h"
+#include <QAbstractListModel>
+#include <QByteArray>
+#include <QHash>
+
+class NorImage;
+
+// Differing regions between the open dump (A) and a comparison dump (B) for QML,
+// one row per NorDiff::Region. The byte previews are read from the images on demand.
+class DiffModel : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(int count READ count NOTIFY resultChanged)
+    Q_PROPERTY(bool active READ isActive NOTIFY resultChanged)
+    Q_PROPERTY(QString summary READ summary NOTIFY resultChanged)
+
+public:
+    enum Roles {
+        OffsetRole = Qt::UserRole + 1,
+        OffsetTextRole,
+        LengthRole,
+        DifferingBytesRole,
+        FieldsRole,
+        KindRole,
+        BytesARole,
+        BytesBRole
+    };
+
+    // Bytes shown per side in the bytesA / bytesB roles
+    static constexpr int PreviewBytes = 16;
+
+    explicit DiffModel(QObject *parent = nullptr);
+
+    // The model does not own the images; call clear() before either goes away.
+    void setResult(NorDiff::Result result, const NorImage *a, const NorImage *b);
+    void clear();
+    // Re-diffs just the bytes edited in either image and updates the rows in place, so
+    // the view keeps its position. False when a full setResult() is needed instead.
+    bool updateRange(qint64 offset, qint64 length);
+
+    const NorDiff::Result &result() const { return m_result; }
+    int count() const { return int(m_result.regions.size()); }
+    bool isActive() const { return m_a != nullptr; }
+    QString summary() const;
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+signals:
+    void resultChanged();
+
+private:
+    static QString preview(const NorImage *image, const NorDiff::Region &region);
+
+    NorDiff::Result m_result;
+    const NorImage *m_a = nullptr;
+    const NorImage *m_b = nullptr;
+};
+
+#endif // DIFFMODEL_H
@@ -0,0 +1,300 @@
+#include "errordatabaseindex.h"
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QXmlStreamReader>
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+// Sidecar layout: Header, entryCount Entries sorted by key, then the UTF-8 string pool.
+// Written in native byte order; it is a local cache, a foreign one fails the byteOrder check.
+struct ErrorDatabaseIndex::Header {
+    char magic[8];
+    quint32 version;
+    quint32 byteOrder;
+    quint32 entryCount;
+    quint32 reserved;
+    qint64 xmlSize;
+    qint64 xmlModified; // msecs since epoch
+    quint8 xmlSha1[20];
+    quint32 reserved2;
+    quint64 stringsOffset;
+    quint64 stringsSize;
+};
+
+struct ErrorDatabaseIndex::Entry {
+    quint64 key;
+    quint32 codeOffset;
+    quint32 codeLength;
+    quint32 descriptionOffset;
+    quint32 descriptionLength;
+};
+
+namespace {
+
+constexpr char kMagic[8] = { 'P', 'S', '5', 'E', 'I', 'D', 'X', '\0' };
+constexpr quint32 kVersion = 1;
+constexpr quint32 kByteOrderMark = 0x01020304;
+constexpr quint64 kHashedKeyBit = Q_UINT64_C(1) << 63;
+
+bool fail(QString *errorString, const QString &message)
+{
+    if (errorString) {
+        *errorString = message;
+    }
+    return false;
+}
+
+QByteArray sha1Of(const QByteArray &data)
+{
+    return QCryptographicHash::hash(data, QCryptographicHash::Sha1);
+}
+
+QByteArray sha1OfFile(const QString &path)
+{
+    QFile file(path);
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    if (!file.open(QIODevice::ReadOnly) || !hash.addData(&file)) {
+        return QByteArray();
+    }
+    return hash.result();
+}
+
+} // namespace
+
+QString ErrorDatabaseIndex::sidecarPath(const QString &xmlPath)
+{
+    return xmlPath + ".idx";
+}
+
+quint64 ErrorDatabaseIndex::keyForCode(QStringView code)
+{
+    code = code.trimmed();
+    QStringView digits = code;
+    if (digits.startsWith(QLatin1String("0x"), Qt::CaseInsensitive)) {
+        digits = digits.mid(2);
+    }
+    if (!digits.isEmpty() && digits.size() <= 15 && digits.front() != u'+' && digits.front() != u'-') {
+        bool ok = false;
+        const quint64 value = digits.toULongLong(&ok, 16);
+        if (ok) {
+            return value;
+        }
+    }
+    quint64 hash = Q_UINT64_C(14695981039346656037); // FNV-1a over the upper-cased code
+    for (QChar c : code) {
+        hash = (hash ^ c.toUpper().unicode()) * Q_UINT64_C(1099511628211);
+    }
+    return hash | kHashedKeyBit;
+}
+
+const ErrorDatabaseIndex::Header *ErrorDatabaseIndex::header() const
+{
+    return reinterpret_cast<const Header *>(m_data);
+}
+
+const ErrorDatabaseIndex::Entry *ErrorDatabaseIndex::entries() const
+{
+    return reinterpret_cast<const Entry *>(m_data + sizeof(Header));
+}
+
+int ErrorDatabaseIndex::count() const
+{
+    return m_data ? int(header()->entryCount) : 0;
+}
+
+void ErrorDatabaseIndex::clear()
+{
+    m_file.reset();
+    m_ownedData.clear();
+    m_data = nullptr;
+    m_size = 0;
+    m_xmlPath.clear();
+}
+
+bool ErrorDatabaseIndex::adopt(const uchar *data, qint64 size)
+{
+    if (size < qint64(sizeof(Header))) {
+        return false;
+    }
+    const Header *h = reinterpret_cast<const Header *>(data);
+    if (std::memcmp(h->magic, kMagic, sizeof(kMagic)) != 0 || h->version != kVersion || h->byteOrder != kByteOrderMark) {
+        return false;
+    }
+    const quint64 entriesEnd = sizeof(Header) + quint64(h->entryCount) * sizeof(Entry);
+    if (h->stringsOffset < entriesEnd || h->stringsOffset + h->stringsSize > quint64(size)) {
+        return false;
+    }
+    m_data = data;
+    m_size = size;
+    return true;
+}
+
+bool ErrorDatabaseIndex::isCurrent() const
+{
+    if (!m_data) {
+        return false;
+    }
+    const QFileInfo xml(m_xmlPath);
+    return xml.exists() && xml.size() == header()->xmlSize
+        && xml.lastModified().toMSecsSinceEpoch() == header()->xmlModified;
+}
+
+bool ErrorDatabaseIndex::load(const QString &xmlPath, QString *errorString)
+{
+    clear();
+    const QFileInfo xml(xmlPath);
+    if (!xml.exists()) {
+        return fail(errorString, "Database file not found.");
+    }
+
+    auto file = std::make_unique<QFile>(sidecarPath(xmlPath));
+    if (file->open(QIODevice::ReadOnly) && file->size() >= qint64(sizeof(Header))) {
+        const qint64 size = file->size();
+        const uchar *data = file->map(0, size);
+        if (data && adopt(data, size)) {
+            const qint64 modified = xml.lastModified().toMSecsSinceEpoch();
+            bool current = header()->xmlSize == xml.size() && header()->xmlModified == modified;
+            if (!current && header()->xmlSize == xml.size()) {
+                // Touched but maybe not changed (copied, restored from backup): compare content
+                const QByteArray sha1 = sha1OfFile(xmlPath);
+                current = sha1.size() == qsizetype(sizeof(Header::xmlSha1))
+                    && std::memcmp(sha1.constData(), header()->xmlSha1, sha1.size()) == 0;
+                QFile update(file->fileName());
+                if (current && update.open(QIODevice::ReadWrite) && update.seek(offsetof(Header, xmlModified))) {
+                    update.write(reinterpret_cast<const char *>(&modified), sizeof(modified));
+                }
+            }
+            if (current) {
+                m_file = std::move(file);
+                m_xmlPath = xmlPath;
+                return true;
+            }
+        }
+        m_data = nullptr;
+        m_size = 0;
+    }
+    return rebuild(xmlPath, errorString);
+}
+
+bool ErrorDatabaseIndex::rebuild(const QString &xmlPath, QString *errorString)
+{
+    clear();
+    QFile file(xmlPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return fail(errorString, file.errorString());
+    }
+    const QFileInfo info(file);
+    const QByteArray content = file.readAll();
+    file.close();
+
+    struct Pending {
+        quint64 key;
+        QByteArray code;
+        QByteArray description;
+    };
+    std::vector<Pending> pending;
+
+    // Same structure the old streaming lookup expected: <errorCode><ErrorCode/><Description/></errorCode>
+    QXmlStreamReader xml(content);
+    while (!xml.atEnd() && !xml.hasError()) {
+        if (xml.readNext() != QXmlStreamReader::StartElement || xml.name() != QLatin1String("errorCode")) {
+            continue;
+        }
+        QString code;
+        QString description;
+        while (xml.readNextStartElement()) {
+            if (xml.name() == QLatin1String("ErrorCode")) {
+                code = xml.readElementText().trimmed();
+            } else if (xml.name() == QLatin1String("Description")) {
+                description = xml.readElementText();
+            } else {
+                xml.skipCurrentElement();
+            }
+        }
+        if (!code.isEmpty()) {
+            pending.push_back({ keyForCode(code), code.toUtf8(), description.toUtf8() });
+        }
+    }
+    if (xml.hasError()) {
+        return fail(errorString, xml.errorString());
+    }
+
+    // Stable, so the first of duplicated codes wins like it did with the linear scan
+    std::stable_sort(pending.begin(), pending.end(), [](const Pending &a, const Pending &b) { return a.key < b.key; });
+
+    Header h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, kMagic, sizeof(kMagic));
+    h.version = kVersion;
+    h.byteOrder = kByteOrderMark;
+    h.entryCount = quint32(pending.size());
+    h.xmlSize = info.size();
+    h.xmlModified = info.lastModified().toMSecsSinceEpoch();
+    const QByteArray sha1 = sha1Of(content);
+    std::memcpy(h.xmlSha1, sha1.constData(), sizeof(h.xmlSha1));
+    h.stringsOffset = sizeof(Header) + pending.size() * sizeof(Entry);
+
+    QByteArray strings;
+    QByteArray entryBytes(qsizetype(pending.size() * sizeof(Entry)), Qt::Uninitialized);
+    Entry *entry = reinterpret_cast<Entry *>(entryBytes.data());
+    for (const Pending &p : pending) {
+        entry->key = p.key;
+        entry->codeOffset = quint32(strings.size());
+        entry->codeLength = quint32(p.code.size());
+        strings += p.code;
+        entry->descriptionOffset = quint32(strings.size());
+        entry->descriptionLength = quint32(p.description.size());
+        strings += p.description;
+        ++entry;
+    }
+    h.stringsSize = quint64(strings.size());
+
+    m_ownedData.reserve(qsizetype(h.stringsOffset + h.stringsSize));
+    m_ownedData.append(reinterpret_cast<const char *>(&h), sizeof(h));
+    m_ownedData.append(entryBytes);
+    m_ownedData.append(strings);
+
+    // A missing sidecar only costs the next startup a rebuild, so write errors are not fatal
+    QSaveFile sidecar(sidecarPath(xmlPath));
+    if (sidecar.open(QIODevice::WriteOnly)) {
+        sidecar.write(m_ownedData);
+        sidecar.commit();
+    }
+
+    adopt(reinterpret_cast<const uchar *>(m_ownedData.constData()), m_ownedData.size());
+    m_xmlPath = xmlPath;
+    return true;
+}
+
+bool ErrorDatabaseIndex::lookup(QStringView code, QString *description) const
+{
+    if (!m_data) {
+        return false;
+    }
+    const quint64 key = keyForCode(code);
+    const Entry *begin = entries();
+    const Entry *end = begin + header()->entryCount;
+    const Entry *it = std::lower_bound(begin, end, key, [](const Entry &e, quint64 k) { return e.key < k; });
+
+    const char *strings = reinterpret_cast<const char *>(m_data + header()->stringsOffset);
+    const quint64 stringsSize = header()->stringsSize;
+    for (; it != end && it->key == key; ++it) {
+        if (quint64(it->codeOffset) + it->codeLength > stringsSize
+            || quint64(it->descriptionOffset) + it->descriptionLength > stringsSize) {
+            return false; // Corrupt sidecar
+        }
+        // Numeric keys are exact; hashed ones may collide, so confirm the text
+        if (!(key & kHashedKeyBit)
+            || QString::fromUtf8(strings + it->codeOffset, it->codeLength).compare(code.trimmed(), Qt::CaseInsensitive) == 0) {
+            if (description) {
+                *description = QString::fromUtf8(strings + it->descriptionOffset, it->descriptionLength);
+            }
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,56 @@
+#ifndef ERRORDATABASEINDEX_H
+#define ERRORDATABASEINDEX_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QStringView>
+#include <memory>
+
+// Lookup index over errorDB.xml. The XML is parsed once into an array of entries
+// sorted by numeric error code, which is written next to it as a binary sidecar
+// (errorDB.xml.idx) and memory-mapped on later runs. The sidecar records the XML's
+// size, mtime and SHA-1, so an edited or re-downloaded database is re-indexed.
+class ErrorDatabaseIndex
+{
+public:
+    ErrorDatabaseIndex() = default;
+
+    ErrorDatabaseIndex(const ErrorDatabaseIndex &) = delete;
+    ErrorDatabaseIndex &operator=(const ErrorDatabaseIndex &) = delete;
+
+    // Maps the sidecar if it still describes xmlPath, otherwise rebuilds it.
+    bool load(const QString &xmlPath, QString *errorString = nullptr);
+    // Parses xmlPath and replaces the sidecar.
+    bool rebuild(const QString &xmlPath, QString *errorString = nullptr);
+    void clear();
+
+    bool isLoaded() const { return m_data != nullptr; }
+    // True while the XML on disk has the size and mtime the index was built from.
+    bool isCurrent() const;
+    QString xmlPath() const { return m_xmlPath; }
+    int count() const;
+
+    bool lookup(QStringView code, QString *description) const;
+
+    static QString sidecarPath(const QString &xmlPath);
+    // Hex codes ("80810001", "0x80810001") map to their value, anything else to a
+    // tagged hash of the upper-cased code.
+    static quint64 keyForCode(QStringView code);
+
+private:
+    struct Header;
+    struct Entry;
+
+    bool adopt(const uchar *data, qint64 size);
+    const Header *header() const;
+    const Entry *entries() const;
+
+    std::unique_ptr<QFile> m_file; // Sidecar mapping
+    QByteArray m_ownedData;        // Freshly built index, used until the next load() maps the sidecar
+    const uchar *m_data = nullptr;
+    qint64 m_size = 0;
+    QString m_xmlPath;
+};
+
+#endif // ERRORDATABASEINDEX_H
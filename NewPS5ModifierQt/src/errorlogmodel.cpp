@@ -0,0 +1,161 @@
+#include "errorlogmodel.h"
+#include <QVarLengthArray>
+
+namespace {
+
+// Drops the ":XX" checksum the console appends to the last word of a line
+QStringView stripChecksum(QStringView word)
+{
+    const qsizetype colon = word.indexOf(u':');
+    return colon >= 0 ? word.left(colon) : word;
+}
+
+} // namespace
+
+ErrorLogModel::ErrorLogModel(QObject *parent) : QAbstractListModel(parent)
+{
+}
+
+QList<ErrorLogEntry> ErrorLogModel::parse(QStringView raw)
+{
+    QList<ErrorLogEntry> entries;
+    int slot = -1;
+
+    for (QStringView line : raw.tokenize(u'\n')) {
+        QVarLengthArray<QStringView, 16> words;
+        for (QStringView word : line.tokenize(u' ', Qt::SkipEmptyParts)) {
+            word = word.trimmed(); // \r and tabs
+            if (!word.isEmpty()) {
+                words.append(word);
+            }
+        }
+
+        for (qsizetype i = 0; i < words.size(); ++i) {
+            if (words[i] == QLatin1String("errlog") && i + 1 < words.size()) {
+                bool ok = false;
+                const int n = stripChecksum(words[i + 1]).toInt(&ok);
+                if (ok) {
+                    slot = n; // Echo or "Cmd: errlog N" line: following responses belong to slot N
+                }
+                ++i;
+                continue;
+            }
+            if (words[i] != QLatin1String("OK") || i + 2 >= words.size()) {
+                continue; // NG lines carry no code
+            }
+
+            const qsizetype last = words.size() - 1;
+            const QString code = stripChecksum(words[i + 2]).toString().toUpper();
+            if (code.isEmpty() || code == QLatin1String("FFFFFFFF")) {
+                break;
+            }
+            ErrorLogEntry entry;
+            entry.slot = slot;
+            entry.code = code;
+            if (i + 3 <= last) {
+                entry.rtc = (i + 3 == last ? stripChecksum(words[i + 3]) : words[i + 3]).toString();
+            }
+            for (qsizetype f = i + 4; f <= last; ++f) {
+                const QStringView field = f == last ? stripChecksum(words[f]) : words[f];
+                if (field.isEmpty()) {
+                    continue;
+                }
+                if (!entry.fields.isEmpty()) {
+                    entry.fields += u' ';
+                }
+                entry.fields += field;
+            }
+            entries.append(entry);
+            break;
+        }
+    }
+    return entries;
+}
+
+void ErrorLogModel::resolve(QList<ErrorLogEntry> &entries,
+                            const std::function<bool(const QString &, QString *)> &lookup)
+{
+    struct Resolved {
+        QString description;
+        bool known = false;
+    };
+    QHash<QString, Resolved> resolved; // A console usually logs the same few codes repeatedly
+    for (ErrorLogEntry &entry : entries) {
+        auto it = resolved.find(entry.code);
+        if (it == resolved.end()) {
+            Resolved r;
+            r.known = lookup(entry.code, &r.description);
+            it = resolved.insert(entry.code, r);
+        }
+        entry.description = it->description;
+        entry.known = it->known;
+    }
+}
+
+void ErrorLogModel::setEntries(QList<ErrorLogEntry> entries)
+{
+    const bool countChanges = entries.size() != m_entries.size();
+    beginResetModel();
+    m_entries = std::move(entries);
+    endResetModel();
+    if (countChanges) {
+        emit countChanged();
+    }
+}
+
+void ErrorLogModel::appendEntries(const QList<ErrorLogEntry> &entries)
+{
+    if (entries.isEmpty()) {
+        return;
+    }
+    beginInsertRows(QModelIndex(), count(), count() + int(entries.size()) - 1);
+    m_entries.append(entries);
+    endInsertRows();
+    emit countChanged();
+}
+
+int ErrorLogModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : count();
+}
+
+QVariant ErrorLogModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= count()) {
+        return QVariant();
+    }
+
+    const ErrorLogEntry &entry = m_entries.at(index.row());
+    switch (role) {
+    case SlotRole:
+        return entry.slot;
+    case Qt::DisplayRole:
+    case CodeRole:
+        return entry.code;
+    case RtcRole:
+        return entry.rtc;
+    case FieldsRole:
+        return entry.fields;
+    case DescriptionRole:
+        return entry.description;
+    case KnownRole:
+        return entry.known;
+    case SourceRole:
+        return entry.source;
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> ErrorLogModel::roleNames() const
+{
+    return {
+        { SlotRole, "slot" },
+        { CodeRole, "code" },
+        { RtcRole, "rtc" },
+        { FieldsRole, "fields" },
+        { DescriptionRole, "description" },
+        { KnownRole, "known" },
+        { SourceRole, "source" }
+    };
+}
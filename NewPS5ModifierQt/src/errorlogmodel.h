@@ -0,0 +1,69 @@
+#ifndef ERRORLOGMODEL_H
+#define ERRORLOGMODEL_H
+
+#include <QAbstractListModel>
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringView>
+#include <functional>
+
+// One "OK" line of an errlog response:
+// OK <status> <code> <rtc> <power state> <up cause> <seq no> ... :<checksum>
+struct ErrorLogEntry {
+    int slot = -1;       // N of the "errlog N" command the line answered, -1 if unknown
+    QString code;        // Upper case, e.g. "80810001"
+    QString rtc;         // Raw RTC timestamp word
+    QString fields;      // Remaining words (power state, up cause, sequence, temperatures)
+    QString description;
+    bool known = false;  // Description came from the database
+    QString source;      // Port of the session it was read from, empty otherwise
+};
+
+// Decoded errlog dump for QML. parse() only tokenizes; descriptions are filled in
+// by the owner, which resolves each distinct code once.
+class ErrorLogModel : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+
+public:
+    enum Roles {
+        SlotRole = Qt::UserRole + 1,
+        CodeRole,
+        RtcRole,
+        FieldsRole,
+        DescriptionRole,
+        KnownRole,
+        SourceRole
+    };
+
+    explicit ErrorLogModel(QObject *parent = nullptr);
+
+    // Accepts raw UART output (echo lines included) as well as the text readAllErrorLogs()
+    // aggregates. "NG" lines and erased slots (code FFFFFFFF) are skipped.
+    static QList<ErrorLogEntry> parse(QStringView raw);
+
+    // Looks up every distinct code once through lookup and fills description/known.
+    static void resolve(QList<ErrorLogEntry> &entries,
+                        const std::function<bool(const QString &code, QString *description)> &lookup);
+
+    void setEntries(QList<ErrorLogEntry> entries);
+    // Adds entries at the end, e.g. one errlog slot at a time while a read is in progress.
+    void appendEntries(const QList<ErrorLogEntry> &entries);
+    const QList<ErrorLogEntry> &entries() const { return m_entries; }
+    int count() const { return int(m_entries.size()); }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+signals:
+    void countChanged();
+
+private:
+    QList<ErrorLogEntry> m_entries;
+};
+
+#endif // ERRORLOGMODEL_H
@@ -0,0 +1,472 @@
+#include "hexcodec.h"
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define HEXCODEC_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#if defined(__GNUC__) || defined(__clang__)
+#define HEXCODEC_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define HEXCODEC_TARGET_AVX2 // MSVC emits AVX2 intrinsics without per-function targets
+#endif
+#endif
+
+namespace HexCodec {
+namespace {
+
+constexpr char kDigits[] = "0123456789abcdef";
+
+// Decoding retries the SIMD block this many scalar tokens after it bailed out,
+// so irregular input (line breaks, odd spacing) does not pay for a failed probe per byte.
+constexpr int kScalarTokensBeforeRetry = 8;
+
+template <typename CharT>
+using DecodeBlock = std::size_t (*)(const CharT *in, std::size_t length, unsigned char *out, std::size_t *produced);
+using EncodeBlock = std::size_t (*)(const unsigned char *in, std::size_t length, char *out, char separator);
+
+struct Kernels {
+    Kernel kernel;
+    EncodeBlock encode;
+    DecodeBlock<char> decode8;
+    DecodeBlock<char16_t> decode16;
+};
+
+inline bool isHexSpace(char32_t c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+inline int hexValue(char32_t c)
+{
+    if (c - U'0' < 10u) {
+        return int(c - U'0');
+    }
+    const char32_t lower = c | 0x20u;
+    if (lower - U'a' < 6u) {
+        return int(lower - U'a' + 10);
+    }
+    return -1;
+}
+
+// Encodes in[start, length): two digits per byte, separator after every byte but the last.
+void encodeScalar(const unsigned char *in, std::size_t start, std::size_t length, char *out, char separator)
+{
+    for (std::size_t i = start; i < length; ++i) {
+        *out++ = kDigits[in[i] >> 4];
+        *out++ = kDigits[in[i] & 0x0F];
+        if (separator && i + 1 < length) {
+            *out++ = separator;
+        }
+    }
+}
+
+template <typename CharT>
+DecodeResult decodeWith(const CharT *in, std::size_t length, unsigned char *out, DecodeBlock<CharT> block)
+{
+    DecodeResult result;
+    std::size_t i = 0;
+    std::size_t o = 0;
+    int scalarTokens = 0;
+
+    while (i < length) {
+        // Blocks are only entered at byte boundaries, which is where this loop always is.
+        if (block && scalarTokens == 0) {
+            std::size_t produced = 0;
+            i += block(in + i, length - i, out + o, &produced);
+            o += produced;
+            if (i >= length) {
+                break;
+            }
+            scalarTokens = kScalarTokensBeforeRetry;
+        }
+        --scalarTokens;
+
+        const char32_t c = in[i];
+        if (isHexSpace(c)) {
+            ++i;
+            continue;
+        }
+        const int hi = hexValue(c);
+        if (hi < 0 || i + 1 >= length) {
+            result.errorOffset = std::ptrdiff_t(i);
+            break;
+        }
+        const int lo = hexValue(in[i + 1]);
+        if (lo < 0) {
+            // A separator between the two digits leaves the first one dangling
+            result.errorOffset = std::ptrdiff_t(isHexSpace(in[i + 1]) ? i : i + 1);
+            break;
+        }
+        out[o++] = static_cast<unsigned char>((hi << 4) | lo);
+        i += 2;
+    }
+
+    result.bytesWritten = o;
+    return result;
+}
+
+#ifdef HEXCODEC_X86
+
+// ---- SSE2 -----------------------------------------------------------------
+
+inline __m128i load16(const char *p)
+{
+    return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+}
+
+// Narrows 16 UTF-16 units to bytes; anything above 0xFF saturates to a non-hex byte.
+inline __m128i load16(const char16_t *p)
+{
+    return _mm_packus_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p)),
+                            _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 8)));
+}
+
+inline __m128i asciiFromNibbles(__m128i n)
+{
+    const __m128i alpha = _mm_and_si128(_mm_cmpgt_epi8(n, _mm_set1_epi8(9)), _mm_set1_epi8('a' - '0' - 10));
+    return _mm_add_epi8(_mm_add_epi8(n, _mm_set1_epi8('0')), alpha);
+}
+
+// Returns the nibble value of every byte and sets valid to 0xFF where the byte is a hex digit.
+inline __m128i nibblesFromAscii(__m128i c, __m128i &valid)
+{
+    const __m128i isDigit = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('0' - 1)),
+                                          _mm_cmplt_epi8(c, _mm_set1_epi8('9' + 1)));
+    const __m128i lower = _mm_or_si128(c, _mm_set1_epi8(0x20));
+    const __m128i isAlpha = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+                                          _mm_cmplt_epi8(lower, _mm_set1_epi8('f' + 1)));
+    valid = _mm_or_si128(isDigit, isAlpha);
+    return _mm_or_si128(_mm_and_si128(isDigit, _mm_sub_epi8(c, _mm_set1_epi8('0'))),
+                        _mm_and_si128(isAlpha, _mm_sub_epi8(lower, _mm_set1_epi8('a' - 10))));
+}
+
+// Folds nibble pairs into one byte per 16-bit lane (first nibble is the high one).
+inline __m128i joinNibblePairs(__m128i n)
+{
+    const __m128i hi = _mm_slli_epi16(_mm_and_si128(n, _mm_set1_epi16(0x00FF)), 4);
+    return _mm_or_si128(hi, _mm_srli_epi16(n, 8));
+}
+
+std::size_t encodeSse2(const unsigned char *in, std::size_t length, char *out, char separator)
+{
+    const __m128i mask = _mm_set1_epi8(0x0F);
+    std::size_t i = 0;
+    if (!separator) {
+        for (; i + 16 <= length; i += 16) {
+            const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+            const __m128i hi = asciiFromNibbles(_mm_and_si128(_mm_srli_epi16(x, 4), mask));
+            const __m128i lo = asciiFromNibbles(_mm_and_si128(x, mask));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 2 * i), _mm_unpacklo_epi8(hi, lo));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 2 * i + 16), _mm_unpackhi_epi8(hi, lo));
+        }
+        return i;
+    }
+
+    // SSE2 has no byte shuffle for the 3-byte stride, so only the digit math is vectorized.
+    alignas(16) char dense[32];
+    for (; i + 16 < length; i += 16) {
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+        const __m128i hi = asciiFromNibbles(_mm_and_si128(_mm_srli_epi16(x, 4), mask));
+        const __m128i lo = asciiFromNibbles(_mm_and_si128(x, mask));
+        _mm_store_si128(reinterpret_cast<__m128i *>(dense), _mm_unpacklo_epi8(hi, lo));
+        _mm_store_si128(reinterpret_cast<__m128i *>(dense + 16), _mm_unpackhi_epi8(hi, lo));
+        char *o = out + 3 * i;
+        for (int b = 0; b < 16; ++b, o += 3) {
+            o[0] = dense[2 * b];
+            o[1] = dense[2 * b + 1];
+            o[2] = separator;
+        }
+    }
+    return i;
+}
+
+// Dense digit runs, 32 characters (16 bytes) per step.
+template <typename CharT>
+std::size_t decodeSse2(const CharT *in, std::size_t length, unsigned char *out, std::size_t *produced)
+{
+    std::size_t i = 0;
+    std::size_t o = 0;
+    for (; i + 32 <= length; i += 32, o += 16) {
+        __m128i valid0, valid1;
+        const __m128i n0 = nibblesFromAscii(load16(in + i), valid0);
+        const __m128i n1 = nibblesFromAscii(load16(in + i + 16), valid1);
+        if (_mm_movemask_epi8(_mm_and_si128(valid0, valid1)) != 0xFFFF) {
+            break;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + o),
+                         _mm_packus_epi16(joinNibblePairs(n0), joinNibblePairs(n1)));
+    }
+    *produced = o;
+    return i;
+}
+
+// ---- AVX2 -----------------------------------------------------------------
+
+HEXCODEC_TARGET_AVX2 inline __m256i asciiFromNibbles256(__m256i n)
+{
+    const __m256i alpha = _mm256_and_si256(_mm256_cmpgt_epi8(n, _mm256_set1_epi8(9)), _mm256_set1_epi8('a' - '0' - 10));
+    return _mm256_add_epi8(_mm256_add_epi8(n, _mm256_set1_epi8('0')), alpha);
+}
+
+HEXCODEC_TARGET_AVX2 inline __m256i nibblesFromAscii256(__m256i c, __m256i &valid)
+{
+    const __m256i isDigit = _mm256_and_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8('0' - 1)),
+                                             _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), c));
+    const __m256i lower = _mm256_or_si256(c, _mm256_set1_epi8(0x20));
+    const __m256i isAlpha = _mm256_and_si256(_mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)),
+                                             _mm256_cmpgt_epi8(_mm256_set1_epi8('f' + 1), lower));
+    valid = _mm256_or_si256(isDigit, isAlpha);
+    return _mm256_or_si256(_mm256_and_si256(isDigit, _mm256_sub_epi8(c, _mm256_set1_epi8('0'))),
+                           _mm256_and_si256(isAlpha, _mm256_sub_epi8(lower, _mm256_set1_epi8('a' - 10))));
+}
+
+HEXCODEC_TARGET_AVX2 inline __m256i joinNibblePairs256(__m256i n)
+{
+    const __m256i hi = _mm256_slli_epi16(_mm256_and_si256(n, _mm256_set1_epi16(0x00FF)), 4);
+    return _mm256_or_si256(hi, _mm256_srli_epi16(n, 8));
+}
+
+HEXCODEC_TARGET_AVX2 inline __m256i load32(const char *p)
+{
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+}
+
+HEXCODEC_TARGET_AVX2 inline __m256i load32(const char16_t *p)
+{
+    // packus works per 128-bit lane; the permute restores character order.
+    const __m256i packed = _mm256_packus_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)),
+                                               _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + 16)));
+    return _mm256_permute4x64_epi64(packed, 0xD8);
+}
+
+// Two 16 character windows, one per 128-bit lane.
+template <typename CharT>
+HEXCODEC_TARGET_AVX2 inline __m256i loadWindows(const CharT *first, const CharT *second)
+{
+    return _mm256_inserti128_si256(_mm256_castsi128_si256(load16(first)), load16(second), 1);
+}
+
+HEXCODEC_TARGET_AVX2 std::size_t encodeAvx2(const unsigned char *in, std::size_t length, char *out, char separator)
+{
+    std::size_t i = 0;
+    if (!separator) {
+        const __m256i mask = _mm256_set1_epi8(0x0F);
+        for (; i + 32 <= length; i += 32) {
+            const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i));
+            const __m256i hi = asciiFromNibbles256(_mm256_and_si256(_mm256_srli_epi16(x, 4), mask));
+            const __m256i lo = asciiFromNibbles256(_mm256_and_si256(x, mask));
+            const __m256i a = _mm256_unpacklo_epi8(hi, lo); // bytes 0-7  | 16-23
+            const __m256i b = _mm256_unpackhi_epi8(hi, lo); // bytes 8-15 | 24-31
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + 2 * i), _mm256_permute2x128_si256(a, b, 0x20));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + 2 * i + 32), _mm256_permute2x128_si256(a, b, 0x31));
+        }
+        return i;
+    }
+
+    // 16 bytes -> 32 dense digits -> three 16 character stores with the separator spliced in.
+    const __m128i mask = _mm_set1_epi8(0x0F);
+    const __m128i shuffle0 = _mm_setr_epi8(0, 1, -1, 2, 3, -1, 4, 5, -1, 6, 7, -1, 8, 9, -1, 10);
+    const __m128i shuffle1a = _mm_setr_epi8(11, -1, 12, 13, -1, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i shuffle1b = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, 0, 1, -1, 2, 3, -1, 4, 5);
+    const __m128i shuffle2 = _mm_setr_epi8(-1, 6, 7, -1, 8, 9, -1, 10, 11, -1, 12, 13, -1, 14, 15, -1);
+    const __m128i sep = _mm_set1_epi8(separator);
+    const __m128i sep0 = _mm_and_si128(sep, _mm_setr_epi8(0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0));
+    const __m128i sep1 = _mm_and_si128(sep, _mm_setr_epi8(0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0));
+    const __m128i sep2 = _mm_and_si128(sep, _mm_setr_epi8(-1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1));
+    for (; i + 16 < length; i += 16) {
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+        const __m128i hi = asciiFromNibbles(_mm_and_si128(_mm_srli_epi16(x, 4), mask));
+        const __m128i lo = asciiFromNibbles(_mm_and_si128(x, mask));
+        const __m128i d0 = _mm_unpacklo_epi8(hi, lo);
+        const __m128i d1 = _mm_unpackhi_epi8(hi, lo);
+        char *o = out + 3 * i;
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(o), _mm_or_si128(_mm_shuffle_epi8(d0, shuffle0), sep0));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(o + 16),
+                         _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(d0, shuffle1a), _mm_shuffle_epi8(d1, shuffle1b)), sep1));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(o + 32), _mm_or_si128(_mm_shuffle_epi8(d1, shuffle2), sep2));
+    }
+    return i;
+}
+
+// Dense runs (64 characters per step) and the "hh hh hh " layout QByteArray::toHex(' ')
+// produces (30 characters -> 10 bytes per step, five bytes per lane).
+template <typename CharT>
+HEXCODEC_TARGET_AVX2 std::size_t decodeAvx2(const CharT *in, std::size_t length, unsigned char *out, std::size_t *produced)
+{
+    const __m256i digitLanes = _mm256_setr_epi8(-1, -1, 0, -1, -1, 0, -1, -1, 0, -1, -1, 0, -1, -1, 0, 0,
+                                                -1, -1, 0, -1, -1, 0, -1, -1, 0, -1, -1, 0, -1, -1, 0, 0);
+    const __m256i spaceLanes = _mm256_setr_epi8(0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0,
+                                                0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0);
+    // The 16th character of each window belongs to the next byte and is checked by the next window.
+    const __m256i dontCare = _mm256_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -1,
+                                              0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -1);
+    const __m256i gather = _mm256_setr_epi8(0, 1, 3, 4, 6, 7, 9, 10, 12, 13, -1, -1, -1, -1, -1, -1,
+                                            0, 1, 3, 4, 6, 7, 9, 10, 12, 13, -1, -1, -1, -1, -1, -1);
+    const __m256i space = _mm256_set1_epi8(' ');
+
+    std::size_t i = 0;
+    std::size_t o = 0;
+    for (;;) {
+        if (i + 64 <= length) {
+            __m256i valid0, valid1;
+            const __m256i n0 = nibblesFromAscii256(load32(in + i), valid0);
+            const __m256i n1 = nibblesFromAscii256(load32(in + i + 32), valid1);
+            if (_mm256_movemask_epi8(_mm256_and_si256(valid0, valid1)) == -1) {
+                const __m256i packed = _mm256_packus_epi16(joinNibblePairs256(n0), joinNibblePairs256(n1));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + o), _mm256_permute4x64_epi64(packed, 0xD8));
+                i += 64;
+                o += 32;
+                continue;
+            }
+        }
+        if (i + 31 <= length) {
+            const __m256i c = loadWindows(in + i, in + i + 15);
+            __m256i valid;
+            const __m256i n = nibblesFromAscii256(c, valid);
+            const __m256i ok = _mm256_or_si256(_mm256_or_si256(_mm256_and_si256(valid, digitLanes),
+                                                               _mm256_and_si256(_mm256_cmpeq_epi8(c, space), spaceLanes)),
+                                               dontCare);
+            if (_mm256_movemask_epi8(ok) == -1) {
+                const __m256i bytes = joinNibblePairs256(_mm256_shuffle_epi8(n, gather));
+                const __m256i packed = _mm256_packus_epi16(bytes, bytes);
+                // Second store overlaps the three zero bytes after the first five.
+                _mm_storel_epi64(reinterpret_cast<__m128i *>(out + o), _mm256_castsi256_si128(packed));
+                _mm_storel_epi64(reinterpret_cast<__m128i *>(out + o + 5), _mm256_extracti128_si256(packed, 1));
+                i += 30;
+                o += 10;
+                continue;
+            }
+        }
+        break;
+    }
+
+    std::size_t tail = 0;
+    i += decodeSse2(in + i, length - i, out + o, &tail);
+    *produced = o + tail;
+    return i;
+}
+
+bool cpuHasAvx2()
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    __cpuid(info, 1);
+    const bool osxsave = info[2] & (1 << 27);
+    const bool avx = info[2] & (1 << 28);
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+        return false; // The OS does not save YMM state
+    }
+    __cpuidex(info, 7, 0);
+    return info[1] & (1 << 5);
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+bool cpuHasSse2()
+{
+#if defined(__x86_64__) || defined(_M_X64)
+    return true; // Part of the x86-64 baseline
+#elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return info[3] & (1 << 26);
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse2");
+#endif
+}
+
+#endif // HEXCODEC_X86
+
+Kernel detectKernel()
+{
+#ifdef HEXCODEC_X86
+    if (cpuHasAvx2()) {
+        return Kernel::Avx2;
+    }
+    if (cpuHasSse2()) {
+        return Kernel::Sse2;
+    }
+#endif
+    return Kernel::Scalar;
+}
+
+const Kernels &kernelsFor(Kernel requested)
+{
+    static const Kernels scalar = { Kernel::Scalar, nullptr, nullptr, nullptr };
+#ifdef HEXCODEC_X86
+    static const Kernels sse2 = { Kernel::Sse2, encodeSse2, decodeSse2<char>, decodeSse2<char16_t> };
+    static const Kernels avx2 = { Kernel::Avx2, encodeAvx2, decodeAvx2<char>, decodeAvx2<char16_t> };
+#endif
+
+    const Kernel best = activeKernel();
+    if (requested == Kernel::Auto || int(requested) > int(best)) {
+        requested = best; // Never run an instruction set the CPU lacks
+    }
+    switch (requested) {
+#ifdef HEXCODEC_X86
+    case Kernel::Avx2:
+        return avx2;
+    case Kernel::Sse2:
+        return sse2;
+#endif
+    default:
+        return scalar;
+    }
+}
+
+} // namespace
+
+Kernel activeKernel()
+{
+    static const Kernel kernel = detectKernel();
+    return kernel;
+}
+
+const char *kernelName(Kernel kernel)
+{
+    switch (kernel) {
+    case Kernel::Auto:
+        return kernelName(activeKernel());
+    case Kernel::Scalar:
+        return "scalar";
+    case Kernel::Sse2:
+        return "sse2";
+    case Kernel::Avx2:
+        return "avx2";
+    }
+    return "unknown";
+}
+
+bool isKernelSupported(Kernel kernel)
+{
+    return int(kernel) <= int(activeKernel());
+}
+
+void encode(const unsigned char *in, std::size_t length, char *out, char separator, Kernel kernel)
+{
+    const Kernels &k = kernelsFor(kernel);
+    const std::size_t done = k.encode ? k.encode(in, length, out, separator) : 0;
+    encodeScalar(in, done, length, out + done * (separator ? 3 : 2), separator);
+}
+
+DecodeResult decode(const char *in, std::size_t length, unsigned char *out, Kernel kernel)
+{
+    return decodeWith(in, length, out, kernelsFor(kernel).decode8);
+}
+
+DecodeResult decode(const char16_t *in, std::size_t length, unsigned char *out, Kernel kernel)
+{
+    return decodeWith(in, length, out, kernelsFor(kernel).decode16);
+}
+
+} // namespace HexCodec
@@ -0,0 +1,57 @@
+#ifndef HEXCODEC_H
+#define HEXCODEC_H
+
+#include <cstddef>
+
+// Single pass hex encode/decode kernels with SSE2/AVX2 implementations that are
+// picked at runtime (scalar fallback everywhere else). Both directions write into
+// a caller provided buffer, so converting a dump never allocates.
+namespace HexCodec {
+
+enum class Kernel {
+    Auto,   // Best kernel the CPU supports
+    Scalar,
+    Sse2,
+    Avx2
+};
+
+struct DecodeResult {
+    std::size_t bytesWritten = 0;
+    std::ptrdiff_t errorOffset = -1; // Offset of the first invalid or dangling digit, -1 if none
+
+    bool ok() const { return errorOffset < 0; }
+};
+
+// Kernel used for Kernel::Auto on this machine.
+Kernel activeKernel();
+const char *kernelName(Kernel kernel);
+bool isKernelSupported(Kernel kernel);
+
+// Size of encode() output; separator '\0' means digits are not separated.
+// With a separator the output matches QByteArray::toHex(separator): no trailing separator.
+constexpr std::size_t encodedLength(std::size_t byteCount, char separator = ' ')
+{
+    return byteCount == 0 ? 0 : (separator ? byteCount * 3 - 1 : byteCount * 2);
+}
+
+// Upper bound for decode() output.
+constexpr std::size_t maxDecodedLength(std::size_t charCount)
+{
+    return charCount / 2;
+}
+
+// Writes encodedLength(length, separator) lower case characters to out.
+void encode(const unsigned char *in, std::size_t length, char *out, char separator = ' ',
+            Kernel kernel = Kernel::Auto);
+
+// Decodes hex digit pairs into out (which must hold maxDecodedLength(length) bytes).
+// Whitespace (space, tab, CR, LF) between bytes is skipped. Decoding stops at the first
+// character that is neither, or at a digit whose partner is missing, and reports its offset.
+DecodeResult decode(const char *in, std::size_t length, unsigned char *out,
+                    Kernel kernel = Kernel::Auto);
+DecodeResult decode(const char16_t *in, std::size_t length, unsigned char *out,
+                    Kernel kernel = Kernel::Auto);
+
+} // namespace HexCodec
+
+#endif // HEXCODEC_H
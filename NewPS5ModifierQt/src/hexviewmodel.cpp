@@ -0,0 +1,133 @@
+#include "hexviewmodel.h"
+#include "noredithistory.h"
+#include "norimage.h"
+#include "hexcodec.h"
+#include <QVarLengthArray>
+#include <cstring>
+
+HexViewModel::HexViewModel(QObject *parent) : QAbstractListModel(parent)
+{
+}
+
+void HexViewModel::setImage(NorImage *image)
+{
+    beginResetModel();
+    m_image = image;
+    endResetModel();
+    emit byteCountChanged();
+}
+
+qint64 HexViewModel::byteCount() const
+{
+    return m_image ? m_image->size() : 0;
+}
+
+int HexViewModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid() || !m_image) {
+        return 0;
+    }
+    return static_cast<int>((m_image->size() + BytesPerRow - 1) / BytesPerRow);
+}
+
+QByteArrayView HexViewModel::rowBytes(int row) const
+{
+    return m_image->view(qint64(row) * BytesPerRow, BytesPerRow);
+}
+
+QVariant HexViewModel::data(const QModelIndex &index, int role) const
+{
+    if (!m_image || !index.isValid() || index.row() >= rowCount()) {
+        return QVariant();
+    }
+
+    const QByteArrayView bytes = rowBytes(index.row());
+    switch (role) {
+    case OffsetRole:
+        return QString::number(qint64(index.row()) * BytesPerRow, 16).toUpper().rightJustified(8, '0');
+    case Qt::DisplayRole:
+    case Qt::EditRole:
+    case HexRole: {
+        char hex[HexCodec::encodedLength(BytesPerRow)];
+        const std::size_t length = HexCodec::encodedLength(bytes.size());
+        HexCodec::encode(reinterpret_cast<const uchar *>(bytes.data()), bytes.size(), hex);
+        return QString::fromLatin1(hex, qsizetype(length));
+    }
+    case AsciiRole: {
+        QString ascii(bytes.size(), Qt::Uninitialized);
+        QChar *out = ascii.data();
+        for (char c : bytes) {
+            const uchar b = static_cast<uchar>(c);
+            *out++ = (b >= 0x20 && b < 0x7F) ? QChar(b) : QChar('.');
+        }
+        return ascii;
+    }
+    default:
+        return QVariant();
+    }
+}
+
+bool HexViewModel::setData(const QModelIndex &index, const QVariant &value, int role)
+{
+    if (!m_image || !m_image->data() || !index.isValid() || (role != HexRole && role != Qt::EditRole)) {
+        return false; // Read-only image, nothing to write into
+    }
+
+    const QByteArrayView current = rowBytes(index.row());
+    const QString hex = value.toString();
+    QVarLengthArray<uchar, BytesPerRow * 2> bytes(HexCodec::maxDecodedLength(hex.size()));
+    const HexCodec::DecodeResult decoded = HexCodec::decode(reinterpret_cast<const char16_t *>(hex.utf16()), hex.size(), bytes.data());
+    if (!decoded.ok() || qsizetype(decoded.bytesWritten) != current.size()) {
+        return false; // Overwrite only, the row must keep its length
+    }
+
+    const qint64 offset = qint64(index.row()) * BytesPerRow;
+    if (std::memcmp(m_image->data() + offset, bytes.constData(), current.size()) == 0) {
+        return true;
+    }
+    emit bytesAboutToBeEdited(offset, current.size());
+    if (m_history) {
+        m_history->write(m_image->data(), offset, QByteArrayView(bytes.constData(), current.size()));
+    } else {
+        std::memcpy(m_image->data() + offset, bytes.constData(), current.size());
+    }
+    emit dataChanged(index, index, { HexRole, AsciiRole, Qt::DisplayRole });
+    emit bytesEdited(offset, current.size());
+    return true;
+}
+
+Qt::ItemFlags HexViewModel::flags(const QModelIndex &index) const
+{
+    Qt::ItemFlags f = QAbstractListModel::flags(index);
+    if (m_image && m_image->data()) {
+        f |= Qt::ItemIsEditable;
+    }
+    return f;
+}
+
+QHash<int, QByteArray> HexViewModel::roleNames() const
+{
+    return {
+        { OffsetRole, "offset" },
+        { HexRole, "hex" },
+        { AsciiRole, "ascii" }
+    };
+}
+
+int HexViewModel::rowForOffset(qint64 offset) const
+{
+    if (!m_image || offset < 0 || offset >= m_image->size()) {
+        return -1;
+    }
+    return static_cast<int>(offset / BytesPerRow);
+}
+
+void HexViewModel::refreshBytes(qint64 offset, qint64 length)
+{
+    const int first = rowForOffset(offset);
+    const int last = rowForOffset(offset + length - 1);
+    if (first < 0 || last < 0 || length <= 0) {
+        return;
+    }
+    emit dataChanged(index(first), index(last), { HexRole, AsciiRole, Qt::DisplayRole });
+}
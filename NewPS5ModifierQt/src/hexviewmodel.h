@@ -0,0 +1,65 @@
+#ifndef HEXVIEWMODEL_H
+#define HEXVIEWMODEL_H
+
+#include <QAbstractListModel>
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QHash>
+
+class NorEditHistory;
+class NorImage;
+
+// Exposes a NorImage to QML as rows of 16 bytes (offset / hex / ASCII).
+// Rows are formatted on demand straight from the mapping, so only the rows a
+// ListView actually shows ever become strings.
+class HexViewModel : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(int bytesPerRow READ bytesPerRow CONSTANT)
+    Q_PROPERTY(qint64 byteCount READ byteCount NOTIFY byteCountChanged)
+
+public:
+    enum Roles {
+        OffsetRole = Qt::UserRole + 1,
+        HexRole,
+        AsciiRole
+    };
+
+    static constexpr int BytesPerRow = 16;
+
+    explicit HexViewModel(QObject *parent = nullptr);
+
+    // The model does not own the image; call setImage(nullptr) before the image goes away.
+    void setImage(NorImage *image);
+    NorImage *image() const { return m_image; }
+    // Edits made through setData() are recorded here when set, for undo/redo
+    void setEditHistory(NorEditHistory *history) { m_history = history; }
+
+    int bytesPerRow() const { return BytesPerRow; }
+    qint64 byteCount() const;
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    Q_INVOKABLE int rowForOffset(qint64 offset) const;
+
+    // Repaints the rows covering bytes the backend changed behind the model's back
+    void refreshBytes(qint64 offset, qint64 length);
+
+signals:
+    void byteCountChanged();
+    // Right before an edit writes into the image, so readers on other threads can stop first
+    void bytesAboutToBeEdited(qint64 offset, qint64 length);
+    void bytesEdited(qint64 offset, qint64 length);
+
+private:
+    QByteArrayView rowBytes(int row) const;
+
+    NorImage *m_image = nullptr;
+    NorEditHistory *m_history = nullptr;
+};
+
+#endif // HEXVIEWMODEL_H
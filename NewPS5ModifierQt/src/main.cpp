@@ -1,11 +1,13 @@
 #include <QGuiApplication>
 #include <QQmlApplicationEngine>
 #include <QQmlContext>
+#include "apppaths.h"
 #include "backend.h"
 
 int main(int argc, char *argv[])
 {
     QGuiApplication app(argc, argv);
+    QCoreApplication::setApplicationName(AppPaths::GuiApplicationName); // The CLI finds our data by this name
 
     QQmlApplicationEngine engine;
 
@@ -0,0 +1,246 @@
+#include "noranalysis.h"
+#include <QtEndian>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NORANALYSIS_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace NorAnalysis {
+namespace {
+
+// Slicing-by-8: eight bytes per step through eight derived tables
+struct CrcTables {
+    quint32 t[8][256];
+
+    CrcTables()
+    {
+        for (quint32 i = 0; i < 256; ++i) {
+            quint32 c = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            t[0][i] = c;
+        }
+        for (int k = 1; k < 8; ++k) {
+            for (int i = 0; i < 256; ++i) {
+                t[k][i] = (t[k - 1][i] >> 8) ^ t[0][t[k - 1][i] & 0xFF];
+            }
+        }
+    }
+};
+
+const CrcTables &crcTables()
+{
+    static const CrcTables tables;
+    return tables;
+}
+
+// c * log2(c) for every count a block can produce
+struct EntropyTable {
+    float xlogx[BlockSize + 1];
+
+    EntropyTable()
+    {
+        xlogx[0] = 0;
+        for (qint64 c = 1; c <= BlockSize; ++c) {
+            xlogx[c] = float(double(c) * std::log2(double(c)));
+        }
+    }
+};
+
+const EntropyTable &entropyTable()
+{
+    static const EntropyTable table;
+    return table;
+}
+
+// 0x00 or 0xFF if the whole block is that byte, -1 otherwise. Nearly every block of a
+// dump is either uniform or fails within the first 64 bytes, so this is cheap either way.
+int uniformByte(const uchar *data, qint64 length)
+{
+    const uchar first = data[0];
+    if (first != 0x00 && first != 0xFF) {
+        return -1;
+    }
+    qint64 i = 0;
+#ifdef NORANALYSIS_SSE2
+    const __m128i expected = _mm_set1_epi8(char(first));
+    for (; i + 64 <= length; i += 64) {
+        const auto *p = reinterpret_cast<const __m128i *>(data + i);
+        const __m128i diff = _mm_or_si128(
+            _mm_or_si128(_mm_xor_si128(_mm_loadu_si128(p), expected), _mm_xor_si128(_mm_loadu_si128(p + 1), expected)),
+            _mm_or_si128(_mm_xor_si128(_mm_loadu_si128(p + 2), expected), _mm_xor_si128(_mm_loadu_si128(p + 3), expected)));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(diff, _mm_setzero_si128())) != 0xFFFF) {
+            return -1;
+        }
+    }
+#else
+    const quint64 expected = first ? ~quint64(0) : 0;
+    for (; i + 8 <= length; i += 8) {
+        quint64 word;
+        std::memcpy(&word, data + i, 8);
+        if (word != expected) {
+            return -1;
+        }
+    }
+#endif
+    for (; i < length; ++i) {
+        if (data[i] != first) {
+            return -1;
+        }
+    }
+    return first;
+}
+
+quint32 uniformCrc(uchar value)
+{
+    static const quint32 erased = [] {
+        uchar block[BlockSize];
+        std::memset(block, 0xFF, sizeof(block));
+        return crc32(block, BlockSize);
+    }();
+    static const quint32 zeroed = [] {
+        uchar block[BlockSize] = {};
+        return crc32(block, BlockSize);
+    }();
+    return value ? erased : zeroed;
+}
+
+float entropy(const uchar *data, qint64 length)
+{
+    // Four interleaved histograms keep consecutive equal bytes from serializing on one counter
+    quint16 histogram[4][256] = {};
+    qint64 i = 0;
+    for (; i + 4 <= length; i += 4) {
+        ++histogram[0][data[i]];
+        ++histogram[1][data[i + 1]];
+        ++histogram[2][data[i + 2]];
+        ++histogram[3][data[i + 3]];
+    }
+    for (; i < length; ++i) {
+        ++histogram[0][data[i]];
+    }
+    const float *xlogx = entropyTable().xlogx;
+    float sum = 0;
+    for (int b = 0; b < 256; ++b) {
+        sum += xlogx[histogram[0][b] + histogram[1][b] + histogram[2][b] + histogram[3][b]];
+    }
+    return std::max(0.0f, float(std::log2(double(length))) - sum / float(length));
+}
+
+} // namespace
+
+quint32 crc32(const uchar *data, qint64 length, quint32 crc)
+{
+    const CrcTables &tables = crcTables();
+    const auto &t = tables.t;
+    crc = ~crc;
+    while (length >= 8) {
+        const quint32 low = qFromLittleEndian<quint32>(data) ^ crc;
+        const quint32 high = qFromLittleEndian<quint32>(data + 4);
+        crc = t[7][low & 0xFF] ^ t[6][(low >> 8) & 0xFF] ^ t[5][(low >> 16) & 0xFF] ^ t[4][low >> 24]
+            ^ t[3][high & 0xFF] ^ t[2][(high >> 8) & 0xFF] ^ t[1][(high >> 16) & 0xFF] ^ t[0][high >> 24];
+        data += 8;
+        length -= 8;
+    }
+    while (length-- > 0) {
+        crc = t[0][(crc ^ *data++) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+BlockStats analyzeBlock(const uchar *data, qint64 length)
+{
+    BlockStats stats;
+    if (length <= 0) {
+        return stats;
+    }
+    const int uniform = uniformByte(data, length);
+    if (uniform >= 0) {
+        stats.kind = uniform ? BlockKind::Erased : BlockKind::Zeroed;
+        stats.crc32 = length == BlockSize ? uniformCrc(uchar(uniform)) : crc32(data, length);
+        return stats;
+    }
+    stats.entropy = entropy(data, length);
+    stats.kind = stats.entropy >= RandomEntropy ? BlockKind::Random : BlockKind::Data;
+    stats.crc32 = crc32(data, length);
+    return stats;
+}
+
+void analyzeBlocks(QByteArrayView image, qint64 firstBlock, qint64 count, BlockStats *out)
+{
+    const auto *data = reinterpret_cast<const uchar *>(image.data());
+    for (qint64 i = 0; i < count; ++i) {
+        const qint64 offset = (firstBlock + i) * BlockSize;
+        out[i] = analyzeBlock(data + offset, std::min(BlockSize, image.size() - offset));
+    }
+}
+
+Summary summarize(const QList<BlockStats> &blocks)
+{
+    Summary summary;
+    summary.blocks = blocks.size();
+    for (const BlockStats &block : blocks) {
+        switch (block.kind) {
+        case BlockKind::Pending:
+            ++summary.pending;
+            break;
+        case BlockKind::Erased:
+            ++summary.erased;
+            break;
+        case BlockKind::Zeroed:
+            ++summary.zeroed;
+            break;
+        case BlockKind::Data:
+            ++summary.data;
+            break;
+        case BlockKind::Random:
+            ++summary.random;
+            break;
+        }
+    }
+    for (auto it = blocks.crbegin(); it != blocks.crend() && it->kind == BlockKind::Erased; ++it) {
+        ++summary.trailingErased;
+    }
+    return summary;
+}
+
+QString describe(const Summary &summary)
+{
+    if (summary.blocks == 0) {
+        return QString();
+    }
+    QString text = QString("%1 blocks of 4 KiB: %2 erased, %3 zeroed, %4 data, %5 encrypted/compressed")
+                       .arg(summary.blocks).arg(summary.erased).arg(summary.zeroed).arg(summary.data).arg(summary.random);
+    if (summary.pending > 0) {
+        text += QString(", %1 pending").arg(summary.pending);
+    } else if (summary.erased == summary.blocks) {
+        text += ". The dump is blank";
+    } else if (summary.trailingErased > 0) {
+        text += QString(". The last %1 KiB are erased").arg(summary.trailingErased * BlockSize / 1024);
+    }
+    return text;
+}
+
+const char *kindName(BlockKind kind)
+{
+    switch (kind) {
+    case BlockKind::Pending:
+        return "pending";
+    case BlockKind::Erased:
+        return "erased";
+    case BlockKind::Zeroed:
+        return "zeroed";
+    case BlockKind::Data:
+        return "data";
+    case BlockKind::Random:
+        return "random";
+    }
+    return "";
+}
+
+} // namespace NorAnalysis
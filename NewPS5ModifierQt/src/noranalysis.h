@@ -0,0 +1,60 @@
+#ifndef NORANALYSIS_H
+#define NORANALYSIS_H
+
+#include <QByteArrayView>
+#include <QList>
+#include <QString>
+#include <QtGlobal>
+
+// Per-block statistics of a NOR image: erased (all 0xFF) and zeroed blocks, Shannon
+// entropy and a CRC-32 per 4 KiB flash sector. A blank, truncated or damaged dump shows
+// up as runs of erased or zeroed blocks where firmware (high entropy) is expected.
+namespace NorAnalysis {
+
+// One flash erase sector
+constexpr qint64 BlockSize = 4096;
+
+enum class BlockKind : quint8 {
+    Pending,  // Not analyzed yet
+    Erased,   // All 0xFF
+    Zeroed,   // All 0x00
+    Data,     // Structured content, entropy below RandomEntropy
+    Random    // Encrypted or compressed content
+};
+
+// Bits per byte from which a block counts as Random
+constexpr float RandomEntropy = 7.5f;
+
+struct BlockStats {
+    quint32 crc32 = 0;   // CRC-32 (IEEE 802.3, as zlib and crc32(1)) of the block
+    float entropy = 0;   // Shannon entropy in bits per byte, 0 to 8
+    BlockKind kind = BlockKind::Pending;
+};
+
+struct Summary {
+    qint64 blocks = 0;
+    qint64 erased = 0;
+    qint64 zeroed = 0;
+    qint64 data = 0;
+    qint64 random = 0;
+    qint64 pending = 0;
+    qint64 trailingErased = 0; // Erased blocks at the very end, typical of a short read
+};
+
+inline qint64 blockCount(qint64 imageSize) { return (imageSize + BlockSize - 1) / BlockSize; }
+
+// Statistics of one block of at most BlockSize bytes.
+BlockStats analyzeBlock(const uchar *data, qint64 length);
+
+// Analyzes blocks [firstBlock, firstBlock + count) of image into out.
+void analyzeBlocks(QByteArrayView image, qint64 firstBlock, qint64 count, BlockStats *out);
+
+quint32 crc32(const uchar *data, qint64 length, quint32 crc = 0);
+
+Summary summarize(const QList<BlockStats> &blocks);
+QString describe(const Summary &summary);
+const char *kindName(BlockKind kind);
+
+} // namespace NorAnalysis
+
+#endif // NORANALYSIS_H
@@ -0,0 +1,249 @@
+#include "norarchive.h"
+#include "norimage.h"
+#include "norlayout.h"
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <algorithm>
+
+namespace {
+
+constexpr int kManifestVersion = 1;
+
+bool fail(QString *errorString, const QString &message)
+{
+    if (errorString) {
+        *errorString = message;
+    }
+    return false;
+}
+
+} // namespace
+
+NorArchive::NorArchive(const QString &rootPath) : m_rootPath(rootPath)
+{
+}
+
+QString NorArchive::chunkPath(const QByteArray &hash) const
+{
+    return m_rootPath + "/chunks/" + QString::fromLatin1(hash.left(2)) + '/' + QString::fromLatin1(hash);
+}
+
+QString NorArchive::manifestPath(const QString &id) const
+{
+    return m_rootPath + "/manifests/" + id + ".json";
+}
+
+bool NorArchive::writeChunk(const QByteArray &hash, QByteArrayView data, bool *written, QString *errorString) const
+{
+    *written = false;
+    const QString path = chunkPath(hash);
+    if (QFile::exists(path)) {
+        return true;
+    }
+    // Racing writers produce identical files, so whichever rename lands last is fine
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly) || file.write(data.data(), data.size()) != data.size() || !file.commit()) {
+        return fail(errorString, QString("Could not store chunk %1: %2").arg(QString::fromLatin1(hash), file.errorString()));
+    }
+    *written = true;
+    return true;
+}
+
+bool NorArchive::ingest(QByteArrayView image, const QString &name, IngestResult *result, QString *errorString) const
+{
+    IngestResult local;
+    IngestResult &r = result ? *result : local;
+    r = IngestResult();
+    if (image.isEmpty()) {
+        return fail(errorString, "Cannot archive an empty image");
+    }
+
+    // Hash everything first: the id decides whether anything needs writing at all
+    QList<QByteArray> hashes;
+    hashes.reserve((image.size() + ChunkSize - 1) / ChunkSize);
+    QCryptographicHash idHash(QCryptographicHash::Sha256);
+    for (qint64 offset = 0; offset < image.size(); offset += ChunkSize) {
+        const QByteArray digest = QCryptographicHash::hash(image.mid(offset, std::min(ChunkSize, image.size() - offset)),
+                                                           QCryptographicHash::Sha256);
+        idHash.addData(digest);
+        hashes.append(digest.toHex());
+    }
+    idHash.addData(QByteArray::number(image.size()));
+    r.id = QString::fromLatin1(idHash.result().toHex());
+    r.chunkCount = int(hashes.size());
+    if (contains(r.id)) {
+        r.alreadyArchived = true;
+        return true;
+    }
+
+    for (qsizetype i = 0; i < hashes.size(); ++i) {
+        const qint64 offset = qint64(i) * ChunkSize;
+        const QByteArrayView chunk = image.mid(offset, std::min(ChunkSize, image.size() - offset));
+        bool written = false;
+        if (!writeChunk(hashes.at(i), chunk, &written, errorString)) {
+            return false;
+        }
+        if (written) {
+            ++r.newChunks;
+            r.newBytes += chunk.size();
+        }
+    }
+
+    QJsonArray chunks;
+    for (const QByteArray &hash : std::as_const(hashes)) {
+        chunks.append(QString::fromLatin1(hash));
+    }
+    QJsonObject manifest;
+    manifest["version"] = kManifestVersion;
+    manifest["id"] = r.id;
+    manifest["name"] = name;
+    manifest["size"] = image.size();
+    manifest["createdAt"] = QDateTime::currentSecsSinceEpoch();
+    manifest["chunkSize"] = ChunkSize;
+    manifest["details"] = QJsonObject::fromVariantMap(NorLayout::toVariantMap(NorLayout::parse(image)));
+    manifest["chunks"] = chunks;
+
+    const QString path = manifestPath(r.id);
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return fail(errorString, file.errorString());
+    }
+    file.write(QJsonDocument(manifest).toJson(QJsonDocument::Compact));
+    if (!file.commit()) {
+        return fail(errorString, file.errorString());
+    }
+    return true;
+}
+
+bool NorArchive::ingestFile(const QString &filePath, IngestResult *result, QString *errorString) const
+{
+    NorImage image;
+    if (!image.open(filePath)) {
+        return fail(errorString, image.errorString());
+    }
+    return ingest(image.view(), QFileInfo(filePath).fileName(), result, errorString);
+}
+
+bool NorArchive::contains(const QString &id) const
+{
+    return !id.isEmpty() && QFile::exists(manifestPath(id));
+}
+
+bool NorArchive::readManifest(const QString &id, Manifest *manifest, QString *errorString) const
+{
+    QFile file(manifestPath(id));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return fail(errorString, QString("Dump %1 is not archived: %2").arg(id, file.errorString()));
+    }
+    QJsonParseError parseError;
+    const QJsonObject object = QJsonDocument::fromJson(file.readAll(), &parseError).object();
+    if (parseError.error != QJsonParseError::NoError) {
+        return fail(errorString, QString("Manifest %1 is damaged: %2").arg(id, parseError.errorString()));
+    }
+    if (object.value("version").toInt() != kManifestVersion || object.value("chunkSize").toInteger() != ChunkSize) {
+        return fail(errorString, QString("Manifest %1 has an unsupported format").arg(id));
+    }
+
+    Manifest m;
+    m.id = object.value("id").toString();
+    m.name = object.value("name").toString();
+    m.size = object.value("size").toInteger();
+    m.createdAt = object.value("createdAt").toInteger();
+    m.details = object.value("details").toObject().toVariantMap();
+    const QJsonArray chunks = object.value("chunks").toArray();
+    m.chunks.reserve(chunks.size());
+    for (const QJsonValue &chunk : chunks) {
+        m.chunks.append(chunk.toString().toLatin1());
+    }
+    if (m.id != id || m.chunks.size() != (m.size + ChunkSize - 1) / ChunkSize) {
+        return fail(errorString, QString("Manifest %1 is inconsistent").arg(id));
+    }
+    if (manifest) {
+        *manifest = std::move(m);
+    }
+    return true;
+}
+
+QList<NorArchive::Manifest> NorArchive::manifests() const
+{
+    QList<Manifest> result;
+    QDirIterator it(m_rootPath + "/manifests", { "*.json" }, QDir::Files);
+    while (it.hasNext()) {
+        Manifest manifest;
+        if (readManifest(it.nextFileInfo().completeBaseName(), &manifest)) {
+            result.append(std::move(manifest));
+        }
+    }
+    std::sort(result.begin(), result.end(), [](const Manifest &a, const Manifest &b) { return a.createdAt > b.createdAt; });
+    return result;
+}
+
+bool NorArchive::restore(const QString &id, QIODevice *out, QString *errorString) const
+{
+    Manifest manifest;
+    if (!readManifest(id, &manifest, errorString)) {
+        return false;
+    }
+    QByteArray buffer;
+    for (qsizetype i = 0; i < manifest.chunks.size(); ++i) {
+        const QByteArray &hash = manifest.chunks.at(i);
+        const qint64 expected = std::min(ChunkSize, manifest.size - qint64(i) * ChunkSize);
+        QFile chunk(chunkPath(hash));
+        if (!chunk.open(QIODevice::ReadOnly)) {
+            return fail(errorString, QString("Chunk %1 is missing: %2").arg(QString::fromLatin1(hash), chunk.errorString()));
+        }
+        buffer = chunk.read(expected + 1);
+        if (buffer.size() != expected || QCryptographicHash::hash(buffer, QCryptographicHash::Sha256).toHex() != hash) {
+            return fail(errorString, QString("Chunk %1 is corrupt").arg(QString::fromLatin1(hash)));
+        }
+        if (out->write(buffer) != buffer.size()) {
+            return fail(errorString, out->errorString());
+        }
+    }
+    return true;
+}
+
+bool NorArchive::restoreToFile(const QString &id, const QString &filePath, QString *errorString) const
+{
+    QDir().mkpath(QFileInfo(filePath).absolutePath());
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return fail(errorString, file.errorString());
+    }
+    if (!restore(id, &file, errorString)) {
+        file.cancelWriting();
+        return false;
+    }
+    if (!file.commit()) {
+        return fail(errorString, file.errorString());
+    }
+    return true;
+}
+
+NorArchive::Stats NorArchive::stats() const
+{
+    Stats stats;
+    for (const Manifest &manifest : manifests()) {
+        ++stats.dumps;
+        stats.logicalBytes += manifest.size;
+    }
+    QDirIterator it(m_rootPath + "/chunks", QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        const QFileInfo info = it.nextFileInfo();
+        if (info.fileName().size() == 64) { // Skip QSaveFile leftovers
+            ++stats.uniqueChunks;
+            stats.storedBytes += info.size();
+        }
+    }
+    return stats;
+}
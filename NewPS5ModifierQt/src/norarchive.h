@@ -0,0 +1,78 @@
+#ifndef NORARCHIVE_H
+#define NORARCHIVE_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QList>
+#include <QString>
+#include <QVariantMap>
+#include <QtGlobal>
+
+class QIODevice;
+
+// Content-addressed store for NOR dumps. Images are cut into fixed 64 KiB chunks,
+// every chunk is stored once under its SHA-256 (chunks/ab/abcd...), and a dump is a
+// small JSON manifest listing its chunk hashes (manifests/<id>.json). Dumps of the
+// same firmware share most chunks, and erased (0xFF) space collapses to one chunk.
+// The dump id is derived from the chunk hashes, so archiving a dump twice is a no-op.
+//
+// Chunks are written with an atomic rename and manifests only after all of their
+// chunks, so any number of ingests may run concurrently on the same store, from
+// threads or processes, and a crash never leaves a manifest with missing chunks.
+class NorArchive
+{
+public:
+    static constexpr qint64 ChunkSize = 64 * 1024;
+
+    struct Manifest {
+        QString id;
+        QString name;         // File name the dump was archived from
+        qint64 size = 0;
+        qint64 createdAt = 0; // Seconds since the epoch
+        QVariantMap details;  // NorLayout::toVariantMap() of the image
+        QList<QByteArray> chunks; // Hex SHA-256 per chunk, in image order
+    };
+
+    struct IngestResult {
+        QString id;
+        int chunkCount = 0;
+        int newChunks = 0;    // Chunks the store did not have yet
+        qint64 newBytes = 0;
+        bool alreadyArchived = false;
+    };
+
+    struct Stats {
+        int dumps = 0;
+        qint64 uniqueChunks = 0;
+        qint64 storedBytes = 0;  // Chunk payload on disk
+        qint64 logicalBytes = 0; // Sum of the archived dump sizes
+    };
+
+    explicit NorArchive(const QString &rootPath);
+
+    QString rootPath() const { return m_rootPath; }
+
+    bool ingest(QByteArrayView image, const QString &name, IngestResult *result, QString *errorString = nullptr) const;
+    bool ingestFile(const QString &filePath, IngestResult *result, QString *errorString = nullptr) const;
+
+    bool contains(const QString &id) const;
+    bool readManifest(const QString &id, Manifest *manifest, QString *errorString = nullptr) const;
+    // Newest first; manifests that cannot be read are skipped.
+    QList<Manifest> manifests() const;
+
+    // Streams the dump chunk by chunk into out, checking every chunk against its hash.
+    bool restore(const QString &id, QIODevice *out, QString *errorString = nullptr) const;
+    // Restores into filePath through a temporary file and an atomic rename.
+    bool restoreToFile(const QString &id, const QString &filePath, QString *errorString = nullptr) const;
+
+    Stats stats() const;
+
+private:
+    QString chunkPath(const QByteArray &hash) const;
+    QString manifestPath(const QString &id) const;
+    bool writeChunk(const QByteArray &hash, QByteArrayView data, bool *written, QString *errorString) const;
+
+    QString m_rootPath;
+};
+
+#endif // NORARCHIVE_H
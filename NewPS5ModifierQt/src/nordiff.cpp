@@ -0,0 +1,253 @@
+#include "nordiff.h"
+#include <QStringList>
+#include <QtAlgorithms>
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NORDIFF_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace NorDiff {
+namespace {
+
+// Granularity of the memcmp skip over equal data
+constexpr qint64 kPageSize = 4096;
+
+// Index of the first byte in [from, to) where a and b agree (FindEqual) or differ
+// (!FindEqual); to if there is none.
+template <bool FindEqual>
+qint64 scan(const uchar *a, const uchar *b, qint64 from, qint64 to)
+{
+    qint64 i = from;
+#ifdef NORDIFF_SSE2
+    for (; i + 16 <= to; i += 16) {
+        const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+        const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i));
+        const quint32 equalMask = quint32(_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb)));
+        const quint32 mask = FindEqual ? equalMask : (~equalMask & 0xFFFFu);
+        if (mask) {
+            return i + qCountTrailingZeroBits(mask);
+        }
+    }
+#else
+    for (; i + 8 <= to; i += 8) {
+        quint64 wa;
+        quint64 wb;
+        std::memcpy(&wa, a + i, 8);
+        std::memcpy(&wb, b + i, 8);
+        const quint64 x = wa ^ wb;
+        // FindEqual: stop at a word with a zero byte in x; otherwise at any nonzero x
+        const bool hit = FindEqual ? ((x - 0x0101010101010101ull) & ~x & 0x8080808080808080ull) != 0 : x != 0;
+        if (hit) {
+            break; // The byte loop below finds the exact position
+        }
+    }
+#endif
+    for (; i < to; ++i) {
+        if ((a[i] == b[i]) == FindEqual) {
+            return i;
+        }
+    }
+    return to;
+}
+
+class RegionBuilder
+{
+public:
+    RegionBuilder(Result &result, const Options &options) : m_result(result), m_options(options) {}
+
+    void addRun(qint64 offset, qint64 length)
+    {
+        m_result.differingBytes += length;
+        if (m_open && offset - m_current.end() <= m_options.mergeGap) {
+            m_current.length = offset + length - m_current.offset;
+            m_current.differingBytes += length;
+            return;
+        }
+        flush();
+        m_current = Region();
+        m_current.offset = offset;
+        m_current.length = length;
+        m_current.differingBytes = length;
+        m_open = true;
+    }
+
+    void addTail(qint64 offset, qint64 length, RegionKind kind)
+    {
+        flush();
+        m_result.differingBytes += length;
+        m_current = Region();
+        m_current.offset = offset;
+        m_current.length = length;
+        m_current.differingBytes = length;
+        m_current.kind = kind;
+        m_open = true;
+        flush();
+    }
+
+    void flush()
+    {
+        if (!m_open) {
+            return;
+        }
+        m_open = false;
+        if (m_result.regions.size() >= m_options.maxRegions) {
+            m_result.truncated = true;
+            return;
+        }
+        m_current.fields = fieldsOverlapping(m_current.offset, m_current.length);
+        m_result.regions.append(m_current);
+    }
+
+private:
+    Result &m_result;
+    const Options &m_options;
+    Region m_current;
+    bool m_open = false;
+};
+
+} // namespace
+
+Result compare(QByteArrayView a, QByteArrayView b, const Options &options)
+{
+    Result result;
+    result.sizeA = a.size();
+    result.sizeB = b.size();
+    const auto *pa = reinterpret_cast<const uchar *>(a.data());
+    const auto *pb = reinterpret_cast<const uchar *>(b.data());
+    const qint64 common = std::min(result.sizeA, result.sizeB);
+
+    RegionBuilder builder(result, options);
+    qint64 offset = 0;
+    while (offset < common) {
+        const qint64 pageEnd = std::min(common, (offset / kPageSize + 1) * kPageSize);
+        if (std::memcmp(pa + offset, pb + offset, size_t(pageEnd - offset)) == 0) {
+            offset = pageEnd; // The common case: identical firmware pages
+            continue;
+        }
+        while (offset < pageEnd) {
+            const qint64 runStart = scan<false>(pa, pb, offset, pageEnd);
+            if (runStart == pageEnd) {
+                break;
+            }
+            // A run may continue past the page; it is scanned to its real end here
+            const qint64 runEnd = scan<true>(pa, pb, runStart, common);
+            builder.addRun(runStart, runEnd - runStart);
+            offset = runEnd;
+        }
+        offset = std::max(offset, pageEnd);
+    }
+
+    if (result.sizeA != result.sizeB) {
+        builder.addTail(common, std::max(result.sizeA, result.sizeB) - common,
+                        result.sizeA > result.sizeB ? RegionKind::OnlyInA : RegionKind::OnlyInB);
+    }
+    builder.flush();
+    return result;
+}
+
+bool rediff(const Result &result, QByteArrayView a, QByteArrayView b, qint64 offset, qint64 length, Update *update,
+            const Options &options)
+{
+    if (result.truncated || a.size() != result.sizeA || b.size() != result.sizeB) {
+        return false;
+    }
+    *update = Update();
+    // Past the common part the tail region covers everything whatever the bytes are
+    const qint64 common = std::min(result.sizeA, result.sizeB);
+    qint64 begin = std::clamp<qint64>(offset - options.mergeGap - 1, 0, common);
+    qint64 end = std::clamp<qint64>(offset + length + options.mergeGap + 1, 0, common);
+    if (begin >= end) {
+        return true;
+    }
+
+    // Regions are sorted and disjoint; take in every one that reaches into [begin, end)
+    const QList<Region> &regions = result.regions;
+    const auto firstIt = std::partition_point(regions.cbegin(), regions.cend(),
+                                              [begin](const Region &region) { return region.end() <= begin; });
+    const auto lastIt = std::partition_point(firstIt, regions.cend(), [end](const Region &region) { return region.offset < end; });
+    update->first = firstIt - regions.cbegin();
+    update->removed = lastIt - firstIt;
+    for (auto it = firstIt; it != lastIt; ++it) {
+        update->differingBytesDelta -= it->differingBytes;
+    }
+    if (update->removed > 0) {
+        begin = std::min(begin, firstIt->offset);
+        end = std::max(end, std::prev(lastIt)->end());
+    }
+
+    Result part = compare(a.sliced(begin, end - begin), b.sliced(begin, end - begin), options);
+    if (part.truncated || regions.size() - update->removed + part.regions.size() > options.maxRegions) {
+        return false;
+    }
+    for (Region &region : part.regions) {
+        region.offset += begin;
+        region.fields = fieldsOverlapping(region.offset, region.length);
+    }
+    update->differingBytesDelta += part.differingBytes;
+    update->regions = std::move(part.regions);
+    return true;
+}
+
+void apply(Result &result, const Update &update)
+{
+    const qsizetype kept = std::min(update.removed, update.regions.size());
+    std::copy_n(update.regions.cbegin(), kept, result.regions.begin() + update.first);
+    if (update.removed > kept) {
+        result.regions.remove(update.first + kept, update.removed - kept);
+    } else if (update.regions.size() > kept) {
+        result.regions.insert(update.first + kept, update.regions.size() - kept, Region());
+        std::copy(update.regions.cbegin() + kept, update.regions.cend(), result.regions.begin() + update.first + kept);
+    }
+    result.differingBytes += update.differingBytesDelta;
+}
+
+quint32 fieldsOverlapping(qint64 offset, qint64 length)
+{
+    quint32 fields = 0;
+    for (const NorLayout::FieldDescriptor &field : NorLayout::kFields) {
+        if (offset < qint64(field.offset) + field.length && qint64(field.offset) < offset + length) {
+            fields |= 1u << int(field.field);
+        }
+    }
+    return fields;
+}
+
+QString describeFields(quint32 fields)
+{
+    QStringList names;
+    for (const NorLayout::FieldDescriptor &field : NorLayout::kFields) {
+        if (fields & (1u << int(field.field))) {
+            names.append(QLatin1String(fieldDisplayName(field.field)));
+        }
+    }
+    return names.join(QLatin1String(", "));
+}
+
+const char *fieldDisplayName(NorLayout::Field field)
+{
+    switch (field) {
+    case NorLayout::Field::LanMac:
+        return "LAN MAC";
+    case NorLayout::Field::EditionFlag:
+        return "Edition flag";
+    case NorLayout::Field::EditionFlagBackup:
+        return "Edition flag (backup)";
+    case NorLayout::Field::MoboSerial:
+        return "Motherboard serial";
+    case NorLayout::Field::BoardSerial:
+        return "Board serial";
+    case NorLayout::Field::Variant:
+        return "Variant";
+    case NorLayout::Field::WifiMac:
+        return "WiFi MAC";
+    case NorLayout::Field::Count:
+        break;
+    }
+    return "";
+}
+
+} // namespace NorDiff
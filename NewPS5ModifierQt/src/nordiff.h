@@ -0,0 +1,78 @@
+#ifndef NORDIFF_H
+#define NORDIFF_H
+
+#include "norlayout.h"
+#include <QByteArrayView>
+#include <QList>
+#include <QString>
+#include <QtGlobal>
+
+// Byte level comparison of two NOR images. Equal stretches are skipped a page at a
+// time with memcmp (vectorized by the C library), differing pages are scanned 16 bytes
+// at a time, and differing bytes are coalesced into regions tagged with the NorLayout
+// fields they touch.
+namespace NorDiff {
+
+enum class RegionKind : quint8 {
+    Changed,  // Present in both images with different content
+    OnlyInA,  // Past the end of the shorter image B
+    OnlyInB   // Past the end of the shorter image A
+};
+
+struct Region {
+    qint64 offset = 0;
+    qint64 length = 0;
+    qint64 differingBytes = 0; // Can be less than length when nearby runs were merged
+    quint32 fields = 0;        // Bit (1 << NorLayout::Field) for every field overlapped
+    RegionKind kind = RegionKind::Changed;
+
+    qint64 end() const { return offset + length; }
+};
+
+struct Options {
+    // Differing runs separated by at most this many equal bytes become one region
+    qint64 mergeGap = 8;
+    // Stop collecting (but keep counting) after this many regions
+    int maxRegions = 1 << 20;
+};
+
+struct Result {
+    QList<Region> regions;
+    qint64 sizeA = 0;
+    qint64 sizeB = 0;
+    qint64 differingBytes = 0; // Includes the bytes only one image has
+    bool truncated = false;    // More than Options::maxRegions regions
+
+    bool identical() const { return differingBytes == 0; }
+};
+
+Result compare(QByteArrayView a, QByteArrayView b, const Options &options = Options());
+
+// result.regions[first, first + removed) are replaced by regions
+struct Update {
+    qsizetype first = 0;
+    qsizetype removed = 0;
+    QList<Region> regions;
+    qint64 differingBytesDelta = 0;
+
+    bool isEmpty() const { return removed == 0 && regions.isEmpty(); }
+};
+
+// After bytes in [offset, offset + length) changed in a or b (sizes unchanged), re-diffs
+// only that stretch, widened past mergeGap and over the regions it touches so the
+// regions come out exactly as compare() would build them. result must be the compare()
+// of a and b from before the change. Returns false when only a full compare() is exact,
+// i.e. when result is or would become truncated.
+bool rediff(const Result &result, QByteArrayView a, QByteArrayView b, qint64 offset, qint64 length, Update *update,
+            const Options &options = Options());
+void apply(Result &result, const Update &update);
+
+// Fields overlapping [offset, offset + length) as a Region::fields mask.
+quint32 fieldsOverlapping(qint64 offset, qint64 length);
+// "Board serial, Variant"; empty for no fields.
+QString describeFields(quint32 fields);
+const char *fieldDisplayName(NorLayout::Field field);
+
+} // namespace NorDiff
+
+#endif // NORDIFF_H
@@ -0,0 +1,151 @@
+#include "noredithistory.h"
+#include <algorithm>
+#include <cstring>
+
+bool NorEditHistory::write(uchar *image, qint64 offset, QByteArrayView bytes)
+{
+    if (!image || bytes.isEmpty()) {
+        return false;
+    }
+    if (std::memcmp(image + offset, bytes.data(), size_t(bytes.size())) == 0) {
+        return false;
+    }
+    record(offset, QByteArrayView(image + offset, bytes.size()), bytes);
+    std::memcpy(image + offset, bytes.data(), size_t(bytes.size()));
+    return true;
+}
+
+void NorEditHistory::record(qint64 offset, QByteArrayView before, QByteArrayView after)
+{
+    qint64 begin = 0;
+    qint64 end = std::min(before.size(), after.size());
+    while (begin < end && before[begin] == after[begin]) {
+        ++begin;
+    }
+    while (end > begin && before[end - 1] == after[end - 1]) {
+        --end;
+    }
+    if (begin == end) {
+        return;
+    }
+
+    if (m_depth == 0 || !m_stepOpen) {
+        dropRedoSteps(); // A new edit after an undo forks history; the undone steps are gone
+        m_steps.append(m_edits.size());
+        ++m_applied;
+        m_stepOpen = m_depth > 0;
+    }
+    Edit edit;
+    edit.offset = offset + begin;
+    edit.length = end - begin;
+    edit.data = m_data.size();
+    m_data.append(before.sliced(begin, end - begin));
+    m_data.append(after.sliced(begin, end - begin));
+    m_edits.append(edit);
+    if (m_depth == 0) {
+        enforceLimit();
+    }
+}
+
+void NorEditHistory::beginStep()
+{
+    if (m_depth++ == 0) {
+        m_stepOpen = false;
+    }
+}
+
+void NorEditHistory::endStep()
+{
+    if (m_depth > 0 && --m_depth == 0) {
+        m_stepOpen = false;
+        enforceLimit();
+    }
+}
+
+bool NorEditHistory::undo(uchar *image, QList<NorPatch::Range> *changed)
+{
+    if (!image || !canUndo() || m_depth > 0) {
+        return false;
+    }
+    const qsizetype step = --m_applied;
+    // Backwards, so overlapping edits inside one step unwind in the right order
+    for (qsizetype i = stepEnd(step) - 1; i >= m_steps.at(step); --i) {
+        const Edit &edit = m_edits.at(i);
+        std::memcpy(image + edit.offset, m_data.constData() + edit.data, size_t(edit.length));
+        if (changed) {
+            NorPatch::addRange(*changed, edit.offset, edit.length);
+        }
+    }
+    return true;
+}
+
+bool NorEditHistory::redo(uchar *image, QList<NorPatch::Range> *changed)
+{
+    if (!image || !canRedo() || m_depth > 0) {
+        return false;
+    }
+    const qsizetype step = m_applied++;
+    for (qsizetype i = m_steps.at(step); i < stepEnd(step); ++i) {
+        const Edit &edit = m_edits.at(i);
+        std::memcpy(image + edit.offset, m_data.constData() + edit.data + edit.length, size_t(edit.length));
+        if (changed) {
+            NorPatch::addRange(*changed, edit.offset, edit.length);
+        }
+    }
+    return true;
+}
+
+void NorEditHistory::clear()
+{
+    m_edits.clear();
+    m_steps.clear();
+    m_data.clear();
+    m_applied = 0;
+    m_clean = 0;
+    m_depth = 0;
+    m_stepOpen = false;
+}
+
+qsizetype NorEditHistory::stepEnd(qsizetype step) const
+{
+    return step + 1 < m_steps.size() ? m_steps.at(step + 1) : m_edits.size();
+}
+
+void NorEditHistory::dropRedoSteps()
+{
+    if (!canRedo()) {
+        return;
+    }
+    const qsizetype firstEdit = m_steps.at(m_applied);
+    m_data.truncate(firstEdit < m_edits.size() ? m_edits.at(firstEdit).data : m_data.size());
+    m_edits.resize(firstEdit);
+    m_steps.resize(m_applied);
+    if (m_clean > m_applied) {
+        m_clean = -1;
+    }
+}
+
+void NorEditHistory::enforceLimit()
+{
+    // Whole steps go from the front; the newest applied step stays however large it is
+    qsizetype drop = 0;
+    while (drop + 1 < m_applied && m_data.size() - m_edits.at(m_steps.at(drop)).data > m_limitBytes) {
+        ++drop;
+    }
+    if (drop == 0) {
+        return;
+    }
+    const qsizetype firstEdit = m_steps.at(drop);
+    const qsizetype cut = m_edits.at(firstEdit).data;
+    m_data.remove(0, cut);
+    m_edits.remove(0, firstEdit);
+    for (Edit &edit : m_edits) {
+        edit.data -= cut;
+    }
+    m_steps.remove(0, drop);
+    for (qsizetype &start : m_steps) {
+        start -= firstEdit;
+    }
+    m_applied -= drop;
+    m_clean = m_clean >= drop ? m_clean - drop : -1;
+}
@@ -0,0 +1,67 @@
+#ifndef NOREDITHISTORY_H
+#define NOREDITHISTORY_H
+
+#include "norpatch.h"
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QList>
+#include <QtGlobal>
+
+// Undo/redo journal for in-place edits of a NOR image. The copy-on-write mapping holds
+// the current bytes; the journal keeps only what each edit replaced and what it wrote,
+// back to back in one append buffer. Undo, redo and the memory they use scale with the
+// size of the edits, never with the size of the dump.
+//
+// Edits recorded between beginStep() and endStep() are undone and redone together,
+// so a replace-all or a field change is one step.
+class NorEditHistory
+{
+public:
+    // Oldest steps are dropped once the journal holds more than this
+    static constexpr qsizetype DefaultLimitBytes = 16 * 1024 * 1024;
+
+    // Writes bytes at offset and records the change. Returns false if they were already there.
+    bool write(uchar *image, qint64 offset, QByteArrayView bytes);
+    // Records an edit the caller has already written; equal leading and trailing bytes are skipped.
+    void record(qint64 offset, QByteArrayView before, QByteArrayView after);
+
+    void beginStep();
+    void endStep();
+
+    bool canUndo() const { return m_applied > 0; }
+    bool canRedo() const { return m_applied < m_steps.size(); }
+    // Restores the bytes of the last step (undo) or writes the next one again (redo);
+    // every byte range that changed is added to changed.
+    bool undo(uchar *image, QList<NorPatch::Range> *changed);
+    bool redo(uchar *image, QList<NorPatch::Range> *changed);
+
+    // True while the image matches the state of the last markClean() (a save)
+    bool isClean() const { return m_clean == m_applied; }
+    void markClean() { m_clean = m_applied; }
+    void clear();
+
+    qsizetype memoryUsage() const { return m_data.size(); }
+    void setLimitBytes(qsizetype limit) { m_limitBytes = limit; }
+
+private:
+    struct Edit {
+        qint64 offset = 0;
+        qint64 length = 0;
+        qsizetype data = 0; // Into m_data: length bytes before the edit, then length bytes after
+    };
+
+    qsizetype stepEnd(qsizetype step) const;
+    void dropRedoSteps();
+    void enforceLimit();
+
+    QList<Edit> m_edits;
+    QList<qsizetype> m_steps; // Index of the first edit of every step
+    QByteArray m_data;
+    qsizetype m_applied = 0;  // Steps currently applied to the image
+    qsizetype m_clean = 0;    // -1 once the saved state can no longer be reached
+    qsizetype m_limitBytes = DefaultLimitBytes;
+    int m_depth = 0;
+    bool m_stepOpen = false;  // A step was started inside the current beginStep()
+};
+
+#endif // NOREDITHISTORY_H
@@ -0,0 +1,112 @@
+#include "norimage.h"
+#include <QtGlobal>
+#include <utility>
+
+NorImage::~NorImage()
+{
+    close();
+}
+
+NorImage::NorImage(NorImage &&other) noexcept
+{
+    *this = std::move(other);
+}
+
+NorImage &NorImage::operator=(NorImage &&other) noexcept
+{
+    if (this != &other) {
+        close();
+        m_file = std::move(other.m_file);
+        m_ownedData = std::move(other.m_ownedData);
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+        m_mode = other.m_mode;
+        m_open = std::exchange(other.m_open, false);
+        m_filePath = std::move(other.m_filePath);
+        m_errorString = std::move(other.m_errorString);
+    }
+    return *this;
+}
+
+bool NorImage::open(const QString &filePath, Mode mode)
+{
+    close();
+    m_mode = mode;
+
+    auto file = std::make_unique<QFile>(filePath);
+    if (!file->open(QIODevice::ReadOnly)) {
+        m_errorString = file->errorString();
+        return false;
+    }
+
+    m_size = file->size();
+    if (m_size > 0) {
+        // MapPrivateOption gives a copy-on-write (MAP_PRIVATE / FILE_MAP_COPY) view
+        // that is writable even though the file itself is only open for reading.
+        const QFileDevice::MemoryMapFlags flags = mode == Mode::CopyOnWrite
+            ? QFileDevice::MapPrivateOption
+            : QFileDevice::NoOptions;
+        uchar *mapped = file->map(0, m_size, flags);
+        if (mapped) {
+            m_data = mapped;
+            m_file = std::move(file);
+        } else {
+            // Not every device can be mapped (pipes, some network shares), read it instead.
+            m_ownedData = file->readAll();
+            if (m_ownedData.size() != m_size) {
+                m_errorString = file->errorString();
+                reset();
+                return false;
+            }
+            m_data = reinterpret_cast<uchar *>(m_ownedData.data());
+        }
+    }
+
+    m_filePath = filePath;
+    m_open = true;
+    return true;
+}
+
+void NorImage::close()
+{
+    reset();
+    m_errorString.clear();
+}
+
+void NorImage::detach()
+{
+    if (!m_file) {
+        return;
+    }
+    m_ownedData = QByteArray(reinterpret_cast<const char *>(m_data), m_size);
+    m_data = reinterpret_cast<uchar *>(m_ownedData.data());
+    m_file.reset(); // Unmaps and closes the file
+}
+
+QByteArrayView NorImage::view() const
+{
+    return QByteArrayView(m_data, m_size);
+}
+
+QByteArrayView NorImage::view(qint64 offset, qint64 length) const
+{
+    if (offset < 0 || offset >= m_size || length <= 0) {
+        return QByteArrayView();
+    }
+    return QByteArrayView(m_data + offset, qMin(length, m_size - offset));
+}
+
+QByteArray NorImage::bytes() const
+{
+    return QByteArray::fromRawData(reinterpret_cast<const char *>(m_data), m_size);
+}
+
+void NorImage::reset()
+{
+    m_file.reset();
+    m_ownedData.clear();
+    m_data = nullptr;
+    m_size = 0;
+    m_open = false;
+    m_filePath.clear();
+}
@@ -0,0 +1,67 @@
+#ifndef NORIMAGE_H
+#define NORIMAGE_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QFile>
+#include <QString>
+#include <memory>
+
+// A NOR dump backed by a memory mapping of the file on disk.
+// ReadOnly maps the file shared and read-only (inspection, hex view).
+// CopyOnWrite maps it private, so edits only touch the pages they dirty and
+// never reach the file; the patcher writes the result out explicitly.
+// Views handed out by this class stay valid until close()/open()/detach().
+class NorImage
+{
+public:
+    enum class Mode {
+        ReadOnly,
+        CopyOnWrite
+    };
+
+    NorImage() = default;
+    ~NorImage();
+
+    NorImage(const NorImage &) = delete;
+    NorImage &operator=(const NorImage &) = delete;
+    NorImage(NorImage &&other) noexcept;
+    NorImage &operator=(NorImage &&other) noexcept;
+
+    bool open(const QString &filePath, Mode mode = Mode::ReadOnly);
+    void close();
+
+    // Copies the mapped bytes into memory owned by this object and releases
+    // the file, e.g. before the file itself is replaced on disk.
+    void detach();
+
+    bool isOpen() const { return m_open; }
+    bool isMapped() const { return m_file != nullptr; }
+    Mode mode() const { return m_mode; }
+    QString filePath() const { return m_filePath; }
+    QString errorString() const { return m_errorString; }
+
+    qint64 size() const { return m_size; }
+    const uchar *constData() const { return m_data; }
+    uchar *data() { return m_mode == Mode::CopyOnWrite ? m_data : nullptr; }
+
+    // Zero-copy views into the image. Out of range requests are clamped.
+    QByteArrayView view() const;
+    QByteArrayView view(qint64 offset, qint64 length) const;
+    // Wraps the image without copying (QByteArray::fromRawData).
+    QByteArray bytes() const;
+
+private:
+    void reset();
+
+    std::unique_ptr<QFile> m_file; // Keeps the mapping alive
+    QByteArray m_ownedData;        // Used when the file could not be mapped or after detach()
+    uchar *m_data = nullptr;
+    qint64 m_size = 0;
+    Mode m_mode = Mode::ReadOnly;
+    bool m_open = false;
+    QString m_filePath;
+    QString m_errorString;
+};
+
+#endif // NORIMAGE_H
@@ -0,0 +1,224 @@
+#include "norlayout.h"
+#include <cstring>
+
+namespace NorLayout {
+namespace {
+
+struct RegionCode {
+    char code[3];
+    const char *region;
+};
+
+// Same table as the legacy Form1.cs board variant switch
+constexpr RegionCode kRegions[] = {
+    { "00", "Japan" },
+    { "01", "US, Canada, (North America)" },
+    { "15", "US, Canada, (North America)" },
+    { "02", "Australia / New Zealand, (Oceania)" },
+    { "03", "United Kingdom / Ireland" },
+    { "04", "Europe / Middle East / Africa" },
+    { "05", "South Korea" },
+    { "06", "Southeast Asia / Hong Kong" },
+    { "07", "Taiwan" },
+    { "08", "Russia, Ukraine, India, Central Asia" },
+    { "09", "Mainland China" },
+    { "11", "Mexico, Central America, South America" },
+    { "14", "Mexico, Central America, South America" },
+    { "16", "Europe / Middle East / Africa" },
+    { "18", "Singapore, Korea, Asia" },
+};
+
+bool contains(const uchar *data, quint32 length, const uchar (&pattern)[4])
+{
+    for (quint32 i = 0; i + sizeof(pattern) <= length; ++i) {
+        if (std::memcmp(data + i, pattern, sizeof(pattern)) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+Edition decodeEdition(const uchar *data, quint32 length)
+{
+    if (contains(data, length, kDiscEditionFlag)) {
+        return Edition::Disc;
+    }
+    if (contains(data, length, kDigitalEditionFlag)) {
+        return Edition::Digital;
+    }
+    return Edition::Unknown;
+}
+
+void decodeText(const uchar *data, quint32 length, bool skipErased, FieldText &out)
+{
+    out.present = true;
+    for (quint32 i = 0; i < length && out.length < sizeof(out.text); ++i) {
+        const uchar c = data[i];
+        if (c == 0xFF && skipErased) {
+            continue;
+        }
+        if (c == 0x00) {
+            break;
+        }
+        out.text[out.length++] = (c >= 0x20 && c < 0x7F) ? char(c) : '?';
+    }
+    while (out.length > 0 && out.text[out.length - 1] == ' ') {
+        --out.length;
+    }
+}
+
+void decodeMac(const uchar *data, quint32 length, FieldText &out)
+{
+    static constexpr char digits[] = "0123456789ABCDEF";
+    out.present = true;
+    for (quint32 i = 0; i < length; ++i) {
+        if (i > 0) {
+            out.text[out.length++] = '-';
+        }
+        out.text[out.length++] = digits[data[i] >> 4];
+        out.text[out.length++] = digits[data[i] & 0x0F];
+    }
+}
+
+FieldText *textSlot(NorDetails &details, Field field)
+{
+    switch (field) {
+    case Field::LanMac:
+        return &details.lanMac;
+    case Field::MoboSerial:
+        return &details.moboSerial;
+    case Field::BoardSerial:
+        return &details.boardSerial;
+    case Field::Variant:
+        return &details.variant;
+    case Field::WifiMac:
+        return &details.wifiMac;
+    default:
+        return nullptr;
+    }
+}
+
+bool isBlankMac(const FieldText &mac)
+{
+    const QLatin1String text = mac.view();
+    return text == QLatin1String("FF-FF-FF-FF-FF-FF") || text == QLatin1String("00-00-00-00-00-00");
+}
+
+QString textOrUnknown(const FieldText &field)
+{
+    return field.present && field.length > 0 ? QString(field.view()) : QStringLiteral("Unknown");
+}
+
+} // namespace
+
+NorDetails parse(QByteArrayView image)
+{
+    NorDetails details;
+    details.imageSize = image.size();
+    const uchar *data = reinterpret_cast<const uchar *>(image.data());
+
+    Edition primary = Edition::Unknown;
+    for (const FieldDescriptor &field : kFields) {
+        if (qint64(field.offset) + field.length > image.size()) {
+            break; // Sorted by offset, so every later field is out of range as well
+        }
+        const uchar *bytes = data + field.offset;
+        switch (field.decode) {
+        case Decode::EditionFlag:
+            (field.field == Field::EditionFlag ? primary : details.backupEdition) = decodeEdition(bytes, field.length);
+            break;
+        case Decode::Ascii:
+        case Decode::AsciiStripFF:
+            decodeText(bytes, field.length, field.decode == Decode::AsciiStripFF, *textSlot(details, field.field));
+            break;
+        case Decode::Mac:
+            decodeMac(bytes, field.length, *textSlot(details, field.field));
+            break;
+        }
+    }
+
+    details.edition = primary != Edition::Unknown ? primary : details.backupEdition;
+    return details;
+}
+
+QVariantMap toVariantMap(const NorDetails &details)
+{
+    QVariantMap map;
+    map["model"] = QString::fromLatin1(editionName(details.edition));
+    map["moboSerial"] = textOrUnknown(details.moboSerial);
+    map["boardSerial"] = textOrUnknown(details.boardSerial);
+    map["wifiMac"] = textOrUnknown(details.wifiMac);
+    map["lanMac"] = textOrUnknown(details.lanMac);
+    map["variant"] = textOrUnknown(details.variant) + " - " + QString::fromLatin1(regionForVariant(details.variant.view()));
+    map["size"] = QString("%1 bytes (%2MB)").arg(details.imageSize).arg(details.imageSize / 1024.0 / 1024.0, 0, 'f', 2);
+    return map;
+}
+
+QStringList validate(const NorDetails &details)
+{
+    QStringList issues;
+    if (details.imageSize != kImageSize) {
+        issues << QString("Image is %1 bytes, expected %2").arg(details.imageSize).arg(kImageSize);
+    }
+    if (details.edition == Edition::Unknown) {
+        issues << "No edition flag found";
+    } else if (details.backupEdition == Edition::Unknown) {
+        issues << "Backup edition flag missing";
+    } else if (details.backupEdition != details.edition) {
+        issues << "Primary and backup edition flags differ";
+    }
+
+    const struct {
+        const FieldText &text;
+        Field field;
+    } fields[] = {
+        { details.moboSerial, Field::MoboSerial },
+        { details.boardSerial, Field::BoardSerial },
+        { details.variant, Field::Variant },
+        { details.wifiMac, Field::WifiMac },
+        { details.lanMac, Field::LanMac },
+    };
+    for (const auto &f : fields) {
+        const FieldDescriptor &d = descriptor(f.field);
+        if (!f.text.present) {
+            issues << QString("%1 is outside the image").arg(d.key);
+        } else if (d.decode == Decode::Mac ? isBlankMac(f.text) : f.text.length == 0) {
+            issues << QString("%1 is blank").arg(d.key);
+        } else if (f.text.view().contains(QLatin1Char('?'))) {
+            issues << QString("%1 contains non-printable bytes").arg(d.key);
+        }
+    }
+    return issues;
+}
+
+const char *editionName(Edition edition)
+{
+    switch (edition) {
+    case Edition::Disc:
+        return "Disc Edition";
+    case Edition::Digital:
+        return "Digital Edition";
+    case Edition::Unknown:
+        break;
+    }
+    return "Unknown";
+}
+
+const char *regionForVariant(QLatin1String variant)
+{
+    if (variant.size() < 3) {
+        return "Unknown Region";
+    }
+    const char *suffix = variant.data() + variant.size() - 3;
+    if (suffix[2] != 'A' && suffix[2] != 'B') {
+        return "Unknown Region";
+    }
+    for (const RegionCode &region : kRegions) {
+        if (suffix[0] == region.code[0] && suffix[1] == region.code[1]) {
+            return region.region;
+        }
+    }
+    return "Unknown Region";
+}
+
+} // namespace NorLayout
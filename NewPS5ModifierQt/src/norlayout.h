@@ -0,0 +1,120 @@
+#ifndef NORLAYOUT_H
+#define NORLAYOUT_H
+
+#include <QByteArrayView>
+#include <QString>
+#include <QStringList>
+#include <QVariantMap>
+#include <QtGlobal>
+
+// Where the console identity lives inside a PS5 NOR dump. The table replaces the
+// per-field seeks of the legacy Form1.cs; parse() walks it once, in offset order,
+// decoding straight from the image into fixed size buffers.
+namespace NorLayout {
+
+enum class Field : quint8 {
+    LanMac,
+    EditionFlag,
+    EditionFlagBackup,
+    MoboSerial,
+    BoardSerial,
+    Variant,
+    WifiMac,
+    Count
+};
+
+enum class Decode : quint8 {
+    EditionFlag,  // Contains 22020101 (disc) or 22030101 (digital)
+    Ascii,        // Text up to the first NUL
+    AsciiStripFF, // Text with erased (0xFF) bytes removed
+    Mac           // Six bytes printed as AA-BB-CC-DD-EE-FF
+};
+
+struct FieldDescriptor {
+    Field field;
+    const char *key;
+    quint32 offset;
+    quint32 length;
+    Decode decode;
+};
+
+inline constexpr FieldDescriptor kFields[] = {
+    { Field::LanMac,            "lanMac",            0x1C4020, 6,  Decode::Mac },
+    { Field::EditionFlag,       "editionFlag",       0x1C7010, 12, Decode::EditionFlag },
+    { Field::EditionFlagBackup, "editionFlagBackup", 0x1C7030, 12, Decode::EditionFlag },
+    { Field::MoboSerial,        "moboSerial",        0x1C7200, 16, Decode::Ascii },
+    { Field::BoardSerial,       "boardSerial",       0x1C7210, 17, Decode::Ascii },
+    { Field::Variant,           "variant",           0x1C7226, 19, Decode::AsciiStripFF },
+    { Field::WifiMac,           "wifiMac",           0x1C73C0, 6,  Decode::Mac },
+};
+
+inline constexpr int kFieldCount = int(sizeof(kFields) / sizeof(kFields[0]));
+
+constexpr bool fieldsAreOrdered()
+{
+    for (int i = 0; i < kFieldCount; ++i) {
+        if (int(kFields[i].field) != i) {
+            return false; // descriptor(field) indexes the table directly
+        }
+        if (i > 0 && kFields[i].offset < kFields[i - 1].offset + kFields[i - 1].length) {
+            return false; // parse() relies on a single forward walk without overlaps
+        }
+    }
+    return true;
+}
+static_assert(kFieldCount == int(Field::Count), "Every field needs a descriptor");
+static_assert(fieldsAreOrdered(), "Descriptors must be sorted by offset and must not overlap");
+
+constexpr const FieldDescriptor &descriptor(Field field)
+{
+    return kFields[int(field)];
+}
+
+// Byte range covering every field, e.g. to re-parse after an edit inside it.
+inline constexpr quint32 kSpanBegin = kFields[0].offset;
+inline constexpr quint32 kSpanEnd = kFields[kFieldCount - 1].offset + kFields[kFieldCount - 1].length;
+
+// Size of a complete PS5 NOR dump
+inline constexpr qint64 kImageSize = 0x200000;
+
+inline constexpr uchar kDiscEditionFlag[] = { 0x22, 0x02, 0x01, 0x01 };
+inline constexpr uchar kDigitalEditionFlag[] = { 0x22, 0x03, 0x01, 0x01 };
+
+enum class Edition : quint8 {
+    Unknown,
+    Disc,
+    Digital
+};
+
+struct FieldText {
+    char text[24] = {};
+    quint8 length = 0;
+    bool present = false; // False when the image is too small to contain the field
+
+    QLatin1String view() const { return QLatin1String(text, length); }
+};
+
+struct NorDetails {
+    qint64 imageSize = 0;
+    Edition edition = Edition::Unknown;       // From the primary flag, falling back to the backup
+    Edition backupEdition = Edition::Unknown;
+    FieldText moboSerial;
+    FieldText boardSerial;
+    FieldText variant;
+    FieldText wifiMac;
+    FieldText lanMac;
+};
+
+NorDetails parse(QByteArrayView image);
+QVariantMap toVariantMap(const NorDetails &details);
+// Human readable problems with a parsed dump (wrong size, missing or inconsistent
+// edition flags, blank or garbled identity fields); empty when it looks sane.
+QStringList validate(const NorDetails &details);
+
+const char *editionName(Edition edition);
+// Sales region encoded in the last three characters of the board variant (e.g. "CFI-1016A").
+const char *regionForVariant(QLatin1String variant);
+
+} // namespace NorLayout
+
+#endif // NORLAYOUT_H
@@ -0,0 +1,276 @@
+#include "norpatch.h"
+#include "norimage.h"
+#include "norlayout.h"
+#include "norsearch.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <algorithm>
+#include <cstring>
+
+#if defined(Q_OS_UNIX)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#if defined(Q_OS_LINUX)
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#endif
+
+namespace NorPatch {
+namespace {
+
+const NorLayout::FieldDescriptor *findField(const QString &key)
+{
+    for (const NorLayout::FieldDescriptor &field : NorLayout::kFields) {
+        if (key == QLatin1String(field.key)) {
+            return &field;
+        }
+    }
+    return nullptr;
+}
+
+bool fail(QString *errorString, const QString &message)
+{
+    if (errorString) {
+        *errorString = message;
+    }
+    return false;
+}
+
+// Flips the edition flag in both flag copies, like the legacy find/replace of 22020101 <-> 22030101,
+// but only inside the two flag fields. Both flags are matched in one pass per field.
+bool setEdition(uchar *image, qint64 imageSize, const QString &value, QList<Range> &ranges, QString *errorString)
+{
+    const uchar *to = nullptr;
+    const uchar *from = nullptr;
+    if (value.startsWith("Disc", Qt::CaseInsensitive)) {
+        to = NorLayout::kDiscEditionFlag;
+        from = NorLayout::kDigitalEditionFlag;
+    } else if (value.startsWith("Digital", Qt::CaseInsensitive)) {
+        to = NorLayout::kDigitalEditionFlag;
+        from = NorLayout::kDiscEditionFlag;
+    } else {
+        return fail(errorString, "Unknown console model: " + value);
+    }
+    constexpr qint64 flagSize = sizeof(NorLayout::kDiscEditionFlag);
+
+    NorSearch::PatternSet flags;
+    flags.build({ QByteArray(reinterpret_cast<const char *>(from), flagSize),
+                  QByteArray(reinterpret_cast<const char *>(to), flagSize) });
+    bool found = false;
+    for (NorLayout::Field flag : { NorLayout::Field::EditionFlag, NorLayout::Field::EditionFlagBackup }) {
+        const NorLayout::FieldDescriptor &field = NorLayout::descriptor(flag);
+        if (qint64(field.offset) + field.length > imageSize) {
+            continue;
+        }
+        const QByteArrayView window(image + field.offset, field.length);
+        for (const NorSearch::Hit &hit : flags.findAll(window)) {
+            if (hit.pattern == 0) {
+                writeBytes(image, field.offset + hit.offset, to, flagSize, ranges);
+            }
+            found = true; // Pattern 1 means the copy already is the requested edition
+        }
+    }
+    return found || fail(errorString, "No edition flag found, the dump does not look like a PS5 NOR.");
+}
+
+bool parseMac(const QString &value, uchar (&mac)[6])
+{
+    QString digits = value;
+    digits.remove('-').remove(':').remove(' ');
+    if (digits.size() != 12) {
+        return false;
+    }
+    for (int i = 0; i < 6; ++i) {
+        bool ok = false;
+        mac[i] = uchar(digits.mid(i * 2, 2).toUInt(&ok, 16));
+        if (!ok) {
+            return false;
+        }
+    }
+    return true;
+}
+
+#if defined(Q_OS_LINUX)
+// Makes destinationFd a copy of sourcePath without moving the data through user space:
+// a reflink where the file system supports it, an in-kernel copy otherwise.
+bool cloneInto(const QString &sourcePath, int destinationFd, qint64 size)
+{
+    QFile source(sourcePath);
+    if (!source.open(QIODevice::ReadOnly) || source.size() != size) {
+        return false;
+    }
+    const int sourceFd = source.handle();
+#ifdef FICLONE
+    if (::ioctl(destinationFd, FICLONE, sourceFd) == 0) {
+        return true; // Shares the extents, nothing is copied
+    }
+#endif
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 27))
+    loff_t in = 0;
+    loff_t out = 0;
+    while (in < size) {
+        if (::copy_file_range(sourceFd, &in, destinationFd, &out, size_t(size - in), 0) <= 0) {
+            return false;
+        }
+    }
+    return true;
+#else
+    Q_UNUSED(destinationFd);
+    return false;
+#endif
+}
+#else
+bool cloneInto(const QString &, int, qint64)
+{
+    return false;
+}
+#endif
+
+// The rename itself is only durable once the directory entry is on disk.
+void syncParentDirectory(const QString &filePath)
+{
+#if defined(Q_OS_UNIX)
+    const QByteArray directory = QFile::encodeName(QFileInfo(filePath).absolutePath());
+    const int fd = ::open(directory.constData(), O_RDONLY | O_DIRECTORY);
+    if (fd >= 0) {
+        ::fsync(fd);
+        ::close(fd);
+    }
+#else
+    Q_UNUSED(filePath);
+#endif
+}
+
+} // namespace
+
+void addRange(QList<Range> &ranges, qint64 offset, qint64 length)
+{
+    if (length <= 0) {
+        return;
+    }
+    Range merged{ offset, length };
+    // First range that ends at or after the new one starts, i.e. may touch it
+    auto first = std::lower_bound(ranges.begin(), ranges.end(), offset,
+                                  [](const Range &range, qint64 value) { return range.end() < value; });
+    auto last = first;
+    while (last != ranges.end() && last->offset <= merged.end()) {
+        const qint64 end = qMax(merged.end(), last->end());
+        merged.offset = qMin(merged.offset, last->offset);
+        merged.length = end - merged.offset;
+        ++last;
+    }
+    first = ranges.erase(first, last);
+    ranges.insert(first, merged);
+}
+
+void writeBytes(uchar *image, qint64 offset, const uchar *bytes, qint64 length, QList<Range> &ranges)
+{
+    qint64 begin = 0;
+    while (begin < length && image[offset + begin] == bytes[begin]) {
+        ++begin;
+    }
+    qint64 end = length;
+    while (end > begin && image[offset + end - 1] == bytes[end - 1]) {
+        --end;
+    }
+    if (begin == end) {
+        return; // Nothing changes, keep the page clean
+    }
+    std::memcpy(image + offset + begin, bytes + begin, size_t(end - begin));
+    addRange(ranges, offset + begin, end - begin);
+}
+
+bool applyModifications(uchar *image, qint64 imageSize, const QVariantMap &modifications,
+                        QList<Range> *dirtyRanges, QString *errorString)
+{
+    if (!image) {
+        return fail(errorString, "The image is not writable.");
+    }
+
+    QList<Range> ranges;
+    for (auto it = modifications.cbegin(); it != modifications.cend(); ++it) {
+        const QString value = it.value().toString().trimmed();
+        if (it.key() == "model") {
+            if (!setEdition(image, imageSize, value, ranges, errorString)) {
+                return false;
+            }
+            continue;
+        }
+
+        const NorLayout::FieldDescriptor *field = findField(it.key());
+        if (!field || field->decode == NorLayout::Decode::EditionFlag) {
+            return fail(errorString, "Unknown modification: " + it.key());
+        }
+        if (qint64(field->offset) + field->length > imageSize) {
+            return fail(errorString, QString("The dump is too small to contain %1.").arg(it.key()));
+        }
+
+        uchar bytes[32];
+        std::memset(bytes, 0, sizeof(bytes));
+        if (field->decode == NorLayout::Decode::Mac) {
+            uchar mac[6];
+            if (!parseMac(value, mac)) {
+                return fail(errorString, "Invalid MAC address: " + value);
+            }
+            std::memcpy(bytes, mac, sizeof(mac));
+        } else {
+            // Parsed variants carry a " - Region" suffix, only the code is stored
+            const QString text = it.key() == "variant" ? value.section(" - ", 0, 0) : value;
+            if (text.size() > qsizetype(field->length)) {
+                return fail(errorString, QString("%1 is longer than %2 characters.").arg(it.key()).arg(field->length));
+            }
+            for (qsizetype i = 0; i < text.size(); ++i) {
+                const char16_t c = text.at(i).unicode();
+                if (c < 0x20 || c >= 0x7F) {
+                    return fail(errorString, QString("%1 may only contain printable ASCII characters.").arg(it.key()));
+                }
+                bytes[i] = uchar(c);
+            }
+            if (field->decode == NorLayout::Decode::AsciiStripFF) {
+                std::memset(bytes + text.size(), 0xFF, field->length - text.size()); // Erased padding
+            }
+        }
+        writeBytes(image, field->offset, bytes, field->length, ranges);
+    }
+
+    if (dirtyRanges) {
+        for (const Range &range : ranges) {
+            addRange(*dirtyRanges, range.offset, range.length);
+        }
+    }
+    return true;
+}
+
+bool writePatchedCopy(const QString &sourcePath, const QString &destinationPath, const NorImage &image,
+                      const QList<Range> &dirtyRanges, QString *errorString)
+{
+    QSaveFile file(destinationPath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return fail(errorString, file.errorString());
+    }
+
+    const char *data = reinterpret_cast<const char *>(image.constData());
+    if (cloneInto(sourcePath, file.handle(), image.size())) {
+        for (const Range &range : dirtyRanges) {
+            if (range.end() > image.size() || !file.seek(range.offset)
+                || file.write(data + range.offset, range.length) != range.length) {
+                file.cancelWriting();
+                return fail(errorString, file.errorString());
+            }
+        }
+    } else if (!file.seek(0) || file.write(data, image.size()) != image.size()) {
+        // No cheap copy available (or it failed half way), the image already holds every edit
+        file.cancelWriting();
+        return fail(errorString, file.errorString());
+    }
+
+    if (!file.commit()) { // Flushes, fsyncs and renames over the destination
+        return fail(errorString, file.errorString());
+    }
+    syncParentDirectory(destinationPath);
+    return true;
+}
+
+} // namespace NorPatch
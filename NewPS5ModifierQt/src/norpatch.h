@@ -0,0 +1,44 @@
+#ifndef NORPATCH_H
+#define NORPATCH_H
+
+#include <QList>
+#include <QString>
+#include <QVariantMap>
+#include <QtGlobal>
+
+class NorImage;
+
+// Field level modifications of a NOR image and a writer that only touches the
+// bytes that actually changed.
+namespace NorPatch {
+
+struct Range {
+    qint64 offset = 0;
+    qint64 length = 0;
+
+    qint64 end() const { return offset + length; }
+};
+
+// Inserts a range, keeping the list sorted and merging overlapping or adjacent ranges.
+void addRange(QList<Range> &ranges, qint64 offset, qint64 length);
+
+// Overwrites bytes in place and records the range if they differ.
+void writeBytes(uchar *image, qint64 offset, const uchar *bytes, qint64 length, QList<Range> &ranges);
+
+// Applies modifications keyed like the parseNorDetails() map: "model" ("Disc Edition" /
+// "Digital Edition"), "moboSerial", "boardSerial", "variant", "wifiMac" and "lanMac".
+// Writes into the image and appends every changed byte range to dirtyRanges.
+bool applyModifications(uchar *image, qint64 imageSize, const QVariantMap &modifications,
+                        QList<Range> *dirtyRanges, QString *errorString);
+
+// Produces destinationPath as a copy of sourcePath with the dirty ranges taken from image.
+// The copy is a reflink or in-kernel copy where the platform offers one, otherwise the
+// whole image is written from memory. The result goes to a temporary file that is
+// fsynced and atomically renamed over the destination, so a crash never leaves a
+// truncated dump behind.
+bool writePatchedCopy(const QString &sourcePath, const QString &destinationPath, const NorImage &image,
+                      const QList<Range> &dirtyRanges, QString *errorString);
+
+} // namespace NorPatch
+
+#endif // NORPATCH_H
@@ -0,0 +1,346 @@
+#include "norsearch.h"
+#include "noredithistory.h"
+#include <QRegularExpression>
+#include <QtAlgorithms>
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NORSEARCH_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace NorSearch {
+namespace {
+
+bool fail(QString *errorString, const QString &message)
+{
+    if (errorString) {
+        *errorString = message;
+    }
+    return false;
+}
+
+int hexValue(QChar c)
+{
+    const char16_t u = c.unicode();
+    if (u >= '0' && u <= '9') {
+        return u - '0';
+    }
+    if (u >= 'a' && u <= 'f') {
+        return u - 'a' + 10;
+    }
+    if (u >= 'A' && u <= 'F') {
+        return u - 'A' + 10;
+    }
+    return -1;
+}
+
+// One needle, prepared once and then searched for repeatedly
+class Searcher
+{
+public:
+    explicit Searcher(QByteArrayView needle)
+        : m_needle(reinterpret_cast<const uchar *>(needle.data())), m_length(needle.size())
+    {
+#ifndef NORSEARCH_SSE2
+        std::fill(std::begin(m_shift), std::end(m_shift), m_length);
+        for (qint64 k = 0; k + 1 < m_length; ++k) {
+            m_shift[m_needle[k]] = m_length - 1 - k;
+        }
+#endif
+    }
+
+    qint64 next(const uchar *data, qint64 size, qint64 from) const
+    {
+        if (m_length == 0 || from < 0 || m_length > size - from) {
+            return -1;
+        }
+        if (m_length == 1) {
+            const void *hit = std::memchr(data + from, m_needle[0], size_t(size - from));
+            return hit ? static_cast<const uchar *>(hit) - data : -1;
+        }
+
+        const qint64 last = size - m_length; // Last possible start
+        const uchar head = m_needle[0];
+        const uchar tail = m_needle[m_length - 1];
+        qint64 i = from;
+#ifdef NORSEARCH_SSE2
+        // Positions whose first and last byte both match are rare; only those get a memcmp
+        const __m128i first = _mm_set1_epi8(char(head));
+        const __m128i lastByte = _mm_set1_epi8(char(tail));
+        for (; i + 15 <= last; i += 16) {
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+            const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i + m_length - 1));
+            quint32 mask = quint32(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, first), _mm_cmpeq_epi8(b, lastByte))));
+            while (mask) {
+                const qint64 pos = i + qCountTrailingZeroBits(mask);
+                if (std::memcmp(data + pos + 1, m_needle + 1, size_t(m_length - 2)) == 0) {
+                    return pos;
+                }
+                mask &= mask - 1;
+            }
+        }
+        for (; i <= last; ++i) {
+            if (data[i] == head && data[i + m_length - 1] == tail
+                && std::memcmp(data + i + 1, m_needle + 1, size_t(m_length - 2)) == 0) {
+                return i;
+            }
+        }
+#else
+        while (i <= last) {
+            const uchar c = data[i + m_length - 1];
+            if (c == tail && std::memcmp(data + i, m_needle, size_t(m_length - 1)) == 0) {
+                return i;
+            }
+            i += m_shift[c];
+        }
+#endif
+        return -1;
+    }
+
+private:
+    const uchar *m_needle;
+    qint64 m_length;
+#ifndef NORSEARCH_SSE2
+    qint64 m_shift[256];
+#endif
+};
+
+} // namespace
+
+bool parsePattern(const QString &text, QByteArray *bytes, QString *errorString)
+{
+    const QString trimmed = text.trimmed();
+    QByteArray result;
+    if (trimmed.size() >= 2 && trimmed.startsWith('"') && trimmed.endsWith('"')) {
+        const QString ascii = trimmed.mid(1, trimmed.size() - 2);
+        for (QChar c : ascii) {
+            if (c.unicode() < 0x20 || c.unicode() >= 0x7F) {
+                return fail(errorString, "Text patterns may only contain printable ASCII characters.");
+            }
+            result.append(char(c.unicode()));
+        }
+    } else {
+        QString digits;
+        for (const QString &token : trimmed.split(QRegularExpression("[\\s,;:-]+"), Qt::SkipEmptyParts)) {
+            digits += token.startsWith("0x", Qt::CaseInsensitive) ? token.mid(2) : token;
+        }
+        if (digits.size() % 2 != 0) {
+            return fail(errorString, "Hex patterns need two digits per byte.");
+        }
+        for (qsizetype i = 0; i < digits.size(); i += 2) {
+            const int high = hexValue(digits.at(i));
+            const int low = hexValue(digits.at(i + 1));
+            if (high < 0 || low < 0) {
+                return fail(errorString, "Not a hex pattern: " + text);
+            }
+            result.append(char(high << 4 | low));
+        }
+    }
+    if (result.isEmpty()) {
+        return fail(errorString, "The search pattern is empty.");
+    }
+    if (bytes) {
+        *bytes = result;
+    }
+    return true;
+}
+
+qint64 indexOf(QByteArrayView haystack, QByteArrayView needle, qint64 from)
+{
+    return Searcher(needle).next(reinterpret_cast<const uchar *>(haystack.data()), haystack.size(), from);
+}
+
+QList<qint64> findAll(QByteArrayView haystack, QByteArrayView needle, qsizetype maxHits)
+{
+    QList<qint64> hits;
+    const Searcher searcher(needle);
+    const auto *data = reinterpret_cast<const uchar *>(haystack.data());
+    for (qint64 pos = searcher.next(data, haystack.size(), 0); pos >= 0 && hits.size() != maxHits;
+         pos = searcher.next(data, haystack.size(), pos + 1)) {
+        hits.append(pos);
+    }
+    return hits;
+}
+
+bool replaceAll(uchar *image, qint64 imageSize, QByteArrayView find, QByteArrayView replace,
+                QList<NorPatch::Range> *dirtyRanges, int *replaced, QString *errorString,
+                NorEditHistory *history)
+{
+    if (replaced) {
+        *replaced = 0;
+    }
+    if (!image) {
+        return fail(errorString, "The image is not writable.");
+    }
+    if (find.isEmpty() || find.size() != replace.size()) {
+        return fail(errorString, QString("The replacement must be as long as the pattern (%1 bytes, not %2).")
+                                     .arg(find.size()).arg(replace.size()));
+    }
+
+    QList<NorPatch::Range> ranges;
+    int count = 0;
+    const Searcher searcher(find);
+    const auto *bytes = reinterpret_cast<const uchar *>(replace.data());
+    if (history) {
+        history->beginStep();
+    }
+    for (qint64 pos = searcher.next(image, imageSize, 0); pos >= 0; pos = searcher.next(image, imageSize, pos + find.size())) {
+        if (history) {
+            history->record(pos, find, replace); // The bytes at a hit are the pattern itself
+        }
+        NorPatch::writeBytes(image, pos, bytes, replace.size(), ranges);
+        ++count;
+    }
+    if (history) {
+        history->endStep();
+    }
+
+    if (dirtyRanges) {
+        for (const NorPatch::Range &range : ranges) {
+            NorPatch::addRange(*dirtyRanges, range.offset, range.length);
+        }
+    }
+    if (replaced) {
+        *replaced = count;
+    }
+    return true;
+}
+
+bool PatternSet::build(const QList<QByteArray> &patterns, QString *errorString)
+{
+    m_patterns.clear();
+    m_next.clear();
+    m_output.clear();
+    m_outputLink.clear();
+    m_firstBytes.clear();
+
+    qsizetype totalBytes = 0;
+    for (const QByteArray &pattern : patterns) {
+        if (pattern.isEmpty()) {
+            return fail(errorString, "Search patterns must not be empty.");
+        }
+        totalBytes += pattern.size();
+    }
+    if (totalBytes > MaxTotalBytes) {
+        return fail(errorString, QString("The search patterns are longer than %1 bytes in total.").arg(MaxTotalBytes));
+    }
+
+    // Trie first, -1 marks a missing edge
+    std::vector<qint32> next(256, -1);
+    std::vector<qint32> output(1, -1);
+    for (qsizetype id = 0; id < patterns.size(); ++id) {
+        qint32 state = 0;
+        for (char c : patterns.at(id)) {
+            qint32 &edge = next[size_t(state) * 256 + uchar(c)];
+            if (edge < 0) {
+                edge = qint32(output.size());
+                output.push_back(-1);
+                next.resize(next.size() + 256, -1);
+            }
+            state = edge;
+        }
+        if (output[size_t(state)] >= 0) {
+            return fail(errorString, "Duplicate search pattern: " + QString::fromLatin1(patterns.at(id).toHex(' ')));
+        }
+        output[size_t(state)] = qint32(id);
+    }
+
+    // Breadth first, so every failure state is complete before it is used. Missing
+    // edges are filled with the failure state's transition, turning the trie into a DFA.
+    std::vector<qint32> failure(output.size(), 0);
+    std::vector<qint32> outputLink(output.size(), -1);
+    std::vector<qint32> queue;
+    queue.reserve(output.size());
+    for (int c = 0; c < 256; ++c) {
+        qint32 &edge = next[size_t(c)];
+        if (edge < 0) {
+            edge = 0;
+        } else {
+            queue.push_back(edge);
+            m_firstBytes.append(char(c));
+        }
+    }
+    for (size_t head = 0; head < queue.size(); ++head) {
+        const qint32 state = queue[head];
+        for (int c = 0; c < 256; ++c) {
+            qint32 &edge = next[size_t(state) * 256 + c];
+            const qint32 fallback = next[size_t(failure[size_t(state)]) * 256 + c];
+            if (edge < 0) {
+                edge = fallback;
+                continue;
+            }
+            failure[size_t(edge)] = fallback;
+            outputLink[size_t(edge)] = output[size_t(fallback)] >= 0 ? fallback : outputLink[size_t(fallback)];
+            queue.push_back(edge);
+        }
+    }
+
+    m_patterns = patterns;
+    m_next = std::move(next);
+    m_output = std::move(output);
+    m_outputLink = std::move(outputLink);
+    return true;
+}
+
+// In the root state only a pattern's first byte can make progress, and erased or
+// zeroed flash rarely holds one, so the scan jumps straight to the next candidate.
+qint64 PatternSet::skipToCandidate(const uchar *data, qint64 from, qint64 size) const
+{
+    qint64 i = from;
+#ifdef NORSEARCH_SSE2
+    if (m_firstBytes.size() <= 4) {
+        __m128i wanted[4];
+        for (qsizetype k = 0; k < 4; ++k) {
+            wanted[k] = _mm_set1_epi8(m_firstBytes.at(std::min(k, m_firstBytes.size() - 1)));
+        }
+        for (; i + 16 <= size; i += 16) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+            const __m128i any = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, wanted[0]), _mm_cmpeq_epi8(v, wanted[1])),
+                                             _mm_or_si128(_mm_cmpeq_epi8(v, wanted[2]), _mm_cmpeq_epi8(v, wanted[3])));
+            const quint32 mask = quint32(_mm_movemask_epi8(any));
+            if (mask) {
+                return i + qCountTrailingZeroBits(mask);
+            }
+        }
+    }
+#endif
+    const qint32 *root = m_next.data();
+    while (i < size && root[data[i]] == 0) {
+        ++i;
+    }
+    return i;
+}
+
+QList<Hit> PatternSet::findAll(QByteArrayView haystack, qsizetype maxHits) const
+{
+    QList<Hit> hits;
+    if (m_patterns.isEmpty()) {
+        return hits;
+    }
+    const auto *data = reinterpret_cast<const uchar *>(haystack.data());
+    const qint64 size = haystack.size();
+    qint32 state = 0;
+    for (qint64 i = 0; i < size && hits.size() != maxHits; ++i) {
+        if (state == 0) {
+            i = skipToCandidate(data, i, size);
+            if (i == size) {
+                break;
+            }
+        }
+        state = m_next[size_t(state) * 256 + data[i]];
+        qint32 match = m_output[size_t(state)] >= 0 ? state : m_outputLink[size_t(state)];
+        for (; match >= 0 && hits.size() != maxHits; match = m_outputLink[size_t(match)]) {
+            const qint32 id = m_output[size_t(match)];
+            hits.append({ i + 1 - m_patterns.at(id).size(), id });
+        }
+    }
+    // Matches come out by end offset; shorter patterns can start later than longer ones
+    std::sort(hits.begin(), hits.end(), [](const Hit &a, const Hit &b) {
+        return a.offset != b.offset ? a.offset < b.offset : a.pattern < b.pattern;
+    });
+    return hits;
+}
+
+} // namespace NorSearch
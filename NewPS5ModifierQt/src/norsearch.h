@@ -0,0 +1,70 @@
+#ifndef NORSEARCH_H
+#define NORSEARCH_H
+
+#include "norpatch.h"
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QList>
+#include <QString>
+#include <QtGlobal>
+#include <vector>
+
+class NorEditHistory;
+
+// Byte pattern search over raw NOR images. A single pattern is found with a 16-byte
+// first/last byte filter (SSE2) or Horspool skipping where SSE2 is missing; several
+// patterns at once go through one Aho-Corasick automaton, so the image is read once
+// no matter how many patterns there are. Both report overlapping matches.
+namespace NorSearch {
+
+// Accepts hex bytes with optional 0x prefixes and space, comma, colon, dash or
+// semicolon separators ("22 02 01 01", "0x22,0x02"), or text in double quotes for
+// ASCII ("\"CFI-1016A\"").
+bool parsePattern(const QString &text, QByteArray *bytes, QString *errorString = nullptr);
+
+// Offset of the first match at or after from, -1 if there is none or needle is empty.
+qint64 indexOf(QByteArrayView haystack, QByteArrayView needle, qint64 from = 0);
+
+// Every match in ascending order, at most maxHits of them (-1 for no limit).
+QList<qint64> findAll(QByteArrayView haystack, QByteArrayView needle, qsizetype maxHits = -1);
+
+// Replaces every non-overlapping match of find with replace, which must have the
+// same length: a NOR image never changes size. Only bytes that actually change are
+// written and recorded in dirtyRanges, as NorPatch::writeBytes() does. With a history
+// every replacement is recorded there too, as one undo step.
+bool replaceAll(uchar *image, qint64 imageSize, QByteArrayView find, QByteArrayView replace,
+                QList<NorPatch::Range> *dirtyRanges, int *replaced = nullptr, QString *errorString = nullptr,
+                NorEditHistory *history = nullptr);
+
+struct Hit {
+    qint64 offset = 0;
+    int pattern = 0; // Index into the list given to PatternSet::build()
+};
+
+class PatternSet
+{
+public:
+    // The automaton keeps a 256-entry row per trie node, so the total pattern length is capped
+    static constexpr int MaxTotalBytes = 4096;
+
+    bool build(const QList<QByteArray> &patterns, QString *errorString = nullptr);
+
+    bool isEmpty() const { return m_patterns.isEmpty(); }
+    const QList<QByteArray> &patterns() const { return m_patterns; }
+
+    // Hits sorted by offset, then pattern; at most maxHits of them (-1 for no limit).
+    QList<Hit> findAll(QByteArrayView haystack, qsizetype maxHits = -1) const;
+
+private:
+    qint64 skipToCandidate(const uchar *data, qint64 from, qint64 size) const;
+
+    QList<QByteArray> m_patterns;
+    std::vector<qint32> m_next;       // Dense transition table, state * 256 + byte
+    std::vector<qint32> m_output;     // Pattern ending in the state, -1 if none
+    std::vector<qint32> m_outputLink; // Nearest proper suffix state with an output, -1 if none
+    QByteArray m_firstBytes;          // Distinct first bytes, drives the root state skip
+};
+
+} // namespace NorSearch
+
+#endif // NORSEARCH_H
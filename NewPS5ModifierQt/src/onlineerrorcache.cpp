@@ -0,0 +1,163 @@
+#include "onlineerrorcache.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <algorithm>
+
+namespace {
+
+constexpr int kFormatVersion = 1;
+
+} // namespace
+
+OnlineErrorCache::OnlineErrorCache(int capacity) : m_capacity(std::max(1, capacity))
+{
+}
+
+QString OnlineErrorCache::normalizeCode(const QString &code)
+{
+    return code.trimmed().toUpper();
+}
+
+bool OnlineErrorCache::find(const QString &code, Entry *entry, qint64 now)
+{
+    auto it = m_entries.find(code);
+    if (it == m_entries.end()) {
+        return false;
+    }
+    if (!isFresh(it->entry, now)) {
+        m_order.erase(it->position);
+        m_entries.erase(it);
+        m_dirty = true;
+        return false;
+    }
+    m_order.splice(m_order.begin(), m_order, it->position); // Iterators stay valid
+    if (entry) {
+        *entry = it->entry;
+    }
+    return true;
+}
+
+void OnlineErrorCache::insert(const QString &code, const Entry &entry)
+{
+    auto it = m_entries.find(code);
+    if (it != m_entries.end()) {
+        it->entry = entry;
+        m_order.splice(m_order.begin(), m_order, it->position);
+    } else {
+        m_order.push_front(code);
+        m_entries.insert(code, { entry, m_order.begin() });
+        evict();
+    }
+    m_dirty = true;
+}
+
+void OnlineErrorCache::clear()
+{
+    m_dirty = m_dirty || !m_entries.isEmpty();
+    m_entries.clear();
+    m_order.clear();
+}
+
+void OnlineErrorCache::setTtl(qint64 foundSeconds, qint64 notFoundSeconds)
+{
+    m_ttl = foundSeconds;
+    m_notFoundTtl = notFoundSeconds;
+}
+
+bool OnlineErrorCache::isFresh(const Entry &entry, qint64 now) const
+{
+    const qint64 age = now - entry.fetchedAt;
+    return age >= 0 && age < (entry.found ? m_ttl : m_notFoundTtl);
+}
+
+void OnlineErrorCache::evict()
+{
+    while (int(m_order.size()) > m_capacity) {
+        m_entries.remove(m_order.back());
+        m_order.pop_back();
+    }
+}
+
+bool OnlineErrorCache::load(const QString &path, qint64 now, QString *errorString)
+{
+    m_entries.clear();
+    m_order.clear();
+    m_dirty = false;
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (errorString && file.exists()) {
+            *errorString = file.errorString();
+        }
+        return !file.exists();
+    }
+    QJsonParseError parseError;
+    const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (parseError.error != QJsonParseError::NoError || document.object().value("version").toInt() != kFormatVersion) {
+        if (errorString) {
+            *errorString = parseError.error != QJsonParseError::NoError ? parseError.errorString() : QString("Unsupported cache version");
+        }
+        return false;
+    }
+
+    // Saved most recently used first; appending keeps that order
+    const QJsonArray entries = document.object().value("entries").toArray();
+    for (const QJsonValue &value : entries) {
+        const QJsonObject object = value.toObject();
+        const QString code = normalizeCode(object.value("code").toString());
+        Entry entry;
+        entry.description = object.value("description").toString();
+        entry.found = object.value("found").toBool();
+        entry.fetchedAt = qint64(object.value("fetchedAt").toDouble());
+        if (code.isEmpty() || m_entries.contains(code) || !isFresh(entry, now)) {
+            m_dirty = true;
+            continue;
+        }
+        m_order.push_back(code);
+        m_entries.insert(code, { entry, std::prev(m_order.end()) });
+        if (int(m_order.size()) >= m_capacity) {
+            break;
+        }
+    }
+    return true;
+}
+
+bool OnlineErrorCache::save(const QString &path, QString *errorString)
+{
+    QJsonArray entries;
+    for (const QString &code : m_order) {
+        const Entry &entry = m_entries.value(code).entry;
+        QJsonObject object;
+        object.insert("code", code);
+        object.insert("description", entry.description);
+        object.insert("found", entry.found);
+        object.insert("fetchedAt", double(entry.fetchedAt));
+        entries.append(object);
+    }
+    QJsonObject root;
+    root.insert("version", kFormatVersion);
+    root.insert("entries", entries);
+
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (errorString) {
+            *errorString = file.errorString();
+        }
+        return false;
+    }
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    if (!file.commit()) {
+        if (errorString) {
+            *errorString = file.errorString();
+        }
+        return false;
+    }
+    m_dirty = false;
+    return true;
+}
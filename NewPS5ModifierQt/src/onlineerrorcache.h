@@ -0,0 +1,65 @@
+#ifndef ONLINEERRORCACHE_H
+#define ONLINEERRORCACHE_H
+
+#include <QHash>
+#include <QString>
+#include <QtGlobal>
+#include <list>
+
+// Results of uartcodes.com lookups, least recently used evicted first. Entries expire
+// after a TTL (shorter for codes the server did not know, so new database entries show
+// up). The cache is saved as JSON and loaded on the next run; only answers from the
+// server are stored, never network errors.
+class OnlineErrorCache
+{
+public:
+    struct Entry {
+        QString description;
+        bool found = false;    // False: the server answered but did not know the code
+        qint64 fetchedAt = 0;  // Seconds since the epoch
+    };
+
+    static constexpr int DefaultCapacity = 512;
+    static constexpr qint64 DefaultTtlSeconds = 7 * 24 * 3600;
+    static constexpr qint64 DefaultNotFoundTtlSeconds = 24 * 3600;
+
+    explicit OnlineErrorCache(int capacity = DefaultCapacity);
+
+    // Upper-cased and trimmed; used as the cache key and for the request.
+    static QString normalizeCode(const QString &code);
+
+    // Fresh entry for code (already normalized), marked most recently used.
+    bool find(const QString &code, Entry *entry, qint64 now);
+    void insert(const QString &code, const Entry &entry);
+    void clear();
+
+    int size() const { return int(m_entries.size()); }
+    int capacity() const { return m_capacity; }
+    bool isDirty() const { return m_dirty; }
+
+    void setTtl(qint64 foundSeconds, qint64 notFoundSeconds);
+
+    // Missing or unreadable files leave the cache empty; expired entries are dropped.
+    bool load(const QString &path, qint64 now, QString *errorString = nullptr);
+    bool save(const QString &path, QString *errorString = nullptr);
+
+private:
+    using Order = std::list<QString>; // Front is most recently used
+
+    struct Node {
+        Entry entry;
+        Order::iterator position;
+    };
+
+    bool isFresh(const Entry &entry, qint64 now) const;
+    void evict();
+
+    int m_capacity;
+    qint64 m_ttl = DefaultTtlSeconds;
+    qint64 m_notFoundTtl = DefaultNotFoundTtlSeconds;
+    QHash<QString, Node> m_entries;
+    Order m_order;
+    bool m_dirty = false;
+};
+
+#endif // ONLINEERRORCACHE_H
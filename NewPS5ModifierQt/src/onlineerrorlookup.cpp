@@ -0,0 +1,265 @@
+#include "onlineerrorlookup.h"
+#include "tracer.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QTimer>
+#include <QUrlQuery>
+#include <QXmlStreamReader>
+#include <algorithm>
+
+OnlineErrorLookup::OnlineErrorLookup(QNetworkAccessManager *manager, QObject *parent)
+    : QObject(parent), m_manager(manager), m_saveTimer(new QTimer(this))
+{
+    qRegisterMetaType<OnlineErrorLookup::Result>();
+    qRegisterMetaType<QList<OnlineErrorLookup::Result>>();
+    m_saveTimer->setSingleShot(true);
+    m_saveTimer->setInterval(CacheSaveDelayMs);
+    connect(m_saveTimer, &QTimer::timeout, this, &OnlineErrorLookup::saveCache);
+}
+
+OnlineErrorLookup::~OnlineErrorLookup()
+{
+    for (QNetworkReply *reply : std::as_const(m_inFlight)) {
+        reply->disconnect(this);
+        reply->abort();
+        reply->deleteLater();
+    }
+    saveCache();
+}
+
+void OnlineErrorLookup::setCachePath(const QString &path)
+{
+    if (path == m_cachePath) {
+        return;
+    }
+    saveCache();
+    m_cachePath = path;
+    m_cacheLoaded = false;
+}
+
+void OnlineErrorLookup::setMaxConcurrent(int count)
+{
+    m_maxConcurrent = std::max(1, count);
+    pump();
+}
+
+void OnlineErrorLookup::ensureCacheLoaded()
+{
+    if (m_cacheLoaded) {
+        return;
+    }
+    m_cacheLoaded = true;
+    QString error;
+    if (!m_cachePath.isEmpty() && !m_cache.load(m_cachePath, QDateTime::currentSecsSinceEpoch(), &error)) {
+        qWarning() << "Ignoring online lookup cache" << m_cachePath << ":" << error;
+    }
+}
+
+bool OnlineErrorLookup::cached(const QString &code, Result *result)
+{
+    ensureCacheLoaded();
+    const QString key = OnlineErrorCache::normalizeCode(code);
+    OnlineErrorCache::Entry entry;
+    if (key.isEmpty() || !m_cache.find(key, &entry, QDateTime::currentSecsSinceEpoch())) {
+        return false;
+    }
+    if (result) {
+        *result = Result { key, entry.description, entry.found, true, QString() };
+    }
+    return true;
+}
+
+void OnlineErrorLookup::lookup(const QString &code)
+{
+    Result result;
+    if (cached(code, &result)) {
+        QTimer::singleShot(0, this, [this, result]() { emit resultReady(result); });
+        return;
+    }
+    enqueue(OnlineErrorCache::normalizeCode(code), true);
+}
+
+int OnlineErrorLookup::lookupBatch(const QStringList &codes)
+{
+    const int batchId = m_nextBatchId++;
+    Batch &batch = m_batches[batchId];
+    for (const QString &code : codes) {
+        const QString key = OnlineErrorCache::normalizeCode(code);
+        if (key.isEmpty()) {
+            continue;
+        }
+        batch.codes.append(key);
+        if (batch.results.contains(key) || m_batchWaiters.value(key).contains(batchId)) {
+            continue; // Duplicate within the batch
+        }
+        Result result;
+        if (cached(key, &result)) {
+            batch.results.insert(key, result);
+            continue;
+        }
+        m_batchWaiters[key].append(batchId);
+        ++batch.remaining;
+        enqueue(key, false);
+    }
+    if (batch.remaining == 0) {
+        QTimer::singleShot(0, this, [this, batchId]() { finishBatch(batchId); });
+    }
+    return batchId;
+}
+
+void OnlineErrorLookup::enqueue(const QString &code, bool urgent)
+{
+    if (m_inFlight.contains(code)) {
+        return; // Coalesced with the request already on the wire
+    }
+    const qsizetype queued = m_queue.indexOf(code);
+    if (queued >= 0) {
+        if (urgent && queued > 0) {
+            m_queue.move(queued, 0); // Someone is waiting on screen for this one
+        }
+        return;
+    }
+    if (urgent) {
+        m_queue.prepend(code);
+    } else {
+        m_queue.append(code);
+    }
+    pump();
+}
+
+void OnlineErrorLookup::pump()
+{
+    while (!m_queue.isEmpty() && m_inFlight.size() < m_maxConcurrent) {
+        const QString code = m_queue.takeFirst();
+        QUrl url = m_url;
+        QUrlQuery query(url);
+        query.addQueryItem("errorCode", code);
+        url.setQuery(query);
+
+        QNetworkRequest request(url);
+        request.setTransferTimeout(RequestTimeoutMs);
+        QNetworkReply *reply = m_manager->get(request);
+        ++m_requestsSent;
+        m_inFlight.insert(code, reply);
+        const qint64 traceStartNs = Tracer::isEnabled() ? Tracer::now() : -1;
+        connect(reply, &QNetworkReply::finished, this, [this, reply, code, traceStartNs]() {
+            if (traceStartNs >= 0) {
+                Tracer::instance().complete("onlineLookupReply", "network", traceStartNs);
+            }
+            onReplyFinished(reply, code);
+        });
+    }
+}
+
+void OnlineErrorLookup::onReplyFinished(QNetworkReply *reply, const QString &code)
+{
+    m_inFlight.remove(code);
+    reply->deleteLater();
+
+    Result result;
+    if (reply->error() == QNetworkReply::NoError) {
+        result = parseReply(reply->readAll(), code);
+    } else {
+        result.code = code;
+        result.errorString = reply->errorString();
+    }
+    if (result.ok()) {
+        m_cache.insert(code, { result.description, result.found, QDateTime::currentSecsSinceEpoch() });
+        scheduleSave();
+    }
+    deliver(result);
+    pump();
+}
+
+void OnlineErrorLookup::deliver(const Result &result)
+{
+    emit resultReady(result);
+    const QList<int> waiting = m_batchWaiters.take(result.code);
+    for (int batchId : waiting) {
+        auto it = m_batches.find(batchId);
+        if (it == m_batches.end()) {
+            continue;
+        }
+        it->results.insert(result.code, result);
+        if (--it->remaining == 0) {
+            finishBatch(batchId);
+        }
+    }
+}
+
+void OnlineErrorLookup::finishBatch(int batchId)
+{
+    const Batch batch = m_batches.take(batchId);
+    QList<Result> results;
+    results.reserve(batch.codes.size());
+    for (const QString &code : batch.codes) {
+        results.append(batch.results.value(code));
+    }
+    emit batchFinished(batchId, results);
+}
+
+void OnlineErrorLookup::scheduleSave()
+{
+    if (!m_cachePath.isEmpty() && !m_saveTimer->isActive()) {
+        m_saveTimer->start(); // One write per burst of answers
+    }
+}
+
+void OnlineErrorLookup::saveCache()
+{
+    m_saveTimer->stop();
+    if (m_cachePath.isEmpty() || !m_cache.isDirty()) {
+        return;
+    }
+    QString error;
+    if (!m_cache.save(m_cachePath, &error)) {
+        qWarning() << "Could not save online lookup cache" << m_cachePath << ":" << error;
+    }
+}
+
+OnlineErrorLookup::Result OnlineErrorLookup::parseReply(const QByteArray &data, const QString &code)
+{
+    // <errorCodes><errorCode><ErrorCode/><Description/></errorCode>...</errorCodes>; a
+    // reply with a single entry is taken as the answer even if the code is spelled differently
+    Result result;
+    result.code = code;
+    QXmlStreamReader xml(data);
+    QString firstDescription;
+    int entries = 0;
+    while (!xml.atEnd() && !xml.hasError()) {
+        if (xml.readNext() != QXmlStreamReader::StartElement || xml.name() != QLatin1String("errorCode")) {
+            continue;
+        }
+        QString entryCode;
+        QString description;
+        while (xml.readNextStartElement()) {
+            if (xml.name() == QLatin1String("ErrorCode")) {
+                entryCode = xml.readElementText().trimmed();
+            } else if (xml.name() == QLatin1String("Description")) {
+                description = xml.readElementText();
+            } else {
+                xml.skipCurrentElement();
+            }
+        }
+        if (entries++ == 0) {
+            firstDescription = description;
+        }
+        if (entryCode.compare(code, Qt::CaseInsensitive) == 0) {
+            result.description = description;
+            result.found = true;
+            return result;
+        }
+    }
+    if (xml.hasError()) {
+        result.errorString = "Error parsing XML response: " + xml.errorString();
+        return result;
+    }
+    if (entries == 1) {
+        result.description = firstDescription;
+        result.found = true;
+    }
+    return result;
+}
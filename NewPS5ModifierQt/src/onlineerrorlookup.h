@@ -0,0 +1,101 @@
+#ifndef ONLINEERRORLOOKUP_H
+#define ONLINEERRORLOOKUP_H
+
+#include "onlineerrorcache.h"
+#include <QHash>
+#include <QList>
+#include <QMetaType>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QUrl>
+
+class QNetworkAccessManager;
+class QNetworkReply;
+class QTimer;
+
+// Error code lookups against uartcodes.com. Answers are cached (OnlineErrorCache,
+// persisted), a code already on the wire is never requested twice, and at most
+// maxConcurrent() requests run at once; the rest wait in a queue where single
+// lookups go ahead of batch work.
+class OnlineErrorLookup : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Result {
+        QString code;
+        QString description;
+        bool found = false;
+        bool fromCache = false;
+        QString errorString; // Network or parse failure; such results are not cached
+
+        bool ok() const { return errorString.isEmpty(); }
+    };
+
+    static constexpr int DefaultMaxConcurrent = 4;
+    static constexpr int RequestTimeoutMs = 15000;
+    static constexpr int CacheSaveDelayMs = 2000;
+
+    explicit OnlineErrorLookup(QNetworkAccessManager *manager, QObject *parent = nullptr);
+    ~OnlineErrorLookup() override;
+
+    QUrl url() const { return m_url; }
+    void setUrl(const QUrl &url) { m_url = url; }
+    // Loaded on first use, written shortly after it changes and on destruction.
+    void setCachePath(const QString &path);
+
+    int maxConcurrent() const { return m_maxConcurrent; }
+    void setMaxConcurrent(int count);
+
+    // Fresh cached answer for code, without touching the network.
+    bool cached(const QString &code, Result *result);
+    // resultReady() follows, asynchronously even for cache hits.
+    void lookup(const QString &code);
+    // Resolves every distinct code, then emits batchFinished() with results in input order.
+    int lookupBatch(const QStringList &codes);
+
+    int inFlightCount() const { return int(m_inFlight.size()); }
+    int queuedCount() const { return int(m_queue.size()); }
+    quint64 requestsSent() const { return m_requestsSent; }
+
+signals:
+    void resultReady(const OnlineErrorLookup::Result &result);
+    void batchFinished(int batchId, const QList<OnlineErrorLookup::Result> &results);
+
+private:
+    struct Batch {
+        QStringList codes; // Normalized, in input order
+        QHash<QString, Result> results;
+        int remaining = 0;
+    };
+
+    void ensureCacheLoaded();
+    void enqueue(const QString &code, bool urgent);
+    void pump();
+    void onReplyFinished(QNetworkReply *reply, const QString &code);
+    void deliver(const Result &result);
+    void finishBatch(int batchId);
+    void scheduleSave();
+    void saveCache();
+    static Result parseReply(const QByteArray &data, const QString &code);
+
+    QNetworkAccessManager *m_manager;
+    QUrl m_url;
+    OnlineErrorCache m_cache;
+    QString m_cachePath;
+    bool m_cacheLoaded = false;
+    QTimer *m_saveTimer;
+    int m_maxConcurrent = DefaultMaxConcurrent;
+    QStringList m_queue;                     // Codes waiting for a free slot
+    QHash<QString, QNetworkReply *> m_inFlight;
+    QHash<int, Batch> m_batches;
+    QHash<QString, QList<int>> m_batchWaiters; // Code -> batches waiting for it
+    int m_nextBatchId = 1;
+    quint64 m_requestsSent = 0;
+};
+
+Q_DECLARE_METATYPE(OnlineErrorLookup::Result)
+
+#endif // ONLINEERRORLOOKUP_H
@@ -0,0 +1,58 @@
+#include "regionanalyzer.h"
+#include <QThread>
+#include <algorithm>
+
+RegionAnalyzer::RegionAnalyzer(QObject *parent) : QObject(parent)
+{
+    m_pool.setMaxThreadCount(std::max(1, QThread::idealThreadCount()));
+}
+
+RegionAnalyzer::~RegionAnalyzer()
+{
+    cancel();
+}
+
+void RegionAnalyzer::start(QByteArrayView image)
+{
+    cancel();
+    const qint64 blocks = NorAnalysis::blockCount(image.size());
+    if (blocks == 0) {
+        emit finished(0);
+        return;
+    }
+
+    auto job = std::make_shared<Job>();
+    job->pendingTasks = (blocks + BlocksPerTask - 1) / BlocksPerTask;
+    job->timer.start();
+    m_job = job;
+    for (qint64 first = 0; first < blocks; first += BlocksPerTask) {
+        const qint64 count = std::min(BlocksPerTask, blocks - first);
+        m_pool.start([this, job, image, first, count]() {
+            if (job->cancelled.load(std::memory_order_relaxed)) {
+                return;
+            }
+            QList<NorAnalysis::BlockStats> stats(count);
+            NorAnalysis::analyzeBlocks(image, first, count, stats.data());
+            QMetaObject::invokeMethod(this, [this, job, first, stats]() {
+                if (job != m_job) {
+                    return; // Cancelled or restarted after this batch was posted
+                }
+                emit blocksReady(first, stats);
+                if (--job->pendingTasks == 0) {
+                    m_job.reset();
+                    emit finished(job->timer.elapsed());
+                }
+            }, Qt::QueuedConnection);
+        });
+    }
+}
+
+void RegionAnalyzer::cancel()
+{
+    if (m_job) {
+        m_job->cancelled.store(true, std::memory_order_relaxed);
+        m_job.reset();
+    }
+    m_pool.clear();
+    m_pool.waitForDone();
+}
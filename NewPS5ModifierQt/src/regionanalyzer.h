@@ -0,0 +1,49 @@
+#ifndef REGIONANALYZER_H
+#define REGIONANALYZER_H
+
+#include "noranalysis.h"
+#include <QByteArrayView>
+#include <QElapsedTimer>
+#include <QList>
+#include <QObject>
+#include <QThreadPool>
+#include <atomic>
+#include <memory>
+
+// Runs NorAnalysis over an image on its own thread pool, one batch of blocks per task,
+// and delivers every batch to the owning thread as soon as it is done. Batches are
+// queued in image order, so the map fills from the start of the flash.
+class RegionAnalyzer : public QObject
+{
+    Q_OBJECT
+
+public:
+    // 256 KiB per task: small enough to publish often and to cancel quickly
+    static constexpr qint64 BlocksPerTask = 64;
+
+    explicit RegionAnalyzer(QObject *parent = nullptr);
+    ~RegionAnalyzer() override;
+
+    // The image must stay valid and in place until finished() or cancel().
+    void start(QByteArrayView image);
+    // Drops queued batches and waits for the running ones, which takes well under a
+    // millisecond. Afterwards no thread reads the image and no stale batch is delivered.
+    void cancel();
+    bool isRunning() const { return m_job != nullptr; }
+
+signals:
+    void blocksReady(qint64 firstBlock, const QList<NorAnalysis::BlockStats> &blocks);
+    void finished(qint64 elapsedMs);
+
+private:
+    struct Job {
+        std::atomic_bool cancelled { false };
+        qint64 pendingTasks = 0; // Only touched on the owning thread
+        QElapsedTimer timer;
+    };
+
+    QThreadPool m_pool;
+    std::shared_ptr<Job> m_job;
+};
+
+#endif // REGIONANALYZER_H
@@ -0,0 +1,91 @@
+#include "regionmapmodel.h"
+
+RegionMapModel::RegionMapModel(QObject *parent) : QAbstractListModel(parent)
+{
+}
+
+void RegionMapModel::reset(qint64 blockCount)
+{
+    const bool countChanging = blockCount != m_blocks.size();
+    beginResetModel();
+    m_blocks = QList<NorAnalysis::BlockStats>(blockCount);
+    m_analyzed = 0;
+    m_elapsedMs = -1;
+    endResetModel();
+    if (countChanging) {
+        emit countChanged();
+    }
+    emit progressChanged();
+}
+
+void RegionMapModel::setBlocks(qint64 firstBlock, const QList<NorAnalysis::BlockStats> &blocks)
+{
+    if (blocks.isEmpty() || firstBlock < 0 || firstBlock + blocks.size() > m_blocks.size()) {
+        return;
+    }
+    for (qsizetype i = 0; i < blocks.size(); ++i) {
+        NorAnalysis::BlockStats &block = m_blocks[firstBlock + i];
+        if (block.kind == NorAnalysis::BlockKind::Pending && blocks.at(i).kind != NorAnalysis::BlockKind::Pending) {
+            ++m_analyzed;
+        }
+        block = blocks.at(i);
+    }
+    emit dataChanged(index(int(firstBlock)), index(int(firstBlock + blocks.size() - 1)));
+    emit progressChanged();
+}
+
+void RegionMapModel::setElapsedMs(qint64 elapsedMs)
+{
+    m_elapsedMs = elapsedMs;
+    emit progressChanged();
+}
+
+QString RegionMapModel::summary() const
+{
+    QString text = NorAnalysis::describe(NorAnalysis::summarize(m_blocks));
+    if (isComplete() && m_elapsedMs >= 0 && !text.isEmpty()) {
+        text += QString(" (%1 ms)").arg(m_elapsedMs);
+    }
+    return text;
+}
+
+int RegionMapModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : count();
+}
+
+QVariant RegionMapModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= count()) {
+        return QVariant();
+    }
+
+    const NorAnalysis::BlockStats &block = m_blocks.at(index.row());
+    const qint64 offset = qint64(index.row()) * NorAnalysis::BlockSize;
+    switch (role) {
+    case OffsetRole:
+        return offset;
+    case Qt::DisplayRole:
+    case OffsetTextRole:
+        return QString::number(offset, 16).toUpper().rightJustified(8, '0'); // As in the hex view
+    case KindRole:
+        return QString::fromLatin1(NorAnalysis::kindName(block.kind));
+    case EntropyRole:
+        return block.entropy;
+    case CrcRole:
+        return QString::number(block.crc32, 16).toUpper().rightJustified(8, '0');
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> RegionMapModel::roleNames() const
+{
+    return {
+        { OffsetRole, "offset" },
+        { OffsetTextRole, "offsetText" },
+        { KindRole, "kind" },
+        { EntropyRole, "entropy" },
+        { CrcRole, "crc" }
+    };
+}
@@ -0,0 +1,58 @@
+#ifndef REGIONMAPMODEL_H
+#define REGIONMAPMODEL_H
+
+#include "noranalysis.h"
+#include <QAbstractListModel>
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+
+// One row per 4 KiB block of the open dump for the QML heat map. Rows start out
+// pending and are filled in as RegionAnalyzer batches arrive.
+class RegionMapModel : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+    Q_PROPERTY(int analyzedBlocks READ analyzedBlocks NOTIFY progressChanged)
+    Q_PROPERTY(bool complete READ isComplete NOTIFY progressChanged)
+    Q_PROPERTY(QString summary READ summary NOTIFY progressChanged)
+    Q_PROPERTY(int blockSize READ blockSize CONSTANT)
+
+public:
+    enum Roles {
+        OffsetRole = Qt::UserRole + 1,
+        OffsetTextRole,
+        KindRole,
+        EntropyRole,
+        CrcRole
+    };
+
+    explicit RegionMapModel(QObject *parent = nullptr);
+
+    // Starts over with blockCount pending rows
+    void reset(qint64 blockCount);
+    void clear() { reset(0); }
+    void setBlocks(qint64 firstBlock, const QList<NorAnalysis::BlockStats> &blocks);
+    void setElapsedMs(qint64 elapsedMs);
+
+    int count() const { return int(m_blocks.size()); }
+    int analyzedBlocks() const { return m_analyzed; }
+    bool isComplete() const { return m_analyzed == count(); }
+    QString summary() const;
+    int blockSize() const { return int(NorAnalysis::BlockSize); }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+signals:
+    void countChanged();
+    void progressChanged();
+
+private:
+    QList<NorAnalysis::BlockStats> m_blocks;
+    int m_analyzed = 0;
+    qint64 m_elapsedMs = -1;
+};
+
+#endif // REGIONMAPMODEL_H
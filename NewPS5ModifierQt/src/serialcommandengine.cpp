@@ -0,0 +1,143 @@
+#include "serialcommandengine.h"
+#include "serialprotocol.h"
+#include <QTimer>
+#include <utility>
+
+SerialCommandEngine::SerialCommandEngine(QObject *parent) : QObject(parent)
+{
+}
+
+quint64 SerialCommandEngine::submit(const QString &command, Callback callback, int timeoutMs)
+{
+    Pending pending;
+    pending.id = m_nextId++;
+    pending.command = command;
+    pending.echo = SerialProtocol::frame(command);
+    pending.callback = std::move(callback);
+    pending.timeoutMs = timeoutMs;
+    m_queue.append(std::move(pending));
+    const quint64 id = m_queue.constLast().id;
+    pump();
+    return id;
+}
+
+void SerialCommandEngine::setMaxInFlight(int count)
+{
+    m_maxInFlight = qMax(1, count);
+    pump();
+}
+
+void SerialCommandEngine::pump()
+{
+    while (!m_queue.isEmpty() && m_inFlight.size() < m_maxInFlight) {
+        Pending pending = m_queue.takeFirst();
+        pending.timer = new QTimer(this);
+        pending.timer->setSingleShot(true);
+        const quint64 id = pending.id;
+        connect(pending.timer, &QTimer::timeout, this, [this, id]() { onTimeout(id); });
+        pending.timer->start(pending.timeoutMs);
+        pending.sent.start();
+        const QByteArray wire = pending.echo.toUtf8() + '\n';
+        m_inFlight.append(std::move(pending));
+        emit writeRequested(wire);
+    }
+}
+
+void SerialCommandEngine::feed(QByteArrayView data)
+{
+    m_rxBuffer.append(data);
+    qsizetype start = 0;
+    for (qsizetype newline = m_rxBuffer.indexOf('\n'); newline >= 0; newline = m_rxBuffer.indexOf('\n', start)) {
+        QString line = QString::fromUtf8(m_rxBuffer.constData() + start, newline - start).trimmed();
+        start = newline + 1;
+        if (!line.isEmpty()) {
+            handleLine(line);
+        }
+    }
+    m_rxBuffer.remove(0, start);
+}
+
+void SerialCommandEngine::handleLine(const QString &line)
+{
+    // The echo of a command opens its response
+    for (Pending &pending : m_inFlight) {
+        if (!pending.echoed && line.compare(pending.echo, Qt::CaseInsensitive) == 0) {
+            pending.echoed = true;
+            return;
+        }
+    }
+
+    // The console answers in order, so output belongs to the oldest echoed command. Without
+    // an echo there is no owner: an OK/NG here is typically the late reply of a command that
+    // already timed out, and handing it to the next one would give that the wrong answer.
+    // A command whose echo got lost times out instead.
+    const SerialProtocol::LineKind kind = SerialProtocol::classify(line);
+    qsizetype target = -1;
+    for (qsizetype i = 0; i < m_inFlight.size(); ++i) {
+        if (m_inFlight.at(i).echoed) {
+            target = i;
+            break;
+        }
+    }
+    if (target < 0) {
+        emit unsolicitedLine(line);
+        return;
+    }
+
+    m_inFlight[target].lines.append(line);
+    if (kind != SerialProtocol::LineKind::Other) {
+        finish(target, kind == SerialProtocol::LineKind::Ok ? Status::Ok : Status::Ng);
+    }
+}
+
+void SerialCommandEngine::onTimeout(quint64 id)
+{
+    for (qsizetype i = 0; i < m_inFlight.size(); ++i) {
+        if (m_inFlight.at(i).id == id) {
+            finish(i, Status::Timeout);
+            return;
+        }
+    }
+}
+
+SerialCommandEngine::Response SerialCommandEngine::takeResponse(Pending &pending, Status status)
+{
+    if (pending.timer) {
+        pending.timer->stop();
+        pending.timer->deleteLater(); // May be the timer whose timeout got us here
+        pending.timer = nullptr;
+    }
+    Response response;
+    response.id = pending.id;
+    response.command = pending.command;
+    response.status = status;
+    response.lines = std::move(pending.lines);
+    response.elapsedMs = pending.sent.isValid() ? pending.sent.elapsed() : 0;
+    return response;
+}
+
+void SerialCommandEngine::finish(qsizetype inFlightIndex, Status status)
+{
+    Pending pending = m_inFlight.takeAt(inFlightIndex);
+    const Response response = takeResponse(pending, status);
+
+    pump(); // Keep the line busy before running user code
+    if (pending.callback) {
+        pending.callback(response);
+    }
+    emit responseReady(response);
+}
+
+void SerialCommandEngine::cancelAll()
+{
+    m_rxBuffer.clear();
+    QList<Pending> cancelled = std::exchange(m_inFlight, {});
+    cancelled.append(std::exchange(m_queue, {}));
+    for (Pending &pending : cancelled) {
+        const Response response = takeResponse(pending, Status::Cancelled);
+        if (pending.callback) {
+            pending.callback(response);
+        }
+        emit responseReady(response);
+    }
+}
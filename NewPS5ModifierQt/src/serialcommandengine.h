@@ -0,0 +1,100 @@
+#ifndef SERIALCOMMANDENGINE_H
+#define SERIALCOMMANDENGINE_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QElapsedTimer>
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <functional>
+
+class QTimer;
+
+// Non-blocking request/response layer for the UART console (see serialprotocol.h).
+// The engine does no I/O itself: it asks for bytes to be written through writeRequested()
+// and is fed whatever the port received. Received bytes are framed into lines; the echo
+// of a command marks the start of its response and the first OK/NG line ends it, so a
+// command completes as soon as its reply is in instead of after an idle timeout.
+class SerialCommandEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class Status {
+        Ok,
+        Ng,
+        Timeout,
+        Cancelled
+    };
+
+    struct Response {
+        quint64 id = 0;
+        QString command;
+        Status status = Status::Cancelled;
+        QStringList lines;    // Lines after the echo, the OK/NG line last
+        qint64 elapsedMs = 0; // From the write to completion
+
+        bool answered() const { return status == Status::Ok || status == Status::Ng; }
+        QString text() const { return lines.join('\n'); }
+    };
+
+    using Callback = std::function<void(const Response &response)>;
+
+    static constexpr int DefaultTimeoutMs = 3000;
+
+    explicit SerialCommandEngine(QObject *parent = nullptr);
+
+    // Queues a command (without checksum) and returns its id. The callback runs once,
+    // on completion, timeout or cancellation, before responseReady() is emitted.
+    quint64 submit(const QString &command, Callback callback = {}, int timeoutMs = DefaultTimeoutMs);
+
+    // Bytes received from the port, in any chunking.
+    void feed(QByteArrayView data);
+
+    // Fails every queued and outstanding command with Status::Cancelled and drops
+    // any partial line, e.g. when the port closes.
+    void cancelAll();
+
+    int pendingCount() const { return int(m_queue.size() + m_inFlight.size()); }
+
+    // Commands written ahead of their predecessors' replies. The console buffers its input
+    // and answers in order, so a window > 1 hides the per-command turnaround; 1 is strictly
+    // one command at a time.
+    int maxInFlight() const { return m_maxInFlight; }
+    void setMaxInFlight(int count);
+
+signals:
+    void writeRequested(const QByteArray &data);
+    void responseReady(const SerialCommandEngine::Response &response);
+    // A line no outstanding command claims (boot messages, late replies after a timeout).
+    void unsolicitedLine(const QString &line);
+
+private:
+    struct Pending {
+        quint64 id = 0;
+        QString command;
+        QString echo; // The framed command as the console repeats it
+        Callback callback;
+        int timeoutMs = DefaultTimeoutMs;
+        QElapsedTimer sent;
+        QTimer *timer = nullptr;
+        bool echoed = false;
+        QStringList lines;
+    };
+
+    void pump();
+    static Response takeResponse(Pending &pending, Status status);
+    void handleLine(const QString &line);
+    void finish(qsizetype inFlightIndex, Status status);
+    void onTimeout(quint64 id);
+
+    QList<Pending> m_queue;    // Not written yet
+    QList<Pending> m_inFlight; // Written, in write order
+    QByteArray m_rxBuffer;     // Partial line
+    quint64 m_nextId = 1;
+    int m_maxInFlight = 1;
+};
+
+#endif // SERIALCOMMANDENGINE_H
@@ -0,0 +1,131 @@
+#include "serialportwatcher.h"
+#include <QSerialPortInfo>
+#include <QSocketNotifier>
+#include <QTimer>
+
+#ifdef Q_OS_LINUX
+#include <cstring>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr int DebounceMs = 250;  // udev renames and chmods a node right after creating it
+constexpr int PollIntervalMs = 2000;
+
+struct UsbId {
+    quint16 vendorId;
+    quint16 productId;
+};
+
+constexpr UsbId kKnownAdapters[] = {
+    { 0x0403, 0x6001 }, // FTDI FT232R
+    { 0x0403, 0x6010 }, // FTDI FT2232
+    { 0x0403, 0x6014 }, // FTDI FT232H
+    { 0x0403, 0x6015 }, // FTDI FT231X
+    { 0x10C4, 0xEA60 }, // Silicon Labs CP210x
+    { 0x1A86, 0x7523 }, // WCH CH340
+    { 0x1A86, 0x55D4 }, // WCH CH9102
+    { 0x067B, 0x2303 }, // Prolific PL2303
+};
+
+} // namespace
+
+SerialPortWatcher::SerialPortWatcher(QObject *parent) : QObject(parent)
+{
+}
+
+SerialPortWatcher::~SerialPortWatcher()
+{
+#ifdef Q_OS_LINUX
+    if (m_inotifyFd >= 0) {
+        ::close(m_inotifyFd);
+    }
+#endif
+}
+
+bool SerialPortWatcher::isKnownUartAdapter(const SerialPortDescription &port)
+{
+    if (!port.hasIds) {
+        return false;
+    }
+    for (const UsbId &id : kKnownAdapters) {
+        if (id.vendorId == port.vendorId && id.productId == port.productId) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void SerialPortWatcher::start()
+{
+    m_debounceTimer = new QTimer(this);
+    m_debounceTimer->setSingleShot(true);
+    m_debounceTimer->setInterval(DebounceMs);
+    connect(m_debounceTimer, &QTimer::timeout, this, [this]() { scan(false); });
+
+#ifdef Q_OS_LINUX
+    m_inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_inotifyFd >= 0 && inotify_add_watch(m_inotifyFd, "/dev", IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO) >= 0) {
+        m_notifier = new QSocketNotifier(m_inotifyFd, QSocketNotifier::Read, this);
+        connect(m_notifier, &QSocketNotifier::activated, this, &SerialPortWatcher::readInotifyEvents);
+    } else if (m_inotifyFd >= 0) {
+        ::close(m_inotifyFd);
+        m_inotifyFd = -1;
+    }
+#endif
+    if (!m_notifier) {
+        m_pollTimer = new QTimer(this);
+        m_pollTimer->setInterval(PollIntervalMs);
+        connect(m_pollTimer, &QTimer::timeout, this, [this]() { scan(false); });
+        m_pollTimer->start();
+    }
+    scan(true);
+}
+
+void SerialPortWatcher::rescan()
+{
+    scan(true);
+}
+
+void SerialPortWatcher::readInotifyEvents()
+{
+#ifdef Q_OS_LINUX
+    alignas(inotify_event) char buffer[4096];
+    bool relevant = false;
+    ssize_t length;
+    while ((length = ::read(m_inotifyFd, buffer, sizeof(buffer))) > 0) {
+        for (ssize_t offset = 0; offset < length;) {
+            const auto *event = reinterpret_cast<const inotify_event *>(buffer + offset);
+            // ttyUSB*, ttyACM*, ttyS*, ... - /dev sees plenty of unrelated churn
+            if (event->len > 0 && std::strncmp(event->name, "tty", 3) == 0) {
+                relevant = true;
+            }
+            offset += ssize_t(sizeof(inotify_event) + event->len);
+        }
+    }
+    if (relevant) {
+        m_debounceTimer->start();
+    }
+#endif
+}
+
+void SerialPortWatcher::scan(bool always)
+{
+    QList<SerialPortDescription> ports;
+    const auto infos = QSerialPortInfo::availablePorts();
+    for (const QSerialPortInfo &info : infos) {
+        SerialPortDescription port;
+        port.name = info.portName();
+        port.description = info.description();
+        port.hasIds = info.hasVendorIdentifier() && info.hasProductIdentifier();
+        port.vendorId = info.vendorIdentifier();
+        port.productId = info.productIdentifier();
+        ports.append(port);
+    }
+    if (always || ports != m_ports) {
+        m_ports = ports;
+        emit portsChanged(m_ports);
+    }
+}
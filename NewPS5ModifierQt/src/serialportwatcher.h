@@ -0,0 +1,62 @@
+#ifndef SERIALPORTWATCHER_H
+#define SERIALPORTWATCHER_H
+
+#include <QList>
+#include <QMetaType>
+#include <QObject>
+#include <QString>
+
+class QSocketNotifier;
+class QTimer;
+
+struct SerialPortDescription {
+    QString name;
+    QString description;
+    quint16 vendorId = 0;
+    quint16 productId = 0;
+    bool hasIds = false; // USB adapter reporting VID/PID
+
+    bool operator==(const SerialPortDescription &other) const
+    {
+        return name == other.name && vendorId == other.vendorId && productId == other.productId && hasIds == other.hasIds;
+    }
+};
+Q_DECLARE_METATYPE(SerialPortDescription)
+
+// Keeps the list of serial ports current without the user pressing Refresh. On Linux an
+// inotify watch on /dev reports tty nodes coming and going (sysfs itself does not emit
+// inotify events); other platforms poll. Bursts of events are debounced and enumeration
+// (QSerialPortInfo, which walks sysfs/udev) runs on the watcher's thread, so it is meant
+// to live on a worker thread. portsChanged() is only emitted when the list differs.
+class SerialPortWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SerialPortWatcher(QObject *parent = nullptr);
+    ~SerialPortWatcher() override;
+
+    // USB-UART bridges commonly used on PS5 boards (FTDI, CP210x, CH34x, PL2303).
+    static bool isKnownUartAdapter(const SerialPortDescription &port);
+
+public slots:
+    // First enumeration and start of the watch; call on the thread the watcher lives on.
+    void start();
+    // Enumerates now and always reports the result.
+    void rescan();
+
+signals:
+    void portsChanged(const QList<SerialPortDescription> &ports);
+
+private:
+    void scan(bool always);
+    void readInotifyEvents();
+
+    QList<SerialPortDescription> m_ports;
+    QTimer *m_debounceTimer = nullptr;
+    QTimer *m_pollTimer = nullptr;
+    QSocketNotifier *m_notifier = nullptr;
+    int m_inotifyFd = -1;
+};
+
+#endif // SERIALPORTWATCHER_H
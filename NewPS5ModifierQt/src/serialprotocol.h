@@ -0,0 +1,52 @@
+#ifndef SERIALPROTOCOL_H
+#define SERIALPROTOCOL_H
+
+#include <QString>
+#include <QStringView>
+
+// Wire format of the PS5 UART console: every command line is followed by ":XX", the low
+// byte of the sum of its characters (CalculateChecksum in the legacy Form1.cs). The console
+// echoes that line, may print more text, and finishes with a line starting "OK" or "NG".
+namespace SerialProtocol {
+
+// The GUI thread drains a receive ring this often, about once per frame
+inline constexpr int DrainIntervalMs = 16;
+
+inline QString checksum(QStringView command)
+{
+    int sum = 0;
+    for (QChar qc : command) {
+        sum += qc.unicode();
+    }
+    return QString::number(sum & 0xFF, 16).toUpper().rightJustified(2, '0');
+}
+
+// "errlog 0" -> "errlog 0:DB", without the line terminator
+inline QString frame(QStringView command)
+{
+    return command.toString() + ':' + checksum(command);
+}
+
+enum class LineKind {
+    Other,
+    Ok,
+    Ng
+};
+
+// Classifies a received line (without its terminator); "OK ..." and "NG ..." end a response.
+inline LineKind classify(QStringView line)
+{
+    if (line.size() >= 2 && (line.size() == 2 || line[2] == u' ' || line[2] == u':')) {
+        if (line.startsWith(QLatin1String("OK"))) {
+            return LineKind::Ok;
+        }
+        if (line.startsWith(QLatin1String("NG"))) {
+            return LineKind::Ng;
+        }
+    }
+    return LineKind::Other;
+}
+
+} // namespace SerialProtocol
+
+#endif // SERIALPROTOCOL_H
@@ -0,0 +1,132 @@
+#include "serialsession.h"
+#include "serialworker.h"
+#include <QThread>
+
+SerialSession::SerialSession(const QString &portName, QThread *ioThread, QObject *parent)
+    : QObject(parent), m_portName(portName), m_ioThread(ioThread)
+{
+    m_engine = new SerialCommandEngine(this);
+    connect(m_engine, &SerialCommandEngine::unsolicitedLine, this, [this](const QString &line) {
+        appendLog(line + '\n');
+    });
+
+    m_worker = new SerialWorker(&m_rx);
+    m_worker->moveToThread(m_ioThread);
+    connect(m_engine, &SerialCommandEngine::writeRequested, m_worker, &SerialWorker::write); // Queued
+    connect(m_worker, &SerialWorker::errorOccurred, this, &SerialSession::errorOccurred);
+    connect(m_worker, &SerialWorker::closedUnexpectedly, this, [this]() {
+        drain();
+        m_open = false;
+        m_engine->cancelAll();
+        setStatus("Port lost");
+        emit closedUnexpectedly();
+    });
+    setStatus("Closed");
+}
+
+SerialSession::~SerialSession()
+{
+    close();
+    // The worker only touches m_rx while its port is open, so it may outlive the ring
+    m_worker->deleteLater();
+}
+
+bool SerialSession::open(QString *errorString)
+{
+    bool opened = false;
+    QMetaObject::invokeMethod(m_worker, [&]() { opened = m_worker->open(m_portName, errorString); },
+                              Qt::BlockingQueuedConnection);
+    m_open = opened;
+    setStatus(opened ? "Connected" : "Could not open");
+    return opened;
+}
+
+void SerialSession::close()
+{
+    if (!m_open) {
+        return;
+    }
+    QMetaObject::invokeMethod(m_worker, [this]() { m_worker->close(); }, Qt::BlockingQueuedConnection);
+    drain(); // Whatever arrived before the close
+    m_open = false;
+    m_engine->cancelAll();
+    setStatus("Closed");
+}
+
+void SerialSession::send(const QString &command)
+{
+    if (!m_open) {
+        return;
+    }
+    appendLog(">> " + command + '\n');
+    m_engine->submit(command, [this](const SerialCommandEngine::Response &response) {
+        appendLog("<< " + (response.answered() ? response.text() : QString("Error: No response")) + '\n');
+    });
+    m_changed = true;
+}
+
+void SerialSession::readErrorLogs()
+{
+    if (!m_open || isReadingErrorLogs()) {
+        return;
+    }
+    m_errorLogSlotsLeft = ErrorLogSlots;
+    m_errorLogFailed = false;
+    m_codeCount = 0;
+    m_errorLogTimer.start();
+    setStatus("Reading error logs...");
+    for (int i = 0; i < ErrorLogSlots; ++i) {
+        m_engine->submit(QString("errlog %1").arg(i), [this, i](const SerialCommandEngine::Response &response) {
+            if (response.answered()) {
+                QList<ErrorLogEntry> entries = ErrorLogModel::parse(response.text());
+                for (ErrorLogEntry &entry : entries) {
+                    entry.slot = i;
+                    entry.source = m_portName;
+                }
+                m_codeCount += int(entries.size());
+                if (!entries.isEmpty()) {
+                    emit errorLogEntriesRead(entries);
+                }
+            } else {
+                m_errorLogFailed = true;
+            }
+            if (--m_errorLogSlotsLeft > 0) {
+                m_changed = true;
+                return;
+            }
+            const qint64 elapsedMs = m_errorLogTimer.elapsed();
+            setStatus(QString("%1 codes in %2 ms%3").arg(m_codeCount).arg(elapsedMs)
+                          .arg(m_errorLogFailed ? ", some slots failed" : ""));
+            emit errorLogsFinished(m_errorLogFailed, elapsedMs);
+        });
+    }
+}
+
+bool SerialSession::drain()
+{
+    char chunk[4096];
+    std::size_t n;
+    while ((n = m_rx.read(chunk, sizeof(chunk))) > 0) {
+        m_engine->feed(QByteArrayView(chunk, qsizetype(n)));
+    }
+    const bool changed = m_changed;
+    m_changed = false;
+    return changed;
+}
+
+void SerialSession::appendLog(const QString &text)
+{
+    m_log += text;
+    if (m_log.size() > LogLimitChars) {
+        // Cut at a line start, so the first line shown is whole
+        const qsizetype cut = m_log.indexOf('\n', m_log.size() - LogLimitChars);
+        m_log.remove(0, cut < 0 ? m_log.size() - LogLimitChars : cut + 1);
+    }
+    m_changed = true;
+}
+
+void SerialSession::setStatus(const QString &status)
+{
+    m_status = status;
+    m_changed = true;
+}
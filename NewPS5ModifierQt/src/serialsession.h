@@ -0,0 +1,78 @@
+#ifndef SERIALSESSION_H
+#define SERIALSESSION_H
+
+#include "errorlogmodel.h"
+#include "serialcommandengine.h"
+#include "spscringbuffer.h"
+#include <QElapsedTimer>
+#include <QList>
+#include <QObject>
+#include <QString>
+
+class QThread;
+class SerialWorker;
+
+// One console on one port: its own receive ring, SerialWorker and SerialCommandEngine,
+// so every session frames and pipelines its own commands. The worker runs on an I/O
+// thread shared with other sessions; everything else stays on the GUI thread and is
+// driven by drain(), which the owner calls once per frame for all sessions.
+class SerialSession : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr std::size_t RxBufferBytes = 256 * 1024;
+    // Console output kept for display; older text is dropped
+    static constexpr qsizetype LogLimitChars = 64 * 1024;
+    static constexpr int ErrorLogSlots = 11; // errlog 0 .. errlog 10
+
+    SerialSession(const QString &portName, QThread *ioThread, QObject *parent = nullptr);
+    ~SerialSession() override;
+
+    bool open(QString *errorString);
+    void close();
+
+    QString portName() const { return m_portName; }
+    QThread *ioThread() const { return m_ioThread; }
+    bool isOpen() const { return m_open; }
+    QString status() const { return m_status; }
+    QString log() const { return m_log; }
+    int pendingCount() const { return m_engine->pendingCount(); }
+    int codeCount() const { return m_codeCount; }
+    bool isReadingErrorLogs() const { return m_errorLogSlotsLeft > 0; }
+
+    void setMaxInFlight(int count) { m_engine->setMaxInFlight(count); }
+    void send(const QString &command);
+    // errlog 0..10, pipelined; entries arrive through errorLogEntriesRead() slot by slot.
+    void readErrorLogs();
+
+    // Feeds everything received since the last call to the engine. Returns true if
+    // anything shown for the session changed since the previous call.
+    bool drain();
+
+signals:
+    void errorLogEntriesRead(const QList<ErrorLogEntry> &entries);
+    void errorLogsFinished(bool anErrorOccurred, qint64 elapsedMs);
+    void errorOccurred(const QString &message);
+    void closedUnexpectedly();
+
+private:
+    void appendLog(const QString &text);
+    void setStatus(const QString &status);
+
+    QString m_portName;
+    QThread *m_ioThread;
+    SpscRingBuffer m_rx { RxBufferBytes };
+    SerialWorker *m_worker = nullptr; // Lives on m_ioThread
+    SerialCommandEngine *m_engine;
+    QString m_log;
+    QString m_status;
+    bool m_open = false;
+    bool m_changed = true;
+    int m_codeCount = 0;
+    int m_errorLogSlotsLeft = 0;
+    bool m_errorLogFailed = false;
+    QElapsedTimer m_errorLogTimer;
+};
+
+#endif // SERIALSESSION_H
@@ -0,0 +1,214 @@
+#include "serialsessionmodel.h"
+#include "serialprotocol.h"
+#include "serialsession.h"
+#include <QThread>
+#include <QTimer>
+#include <algorithm>
+
+SerialSessionModel::SerialSessionModel(QObject *parent) : QAbstractListModel(parent)
+{
+    m_drainTimer = new QTimer(this);
+    m_drainTimer->setInterval(SerialProtocol::DrainIntervalMs);
+    connect(m_drainTimer, &QTimer::timeout, this, &SerialSessionModel::drainAll);
+}
+
+SerialSessionModel::~SerialSessionModel()
+{
+    closeAll();
+    for (QThread *thread : std::as_const(m_ioThreads)) {
+        thread->quit(); // Pending worker deleteLater()s run as the thread finishes
+        thread->wait();
+    }
+}
+
+bool SerialSessionModel::open(const QString &portName, QString *errorString)
+{
+    if (contains(portName)) {
+        if (errorString) {
+            *errorString = portName + " already has a session";
+        }
+        return false;
+    }
+
+    auto *session = new SerialSession(portName, leastBusyIoThread(), this);
+    session->setMaxInFlight(m_maxInFlight);
+    if (!session->open(errorString)) {
+        delete session;
+        return false;
+    }
+    connect(session, &SerialSession::errorLogEntriesRead, this, &SerialSessionModel::errorLogEntriesRead);
+    connect(session, &SerialSession::errorOccurred, this, [this, portName](const QString &message) {
+        emit errorOccurred(portName, message);
+    });
+    connect(session, &SerialSession::errorLogsFinished, this, [this](bool anErrorOccurred, qint64) {
+        m_readFailed = m_readFailed || anErrorOccurred;
+        if (--m_readingSessions == 0) {
+            emit allErrorLogsFinished(m_readSessions, m_readCodes, m_readFailed, m_readTimer.elapsed());
+            emit readingErrorLogsChanged();
+        }
+    });
+    connect(session, &SerialSession::errorLogEntriesRead, this, [this](const QList<ErrorLogEntry> &entries) {
+        m_readCodes += int(entries.size());
+    });
+
+    const int row = count();
+    beginInsertRows(QModelIndex(), row, row);
+    m_sessions.append(session);
+    endInsertRows();
+    emit countChanged();
+    m_drainTimer->start();
+    return true;
+}
+
+void SerialSessionModel::close(int row)
+{
+    if (row >= 0 && row < count()) {
+        remove(row);
+    }
+}
+
+void SerialSessionModel::closeAll()
+{
+    while (!m_sessions.isEmpty()) {
+        remove(count() - 1);
+    }
+}
+
+void SerialSessionModel::remove(int row)
+{
+    SerialSession *session = m_sessions.at(row);
+    session->close(); // Cancels an errlog read, which still reports as finished
+    beginRemoveRows(QModelIndex(), row, row);
+    m_sessions.removeAt(row);
+    endRemoveRows();
+    delete session;
+    emit countChanged();
+    if (m_sessions.isEmpty()) {
+        m_drainTimer->stop();
+    }
+}
+
+bool SerialSessionModel::contains(const QString &portName) const
+{
+    for (const SerialSession *session : m_sessions) {
+        if (session->portName() == portName) {
+            return true;
+        }
+    }
+    return false;
+}
+
+QThread *SerialSessionModel::leastBusyIoThread()
+{
+    // A new thread only while every existing one already serves a session
+    if (m_ioThreads.size() < MaxIoThreads && m_ioThreads.size() <= count()) {
+        auto *thread = new QThread(this);
+        thread->setObjectName(QString("SerialSessionIO%1").arg(m_ioThreads.size()));
+        thread->start();
+        m_ioThreads.append(thread);
+        return thread;
+    }
+    QThread *best = m_ioThreads.constFirst();
+    qsizetype bestLoad = m_sessions.size() + 1;
+    for (QThread *thread : std::as_const(m_ioThreads)) {
+        const qsizetype load = std::count_if(m_sessions.cbegin(), m_sessions.cend(),
+                                             [thread](const SerialSession *session) { return session->ioThread() == thread; });
+        if (load < bestLoad) {
+            best = thread;
+            bestLoad = load;
+        }
+    }
+    return best;
+}
+
+void SerialSessionModel::setMaxInFlight(int count)
+{
+    m_maxInFlight = count;
+    for (SerialSession *session : std::as_const(m_sessions)) {
+        session->setMaxInFlight(count);
+    }
+}
+
+void SerialSessionModel::sendToAll(const QString &command)
+{
+    for (SerialSession *session : std::as_const(m_sessions)) {
+        session->send(command);
+    }
+}
+
+int SerialSessionModel::readErrorLogsOnAll()
+{
+    if (isReadingErrorLogs()) {
+        return 0;
+    }
+    m_readCodes = 0;
+    m_readFailed = false;
+    m_readSessions = 0;
+    m_readTimer.start();
+    // Every session pipelines its own slots; the consoles answer in parallel
+    for (SerialSession *session : std::as_const(m_sessions)) {
+        if (session->isOpen()) {
+            ++m_readSessions;
+        }
+    }
+    m_readingSessions = m_readSessions;
+    for (SerialSession *session : std::as_const(m_sessions)) {
+        session->readErrorLogs();
+    }
+    if (m_readSessions > 0) {
+        emit readingErrorLogsChanged();
+    }
+    return m_readSessions;
+}
+
+void SerialSessionModel::drainAll()
+{
+    for (int row = 0; row < count(); ++row) {
+        if (m_sessions.at(row)->drain()) {
+            emit dataChanged(index(row), index(row));
+        }
+    }
+}
+
+int SerialSessionModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : count();
+}
+
+QVariant SerialSessionModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= count()) {
+        return QVariant();
+    }
+
+    const SerialSession *session = m_sessions.at(index.row());
+    switch (role) {
+    case Qt::DisplayRole:
+    case PortNameRole:
+        return session->portName();
+    case ConnectedRole:
+        return session->isOpen();
+    case StatusRole:
+        return session->status();
+    case PendingRole:
+        return session->pendingCount();
+    case CodeCountRole:
+        return session->codeCount();
+    case LogRole:
+        return session->log();
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> SerialSessionModel::roleNames() const
+{
+    return {
+        { PortNameRole, "portName" },
+        { ConnectedRole, "connected" },
+        { StatusRole, "status" },
+        { PendingRole, "pending" },
+        { CodeCountRole, "codeCount" },
+        { LogRole, "log" }
+    };
+}
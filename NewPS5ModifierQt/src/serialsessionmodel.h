@@ -0,0 +1,81 @@
+#ifndef SERIALSESSIONMODEL_H
+#define SERIALSESSIONMODEL_H
+
+#include "errorlogmodel.h"
+#include <QAbstractListModel>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QString>
+
+class QThread;
+class QTimer;
+class SerialSession;
+
+// Consoles open side by side, one row each. Port I/O is spread over at most
+// MaxIoThreads threads whatever the number of sessions; framing, command queues and
+// this model live on the GUI thread and are drained together once per frame, so a
+// command to one console never waits for another.
+class SerialSessionModel : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+    Q_PROPERTY(bool readingErrorLogs READ isReadingErrorLogs NOTIFY readingErrorLogsChanged)
+
+public:
+    enum Roles {
+        PortNameRole = Qt::UserRole + 1,
+        ConnectedRole,
+        StatusRole,
+        PendingRole,
+        CodeCountRole,
+        LogRole
+    };
+
+    static constexpr int MaxIoThreads = 2;
+
+    explicit SerialSessionModel(QObject *parent = nullptr);
+    ~SerialSessionModel() override;
+
+    bool open(const QString &portName, QString *errorString = nullptr);
+    void close(int row);
+    void closeAll();
+    bool contains(const QString &portName) const;
+    int count() const { return int(m_sessions.size()); }
+
+    void setMaxInFlight(int count);
+    // Same command to every open session
+    void sendToAll(const QString &command);
+    // errlog 0..10 on every open session at once; returns the number of sessions started
+    int readErrorLogsOnAll();
+    bool isReadingErrorLogs() const { return m_readingSessions > 0; }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+signals:
+    void countChanged();
+    void readingErrorLogsChanged();
+    // Entries carry their port in ErrorLogEntry::source
+    void errorLogEntriesRead(const QList<ErrorLogEntry> &entries);
+    void allErrorLogsFinished(int sessions, int codes, bool anErrorOccurred, qint64 elapsedMs);
+    void errorOccurred(const QString &portName, const QString &message);
+
+private:
+    void drainAll();
+    QThread *leastBusyIoThread();
+    void remove(int row);
+
+    QList<SerialSession *> m_sessions;
+    QList<QThread *> m_ioThreads;
+    QTimer *m_drainTimer;
+    int m_maxInFlight = 1;
+    int m_readingSessions = 0;
+    int m_readCodes = 0;
+    int m_readSessions = 0;
+    bool m_readFailed = false;
+    QElapsedTimer m_readTimer;
+};
+
+#endif // SERIALSESSIONMODEL_H
@@ -0,0 +1,95 @@
+#include "serialworker.h"
+#include "spscringbuffer.h"
+#include <QSerialPort>
+#include <QTimer>
+#include <chrono>
+
+SerialWorker::SerialWorker(SpscRingBuffer *rx, SpscRingBuffer *stamps, QObject *parent)
+    : QObject(parent), m_rx(rx), m_stamps(stamps)
+{
+}
+
+bool SerialWorker::open(const QString &portName, QString *errorString)
+{
+    if (!m_port) {
+        m_port = new QSerialPort(this);
+        connect(m_port, &QSerialPort::readyRead, this, &SerialWorker::readIntoRing);
+        connect(m_port, &QSerialPort::errorOccurred, this, [this](QSerialPort::SerialPortError error) {
+            handleError(int(error));
+        });
+        m_retryTimer = new QTimer(this);
+        m_retryTimer->setSingleShot(true);
+        m_retryTimer->setInterval(2);
+        connect(m_retryTimer, &QTimer::timeout, this, &SerialWorker::readIntoRing);
+    }
+    close();
+    m_rx->reset(); // The GUI thread is blocked in this call, so the consumer is idle
+    if (m_stamps) {
+        m_stamps->reset();
+    }
+
+    m_port->setPortName(portName);
+    m_port->setBaudRate(QSerialPort::Baud115200); // Common baud rate
+    m_port->setDataBits(QSerialPort::Data8);
+    m_port->setParity(QSerialPort::NoParity);
+    m_port->setStopBits(QSerialPort::OneStop);
+    m_port->setFlowControl(QSerialPort::NoFlowControl);
+
+    if (!m_port->open(QIODevice::ReadWrite)) {
+        if (errorString) {
+            *errorString = m_port->errorString();
+        }
+        return false;
+    }
+    return true;
+}
+
+void SerialWorker::close()
+{
+    if (m_port && m_port->isOpen()) {
+        m_retryTimer->stop();
+        m_port->close();
+    }
+}
+
+void SerialWorker::write(const QByteArray &data)
+{
+    if (m_port && m_port->isOpen()) {
+        m_port->write(data);
+    }
+}
+
+void SerialWorker::readIntoRing()
+{
+    char chunk[4096];
+    while (m_port->bytesAvailable() > 0) {
+        const std::size_t room = m_rx->writeAvailable();
+        if (room == 0 || (m_stamps && m_stamps->writeAvailable() < sizeof(ReadStamp))) {
+            m_retryTimer->start(); // The GUI is behind; QSerialPort keeps buffering meanwhile
+            return;
+        }
+        const qint64 n = m_port->read(chunk, qint64(qMin(sizeof(chunk), room)));
+        if (n <= 0) {
+            break;
+        }
+        const ReadStamp stamp { std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                    std::chrono::steady_clock::now().time_since_epoch()).count(), n };
+        m_rx->write(chunk, std::size_t(n));
+        if (m_stamps) {
+            // After the bytes, so the consumer always finds them once it has the stamp
+            m_stamps->write(reinterpret_cast<const char *>(&stamp), sizeof(stamp));
+        }
+    }
+}
+
+void SerialWorker::handleError(int error)
+{
+    if (error == QSerialPort::NoError || error == QSerialPort::TimeoutError) {
+        return;
+    }
+    emit errorOccurred("Serial port error: " + m_port->errorString());
+    if (error == QSerialPort::ResourceError && m_port->isOpen()) {
+        close();
+        emit closedUnexpectedly();
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef SERIALWORKER_H
+#define SERIALWORKER_H
+
+#include <QByteArray>
+#include <QObject>
+#include <QString>
+
+class QSerialPort;
+class QTimer;
+class SpscRingBuffer;
+
+// Owns the QSerialPort on the serial I/O thread. Received bytes go straight into the
+// ring buffer, which the GUI thread drains at its own pace; nothing per byte or per
+// line crosses threads. If the ring is full the bytes stay in the port's buffer and
+// are retried shortly, so a slow consumer delays data but never loses it.
+class SerialWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Put into the optional stamps ring after every chunk written to rx: when the chunk
+    // came off the port, in std::chrono::steady_clock nanoseconds, and its length
+    struct ReadStamp {
+        qint64 steadyNs;
+        qint64 bytes;
+    };
+
+    explicit SerialWorker(SpscRingBuffer *rx, SpscRingBuffer *stamps = nullptr, QObject *parent = nullptr);
+
+    // Called on the worker thread (blocking queued from the GUI thread).
+    bool open(const QString &portName, QString *errorString);
+    void close();
+
+public slots:
+    void write(const QByteArray &data);
+
+signals:
+    void errorOccurred(const QString &message);
+    // The port went away underneath us (adapter unplugged).
+    void closedUnexpectedly();
+
+private:
+    void readIntoRing();
+    void handleError(int error);
+
+    SpscRingBuffer *m_rx;
+    SpscRingBuffer *m_stamps;
+    QSerialPort *m_port = nullptr; // Created on first open so it lives on the worker thread
+    QTimer *m_retryTimer = nullptr;
+};
+
+#endif // SERIALWORKER_H
@@ -0,0 +1,72 @@
+#include "spscringbuffer.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+std::size_t roundUpToPowerOfTwo(std::size_t value)
+{
+    std::size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+} // namespace
+
+SpscRingBuffer::SpscRingBuffer(std::size_t capacity)
+    : m_buffer(new char[roundUpToPowerOfTwo(std::max<std::size_t>(capacity, 2))]),
+      m_mask(roundUpToPowerOfTwo(std::max<std::size_t>(capacity, 2)) - 1)
+{
+}
+
+std::size_t SpscRingBuffer::writeAvailable() const
+{
+    return capacity() - (m_writePos.load(std::memory_order_relaxed) - m_readPos.load(std::memory_order_acquire));
+}
+
+std::size_t SpscRingBuffer::readAvailable() const
+{
+    return m_writePos.load(std::memory_order_acquire) - m_readPos.load(std::memory_order_relaxed);
+}
+
+std::size_t SpscRingBuffer::write(const char *data, std::size_t length)
+{
+    const std::size_t writePos = m_writePos.load(std::memory_order_relaxed);
+    const std::size_t readPos = m_readPos.load(std::memory_order_acquire);
+    length = std::min(length, capacity() - (writePos - readPos));
+    if (length == 0) {
+        return 0;
+    }
+
+    const std::size_t start = writePos & m_mask;
+    const std::size_t first = std::min(length, capacity() - start);
+    std::memcpy(m_buffer.get() + start, data, first);
+    std::memcpy(m_buffer.get(), data + first, length - first);
+    m_writePos.store(writePos + length, std::memory_order_release);
+    return length;
+}
+
+std::size_t SpscRingBuffer::read(char *data, std::size_t length)
+{
+    const std::size_t readPos = m_readPos.load(std::memory_order_relaxed);
+    const std::size_t writePos = m_writePos.load(std::memory_order_acquire);
+    length = std::min(length, writePos - readPos);
+    if (length == 0) {
+        return 0;
+    }
+
+    const std::size_t start = readPos & m_mask;
+    const std::size_t first = std::min(length, capacity() - start);
+    std::memcpy(data, m_buffer.get() + start, first);
+    std::memcpy(data + first, m_buffer.get(), length - first);
+    m_readPos.store(readPos + length, std::memory_order_release);
+    return length;
+}
+
+void SpscRingBuffer::reset()
+{
+    m_writePos.store(0, std::memory_order_relaxed);
+    m_readPos.store(0, std::memory_order_relaxed);
+}
@@ -0,0 +1,41 @@
+#ifndef SPSCRINGBUFFER_H
+#define SPSCRINGBUFFER_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+// Lock-free byte ring for exactly one producer thread and one consumer thread.
+// Each side only stores its own index (release) and loads the other's (acquire),
+// so neither ever waits on the other; a full ring simply accepts fewer bytes.
+class SpscRingBuffer
+{
+public:
+    // Capacity is rounded up to a power of two.
+    explicit SpscRingBuffer(std::size_t capacity);
+
+    SpscRingBuffer(const SpscRingBuffer &) = delete;
+    SpscRingBuffer &operator=(const SpscRingBuffer &) = delete;
+
+    std::size_t capacity() const { return m_mask + 1; }
+
+    // Producer side. Returns the number of bytes stored, which is less than length when full.
+    std::size_t write(const char *data, std::size_t length);
+    std::size_t writeAvailable() const;
+
+    // Consumer side. Returns the number of bytes copied out.
+    std::size_t read(char *data, std::size_t length);
+    std::size_t readAvailable() const;
+
+    // Empties the ring; only valid while neither side is running.
+    void reset();
+
+private:
+    std::unique_ptr<char[]> m_buffer;
+    std::size_t m_mask;
+    // Free-running positions, masked on access; kept on separate cache lines
+    alignas(64) std::atomic<std::size_t> m_writePos { 0 };
+    alignas(64) std::atomic<std::size_t> m_readPos { 0 };
+};
+
+#endif // SPSCRINGBUFFER_H
@@ -0,0 +1,173 @@
+#include "tracer.h"
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QThread>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace {
+
+int bucketFor(qint64 us)
+{
+    int bucket = 0;
+    while (bucket < Tracer::BucketCount - 1 && us >= (qint64(1) << bucket)) {
+        ++bucket;
+    }
+    return bucket;
+}
+
+} // namespace
+
+qint64 Tracer::Histogram::percentileUs(double fraction) const
+{
+    if (count == 0) {
+        return 0;
+    }
+    const qint64 rank = std::max<qint64>(1, qint64(std::ceil(fraction * double(count))));
+    qint64 seen = 0;
+    for (int bucket = 0; bucket < BucketCount; ++bucket) {
+        seen += buckets[bucket];
+        if (seen >= rank) {
+            return std::clamp(qint64(1) << bucket, minUs, maxUs);
+        }
+    }
+    return maxUs;
+}
+
+Tracer &Tracer::instance()
+{
+    static Tracer tracer;
+    return tracer;
+}
+
+qint64 Tracer::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Tracer::complete(const char *name, const char *category, qint64 startNs)
+{
+    const qint64 durationNs = std::max<qint64>(0, now() - startNs);
+    const qint64 us = durationNs / 1000;
+
+    QMutexLocker locker(&m_mutex);
+    Event event { name, category, startNs, durationNs, threadIndex() };
+    if (qsizetype(m_events.size()) < MaxEvents) {
+        m_events.push_back(event);
+    } else {
+        m_events[size_t(m_nextEvent)] = event;
+        m_nextEvent = (m_nextEvent + 1) % MaxEvents;
+    }
+
+    Histogram &histogram = m_histograms[std::string_view(name)];
+    if (histogram.count == 0) {
+        histogram.name = QString::fromLatin1(name);
+        histogram.category = QString::fromLatin1(category);
+        histogram.minUs = us;
+    }
+    ++histogram.count;
+    histogram.totalUs += us;
+    histogram.minUs = std::min(histogram.minUs, us);
+    histogram.maxUs = std::max(histogram.maxUs, us);
+    ++histogram.buckets[size_t(bucketFor(us))];
+}
+
+int Tracer::threadIndex()
+{
+    const Qt::HANDLE id = QThread::currentThreadId();
+    const auto it = m_threadIndices.constFind(id);
+    if (it != m_threadIndices.constEnd()) {
+        return it.value();
+    }
+    const int index = int(m_threadNames.size());
+    const QString name = QThread::currentThread()->objectName();
+    m_threadNames.append(name.isEmpty() ? QString("Thread %1").arg(index) : name);
+    m_threadIndices.insert(id, index);
+    return index;
+}
+
+QList<Tracer::Histogram> Tracer::histograms() const
+{
+    QList<Histogram> result;
+    {
+        QMutexLocker locker(&m_mutex);
+        result.reserve(qsizetype(m_histograms.size()));
+        for (const auto &entry : m_histograms) {
+            result.append(entry.second);
+        }
+    }
+    std::sort(result.begin(), result.end(), [](const Histogram &a, const Histogram &b) { return a.name < b.name; });
+    return result;
+}
+
+qsizetype Tracer::eventCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return qsizetype(m_events.size());
+}
+
+QByteArray Tracer::chromeTraceJson() const
+{
+    QMutexLocker locker(&m_mutex);
+    qint64 originNs = 0;
+    if (!m_events.empty()) {
+        originNs = std::min_element(m_events.cbegin(), m_events.cend(), [](const Event &a, const Event &b) {
+                       return a.startNs < b.startNs;
+                   })->startNs;
+    }
+
+    // Complete ("X") events in microseconds, oldest first, plus thread name metadata
+    QJsonArray events;
+    for (qsizetype i = 0; i < qsizetype(m_events.size()); ++i) {
+        const Event &event = m_events[size_t((m_nextEvent + i) % qsizetype(m_events.size()))];
+        QJsonObject object;
+        object["name"] = QString::fromLatin1(event.name);
+        object["cat"] = QString::fromLatin1(event.category);
+        object["ph"] = "X";
+        object["ts"] = double(event.startNs - originNs) / 1000.0;
+        object["dur"] = double(event.durationNs) / 1000.0;
+        object["pid"] = 1;
+        object["tid"] = event.thread;
+        events.append(object);
+    }
+    for (qsizetype i = 0; i < m_threadNames.size(); ++i) {
+        QJsonObject object;
+        object["name"] = "thread_name";
+        object["ph"] = "M";
+        object["pid"] = 1;
+        object["tid"] = int(i);
+        object["args"] = QJsonObject { { "name", m_threadNames.at(i) } };
+        events.append(object);
+    }
+
+    QJsonObject root;
+    root["traceEvents"] = events;
+    root["displayTimeUnit"] = "ms";
+    return QJsonDocument(root).toJson(QJsonDocument::Compact);
+}
+
+bool Tracer::writeChromeTrace(const QString &filePath, QString *errorString) const
+{
+    const QByteArray json = chromeTraceJson();
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly) || file.write(json) != json.size() || !file.commit()) {
+        if (errorString) {
+            *errorString = file.errorString();
+        }
+        return false;
+    }
+    return true;
+}
+
+void Tracer::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_events.clear();
+    m_events.shrink_to_fit();
+    m_nextEvent = 0;
+    m_histograms.clear();
+}
@@ -0,0 +1,107 @@
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QtGlobal>
+#include <array>
+#include <atomic>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Process-wide recorder of timed spans. While disabled a span costs one relaxed atomic
+// load; while enabled every finished span goes into a fixed-size ring of events (the
+// oldest are overwritten) and into a per-name latency histogram with power-of-two
+// microsecond buckets. The ring exports as Chrome trace-event JSON, which
+// chrome://tracing and Perfetto open directly.
+//
+// Span names and categories must be string literals: only the pointers are stored.
+class Tracer
+{
+public:
+    static constexpr qsizetype MaxEvents = 100000;
+    static constexpr int BucketCount = 32; // Bucket k holds durations below 2^k microseconds
+
+    struct Histogram {
+        QString name;
+        QString category;
+        qint64 count = 0;
+        qint64 totalUs = 0;
+        qint64 minUs = 0;
+        qint64 maxUs = 0;
+        std::array<qint64, BucketCount> buckets {};
+
+        double meanUs() const { return count > 0 ? double(totalUs) / double(count) : 0.0; }
+        // Upper bound of the bucket holding the given fraction (0..1) of the samples
+        qint64 percentileUs(double fraction) const;
+    };
+
+    static Tracer &instance();
+
+    static bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+    static void setEnabled(bool enabled) { s_enabled.store(enabled, std::memory_order_relaxed); }
+    // Monotonic nanoseconds; only differences mean anything
+    static qint64 now();
+
+    // Records a span that started at startNs and ends now. For work that starts in one
+    // place and finishes in a callback (network replies, serial commands).
+    void complete(const char *name, const char *category, qint64 startNs);
+
+    // Sorted by name
+    QList<Histogram> histograms() const;
+    qsizetype eventCount() const;
+    QByteArray chromeTraceJson() const;
+    bool writeChromeTrace(const QString &filePath, QString *errorString = nullptr) const;
+    void clear();
+
+private:
+    struct Event {
+        const char *name = nullptr;
+        const char *category = nullptr;
+        qint64 startNs = 0;
+        qint64 durationNs = 0;
+        int thread = 0;
+    };
+
+    Tracer() = default;
+    int threadIndex(); // Called with m_mutex held
+
+    static inline std::atomic_bool s_enabled { false };
+
+    mutable QMutex m_mutex;
+    std::vector<Event> m_events; // Ring once it reaches MaxEvents
+    qsizetype m_nextEvent = 0;
+    std::unordered_map<std::string_view, Histogram> m_histograms;
+    QHash<Qt::HANDLE, int> m_threadIndices;
+    QList<QString> m_threadNames; // By thread index
+};
+
+// Times the enclosing scope: { TraceSpan span("openFile"); ... }
+class TraceSpan
+{
+public:
+    explicit TraceSpan(const char *name, const char *category = "app")
+        : m_name(name), m_category(category), m_startNs(Tracer::isEnabled() ? Tracer::now() : -1)
+    {
+    }
+    ~TraceSpan()
+    {
+        if (m_startNs >= 0) {
+            Tracer::instance().complete(m_name, m_category, m_startNs);
+        }
+    }
+
+    TraceSpan(const TraceSpan &) = delete;
+    TraceSpan &operator=(const TraceSpan &) = delete;
+
+private:
+    const char *m_name;
+    const char *m_category;
+    qint64 m_startNs;
+};
+
+#endif // TRACER_H
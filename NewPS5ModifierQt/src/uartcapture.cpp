@@ -0,0 +1,274 @@
+#include "uartcapture.h"
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QtEndian>
+#include <chrono>
+
+namespace {
+
+constexpr int kRecordHeaderBytes = 12; // quint64 nanoseconds, quint32 length, both little endian
+
+bool fail(QString *errorString, const QString &message)
+{
+    if (errorString) {
+        *errorString = message;
+    }
+    return false;
+}
+
+QString segmentFileName(int sequence)
+{
+    return QString("segment-%1.z").arg(sequence, 6, 10, QChar('0'));
+}
+
+} // namespace
+
+UartCapture::UartCapture(QObject *parent) : QObject(parent)
+{
+    m_compressor.setMaxThreadCount(1);
+}
+
+UartCapture::~UartCapture()
+{
+    stop();
+}
+
+bool UartCapture::start(const QString &directory, QString *errorString)
+{
+    stop();
+    if (!QDir().mkpath(directory)) {
+        return fail(errorString, QString("Could not create %1").arg(QDir::toNativeSeparators(directory)));
+    }
+
+    // A directory that already holds a capture is continued rather than overwritten
+    m_storedSegments.clear();
+    m_storedBytes = 0;
+    m_nextSequence = 1;
+    for (const Segment &segment : readIndex(directory)) {
+        m_storedSegments.emplace_back(segment.fileName, segment.storedBytes);
+        m_storedBytes += segment.storedBytes;
+        m_nextSequence = segment.sequence + 1;
+    }
+
+    const QString sessionPath = directory + "/session.json";
+    if (!QFile::exists(sessionPath)) {
+        QSaveFile file(sessionPath);
+        QJsonObject session;
+        session["startedAt"] = QDateTime::currentMSecsSinceEpoch();
+        if (!file.open(QIODevice::WriteOnly) || file.write(QJsonDocument(session).toJson(QJsonDocument::Compact)) < 0
+            || !file.commit()) {
+            return fail(errorString, file.errorString());
+        }
+    }
+
+    m_directory = directory;
+    m_buffer.clear();
+    m_buffer.reserve(m_segmentBytes + 4096 + kRecordHeaderBytes);
+    m_segmentFirstNs = -1;
+    m_segmentRawBytes = 0;
+    m_bytesCaptured = 0;
+    // Timestamps stay relative to session.json, also when a capture is continued
+    m_clockOffsetNs = (QDateTime::currentMSecsSinceEpoch() - startedAt(directory)) * 1000000;
+    m_startSteadyNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    m_active = true;
+    return true;
+}
+
+void UartCapture::stop()
+{
+    if (!m_active) {
+        return;
+    }
+    rotate();
+    m_compressor.waitForDone();
+    m_active = false;
+}
+
+void UartCapture::append(QByteArrayView bytes, qint64 steadyNs)
+{
+    if (!m_active || bytes.isEmpty()) {
+        return;
+    }
+    const qint64 ns = m_clockOffsetNs + (steadyNs - m_startSteadyNs);
+    char header[kRecordHeaderBytes];
+    qToLittleEndian<quint64>(quint64(ns), header);
+    qToLittleEndian<quint32>(quint32(bytes.size()), header + 8);
+    m_buffer.append(header, kRecordHeaderBytes);
+    m_buffer.append(bytes);
+    if (m_segmentFirstNs < 0) {
+        m_segmentFirstNs = ns;
+    }
+    m_segmentLastNs = ns;
+    m_segmentRawBytes += bytes.size();
+    m_bytesCaptured += bytes.size();
+    if (m_buffer.size() >= m_segmentBytes) {
+        rotate();
+    }
+}
+
+void UartCapture::rotate()
+{
+    if (m_buffer.isEmpty()) {
+        return;
+    }
+    if (m_pendingSegments.load() >= MaxPendingSegments) {
+        m_compressor.waitForDone(); // The disk cannot keep up; block rather than let memory grow
+    }
+
+    const int sequence = m_nextSequence++;
+    const qint64 firstNs = m_segmentFirstNs;
+    const qint64 lastNs = m_segmentLastNs;
+    const qint64 rawBytes = m_segmentRawBytes;
+    QByteArray records;
+    records.swap(m_buffer);
+    m_buffer.reserve(m_segmentBytes + 4096 + kRecordHeaderBytes);
+    m_segmentFirstNs = -1;
+    m_segmentRawBytes = 0;
+
+    ++m_pendingSegments;
+    m_compressor.start([this, sequence, records, firstNs, lastNs, rawBytes]() {
+        writeSegment(sequence, records, firstNs, lastNs, rawBytes);
+        --m_pendingSegments;
+    });
+}
+
+void UartCapture::writeSegment(int sequence, const QByteArray &records, qint64 firstNs, qint64 lastNs, qint64 rawBytes)
+{
+    Segment segment;
+    segment.sequence = sequence;
+    segment.fileName = segmentFileName(sequence);
+    segment.firstNs = firstNs;
+    segment.lastNs = lastNs;
+    segment.rawBytes = rawBytes;
+
+    const QByteArray compressed = qCompress(records);
+    segment.storedBytes = compressed.size();
+    QSaveFile file(m_directory + '/' + segment.fileName);
+    if (!file.open(QIODevice::WriteOnly) || file.write(compressed) != compressed.size() || !file.commit()) {
+        const QString message = QString("Could not write capture segment %1: %2").arg(segment.fileName, file.errorString());
+        QMetaObject::invokeMethod(this, [this, message]() { emit errorOccurred(message); }, Qt::QueuedConnection);
+        return;
+    }
+
+    QJsonObject entry;
+    entry["sequence"] = sequence;
+    entry["file"] = segment.fileName;
+    entry["firstNs"] = firstNs;
+    entry["lastNs"] = lastNs;
+    entry["rawBytes"] = rawBytes;
+    entry["storedBytes"] = segment.storedBytes;
+    QFile index(m_directory + "/index.jsonl");
+    if (index.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        index.write(QJsonDocument(entry).toJson(QJsonDocument::Compact) + '\n');
+    }
+
+    // Oldest segments go first; the one just written always stays
+    m_storedSegments.emplace_back(segment.fileName, segment.storedBytes);
+    m_storedBytes += segment.storedBytes;
+    while (m_storedSegments.size() > 1 && m_storedBytes > m_maxStoredBytes) {
+        QFile::remove(m_directory + '/' + m_storedSegments.front().first);
+        m_storedBytes -= m_storedSegments.front().second;
+        m_storedSegments.pop_front();
+    }
+
+    QMetaObject::invokeMethod(this, [this, segment]() { emit segmentWritten(segment); }, Qt::QueuedConnection);
+}
+
+qint64 UartCapture::startedAt(const QString &directory)
+{
+    QFile file(directory + "/session.json");
+    if (!file.open(QIODevice::ReadOnly)) {
+        return 0;
+    }
+    return QJsonDocument::fromJson(file.readAll()).object().value("startedAt").toInteger();
+}
+
+QList<UartCapture::Segment> UartCapture::readIndex(const QString &directory)
+{
+    QList<Segment> segments;
+    QFile file(directory + "/index.jsonl");
+    if (!file.open(QIODevice::ReadOnly)) {
+        return segments;
+    }
+    while (!file.atEnd()) {
+        const QJsonObject entry = QJsonDocument::fromJson(file.readLine()).object();
+        Segment segment;
+        segment.sequence = entry.value("sequence").toInt();
+        segment.fileName = entry.value("file").toString();
+        segment.firstNs = entry.value("firstNs").toInteger();
+        segment.lastNs = entry.value("lastNs").toInteger();
+        segment.rawBytes = entry.value("rawBytes").toInteger();
+        segment.storedBytes = entry.value("storedBytes").toInteger();
+        // Rotated away segments keep their index line; only list what can still be read
+        if (segment.sequence > 0 && !segment.fileName.isEmpty() && QFile::exists(directory + '/' + segment.fileName)) {
+            segments.append(segment);
+        }
+    }
+    return segments;
+}
+
+bool UartCapture::readSegment(const QString &directory, const Segment &segment, QByteArray *records,
+                              QString *errorString)
+{
+    QFile file(directory + '/' + segment.fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return fail(errorString, QString("Could not open %1: %2").arg(segment.fileName, file.errorString()));
+    }
+    *records = qUncompress(file.readAll());
+    if (records->isEmpty()) {
+        return fail(errorString, QString("Capture segment %1 is damaged").arg(segment.fileName));
+    }
+    return true;
+}
+
+QList<UartCapture::Record> UartCapture::parseRecords(QByteArrayView records)
+{
+    QList<Record> result;
+    qsizetype offset = 0;
+    while (offset + kRecordHeaderBytes <= records.size()) {
+        const qint64 ns = qint64(qFromLittleEndian<quint64>(records.data() + offset));
+        const qsizetype length = qFromLittleEndian<quint32>(records.data() + offset + 8);
+        offset += kRecordHeaderBytes;
+        if (length > records.size() - offset) {
+            break; // Truncated tail
+        }
+        result.append({ ns, records.sliced(offset, length).toByteArray() });
+        offset += length;
+    }
+    return result;
+}
+
+QString UartCapture::formatText(QByteArrayView records, qint64 startedAtMs)
+{
+    QString text;
+    QByteArray line;
+    qint64 lineNs = -1;
+    const auto flush = [&]() {
+        const QDateTime time = QDateTime::fromMSecsSinceEpoch(startedAtMs + lineNs / 1000000);
+        text += '[' + time.toString("hh:mm:ss.zzz") + "] " + QString::fromUtf8(line) + '\n';
+        line.clear();
+        lineNs = -1;
+    };
+
+    for (const Record &record : parseRecords(records)) {
+        for (const char c : record.bytes) {
+            if (lineNs < 0) {
+                lineNs = record.ns; // A line is stamped with the time its first byte arrived
+            }
+            if (c == '\n') {
+                flush();
+            } else if (c != '\r') {
+                line.append(c);
+            }
+        }
+    }
+    if (lineNs >= 0) {
+        flush();
+    }
+    return text;
+}
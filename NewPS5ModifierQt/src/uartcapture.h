@@ -0,0 +1,105 @@
+#ifndef UARTCAPTURE_H
+#define UARTCAPTURE_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QThreadPool>
+#include <atomic>
+#include <deque>
+#include <utility>
+
+// Records every byte received from the console into a capture directory. Bytes are
+// framed as records (monotonic nanoseconds since the start, length, payload) in an
+// in-memory segment; a full segment is handed to a background thread that compresses
+// it into segment-NNNNNN.z and appends a line to index.jsonl. Once the segments on
+// disk exceed maxStoredBytes the oldest are deleted, so memory and disk use are
+// bounded however long the session runs.
+//
+// Readers only need index.jsonl to find a time range and then load that one segment.
+class UartCapture : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr qsizetype DefaultSegmentBytes = 256 * 1024;
+    static constexpr qint64 DefaultMaxStoredBytes = 256ll * 1024 * 1024;
+    // Segments waiting for the compressor before append() waits for it
+    static constexpr int MaxPendingSegments = 4;
+
+    struct Segment {
+        int sequence = 0;
+        QString fileName;
+        qint64 firstNs = 0;   // Timestamp of the first record
+        qint64 lastNs = 0;    // Timestamp of the last record
+        qint64 rawBytes = 0;  // Payload bytes received
+        qint64 storedBytes = 0;
+    };
+
+    struct Record {
+        qint64 ns = 0;
+        QByteArray bytes;
+    };
+
+    explicit UartCapture(QObject *parent = nullptr);
+    ~UartCapture() override;
+
+    // Starts a new capture in directory, which is created if needed.
+    bool start(const QString &directory, QString *errorString = nullptr);
+    // Writes the open segment and waits for the compressor.
+    void stop();
+    bool isActive() const { return m_active; }
+    QString directory() const { return m_directory; }
+    qint64 bytesCaptured() const { return m_bytesCaptured; }
+
+    void setSegmentBytes(qsizetype bytes) { m_segmentBytes = bytes; }
+    void setMaxStoredBytes(qint64 bytes) { m_maxStoredBytes = bytes; }
+
+    // Called with every chunk read from the port, on the owning thread. steadyNs is when
+    // the bytes were read, in std::chrono::steady_clock nanoseconds.
+    void append(QByteArrayView bytes, qint64 steadyNs);
+    // Records not written to a segment yet, in the segment format.
+    QByteArray openSegment() const { return m_buffer; }
+
+    // Start of the capture in milliseconds since the epoch, from session.json
+    static qint64 startedAt(const QString &directory);
+    // Segments still on disk, oldest first.
+    static QList<Segment> readIndex(const QString &directory);
+    static bool readSegment(const QString &directory, const Segment &segment, QByteArray *records,
+                            QString *errorString = nullptr);
+    static QList<Record> parseRecords(QByteArrayView records);
+    // One line per console line, prefixed with the wall clock time it started arriving.
+    static QString formatText(QByteArrayView records, qint64 startedAtMs);
+
+signals:
+    void segmentWritten(const UartCapture::Segment &segment);
+    void errorOccurred(const QString &message);
+
+private:
+    void rotate();
+    void writeSegment(int sequence, const QByteArray &records, qint64 firstNs, qint64 lastNs, qint64 rawBytes);
+
+    QString m_directory;
+    qint64 m_startSteadyNs = 0; // steady_clock at start()
+    qint64 m_clockOffsetNs = 0; // Session start to m_startSteadyNs
+    QByteArray m_buffer;
+    qsizetype m_segmentBytes = DefaultSegmentBytes;
+    qint64 m_maxStoredBytes = DefaultMaxStoredBytes;
+    qint64 m_bytesCaptured = 0;
+    qint64 m_segmentFirstNs = -1;
+    qint64 m_segmentLastNs = 0;
+    qint64 m_segmentRawBytes = 0;
+    int m_nextSequence = 1;
+    bool m_active = false;
+    std::atomic_int m_pendingSegments { 0 };
+
+    // Only touched on the compressor thread
+    std::deque<std::pair<QString, qint64>> m_storedSegments; // File name, size
+    qint64 m_storedBytes = 0;
+
+    QThreadPool m_compressor; // One thread, so segments and index lines stay in order
+};
+
+#endif // UARTCAPTURE_H
@@ -0,0 +1,202 @@
+#include "errordbserver.h"
+#include <QCryptographicHash>
+#include <QFile>
+#include <QFileInfo>
+#include <QLocale>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+#include <QUrl>
+#include <QUrlQuery>
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
+#include <cstdio>
+
+namespace {
+
+constexpr qsizetype kMaxRequestHeaderSize = 16 * 1024;
+
+} // namespace
+
+ErrorDbServer::ErrorDbServer(const QString &fixturePath, QObject *parent)
+    : ErrorDbServer(fixturePath, Options(), parent)
+{
+}
+
+ErrorDbServer::ErrorDbServer(const QString &fixturePath, const Options &options, QObject *parent)
+    : QObject(parent), m_fixturePath(fixturePath), m_options(options), m_server(new QTcpServer(this))
+{
+    connect(m_server, &QTcpServer::newConnection, this, &ErrorDbServer::onNewConnection);
+}
+
+bool ErrorDbServer::listen(const QHostAddress &address, quint16 port, QString *errorString)
+{
+    if (!m_server->listen(address, port)) {
+        if (errorString) {
+            *errorString = m_server->errorString();
+        }
+        return false;
+    }
+    return true;
+}
+
+quint16 ErrorDbServer::port() const
+{
+    return m_server->serverPort();
+}
+
+void ErrorDbServer::onNewConnection()
+{
+    while (QTcpSocket *socket = m_server->nextPendingConnection()) {
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { onReadyRead(socket); });
+        connect(socket, &QTcpSocket::disconnected, this, [this, socket]() {
+            m_buffers.remove(socket);
+            socket->deleteLater();
+        });
+    }
+}
+
+void ErrorDbServer::onReadyRead(QTcpSocket *socket)
+{
+    QByteArray &buffer = m_buffers[socket];
+    buffer += socket->readAll();
+    const qsizetype headerEnd = buffer.indexOf("\r\n\r\n");
+    if (headerEnd < 0) {
+        if (buffer.size() > kMaxRequestHeaderSize) {
+            send(socket, 431, "Request Header Fields Too Large", {}, QByteArray());
+        }
+        return;
+    }
+
+    const QList<QByteArray> lines = buffer.left(headerEnd).split('\n');
+    buffer.clear();
+    const QList<QByteArray> requestLine = lines.value(0).trimmed().split(' ');
+    if (requestLine.size() != 3 || requestLine[0] != "GET") {
+        send(socket, 405, "Method Not Allowed", { { "Allow", "GET" } }, QByteArray());
+        return;
+    }
+    QHash<QByteArray, QByteArray> headers;
+    for (qsizetype i = 1; i < lines.size(); ++i) {
+        const qsizetype colon = lines[i].indexOf(':');
+        if (colon > 0) {
+            headers.insert(lines[i].left(colon).trimmed().toLower(), lines[i].mid(colon + 1).trimmed());
+        }
+    }
+
+    ++m_requests;
+    const QByteArray target = requestLine[1];
+    if (m_options.delayMs > 0) {
+        QTimer::singleShot(m_options.delayMs, socket, [this, socket, target, headers]() { respond(socket, target, headers); });
+    } else {
+        respond(socket, target, headers);
+    }
+}
+
+void ErrorDbServer::respond(QTcpSocket *socket, const QByteArray &target, const QHash<QByteArray, QByteArray> &headers)
+{
+    QFile file(m_fixturePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        send(socket, 500, "Internal Server Error", {}, file.errorString().toUtf8());
+        return;
+    }
+    const QByteArray content = file.readAll();
+    QDateTime modified = QFileInfo(file).lastModified().toUTC();
+    if (!modified.isValid()) {
+        modified = m_started; // Bundled resource
+    }
+    file.close();
+
+    const QUrlQuery query(QUrl::fromEncoded(target).query());
+    if (query.hasQueryItem("errorCode")) {
+        ++m_lookupResponses;
+        std::fprintf(stderr, "dbserver: #%llu lookup %s\n", static_cast<unsigned long long>(m_requests),
+                     qPrintable(query.queryItemValue("errorCode")));
+        send(socket, 200, "OK", { { "Content-Type", "text/xml" } }, lookupXml(content, query.queryItemValue("errorCode")));
+        return;
+    }
+
+    QList<QPair<QByteArray, QByteArray>> responseHeaders { { "Content-Type", "text/xml" } };
+    if (m_options.validators) {
+        const QByteArray etag = '"' + QCryptographicHash::hash(content, QCryptographicHash::Sha1).toHex() + '"';
+        const QByteArray lastModified = httpDate(modified);
+        responseHeaders.append({ "ETag", etag });
+        responseHeaders.append({ "Last-Modified", lastModified });
+
+        // If-None-Match wins over If-Modified-Since, as in RFC 9110
+        bool notModified = false;
+        if (headers.contains("if-none-match")) {
+            notModified = headers.value("if-none-match") == etag || headers.value("if-none-match") == "*";
+        } else if (headers.contains("if-modified-since")) {
+            const QDateTime since = QDateTime::fromString(QString::fromLatin1(headers.value("if-modified-since")), Qt::RFC2822Date);
+            notModified = since.isValid() && modified.toSecsSinceEpoch() <= since.toSecsSinceEpoch();
+        }
+        if (notModified) {
+            ++m_notModifiedResponses;
+            std::fprintf(stderr, "dbserver: #%llu 304\n", static_cast<unsigned long long>(m_requests));
+            send(socket, 304, "Not Modified", responseHeaders, QByteArray());
+            return;
+        }
+    }
+    ++m_fullResponses;
+    std::fprintf(stderr, "dbserver: #%llu 200 (%lld bytes)\n", static_cast<unsigned long long>(m_requests),
+                 static_cast<long long>(content.size()));
+    send(socket, 200, "OK", responseHeaders, content);
+}
+
+QByteArray ErrorDbServer::lookupXml(const QByteArray &content, const QString &code) const
+{
+    QByteArray result;
+    QXmlStreamWriter writer(&result);
+    writer.writeStartDocument();
+    writer.writeStartElement("errorCodes");
+
+    QXmlStreamReader xml(content);
+    while (!xml.atEnd() && !xml.hasError()) {
+        if (xml.readNext() != QXmlStreamReader::StartElement || xml.name() != QLatin1String("errorCode")) {
+            continue;
+        }
+        QString entryCode;
+        QString description;
+        while (xml.readNextStartElement()) {
+            if (xml.name() == QLatin1String("ErrorCode")) {
+                entryCode = xml.readElementText().trimmed();
+            } else if (xml.name() == QLatin1String("Description")) {
+                description = xml.readElementText();
+            } else {
+                xml.skipCurrentElement();
+            }
+        }
+        if (entryCode.compare(code, Qt::CaseInsensitive) == 0) {
+            writer.writeStartElement("errorCode");
+            writer.writeTextElement("ErrorCode", entryCode);
+            writer.writeTextElement("Description", description);
+            writer.writeEndElement();
+            break;
+        }
+    }
+    writer.writeEndElement();
+    writer.writeEndDocument();
+    return result;
+}
+
+QByteArray ErrorDbServer::httpDate(const QDateTime &dateTime)
+{
+    return QLocale::c().toString(dateTime.toUTC(), "ddd, dd MMM yyyy hh:mm:ss 'GMT'").toLatin1();
+}
+
+void ErrorDbServer::send(QTcpSocket *socket, int status, const QByteArray &reason,
+                         const QList<QPair<QByteArray, QByteArray>> &headers, const QByteArray &body)
+{
+    QByteArray response = "HTTP/1.1 " + QByteArray::number(status) + ' ' + reason + "\r\n";
+    for (const auto &header : headers) {
+        response += header.first + ": " + header.second + "\r\n";
+    }
+    // 304 carries no body, so no Content-Length either
+    if (status != 304) {
+        response += "Content-Length: " + QByteArray::number(body.size()) + "\r\n";
+    }
+    response += "Connection: close\r\n\r\n";
+    response += body;
+    socket->write(response);
+    socket->disconnectFromHost();
+}
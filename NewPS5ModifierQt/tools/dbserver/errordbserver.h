@@ -0,0 +1,60 @@
+#ifndef ERRORDBSERVER_H
+#define ERRORDBSERVER_H
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QHash>
+#include <QHostAddress>
+#include <QObject>
+#include <QString>
+
+class QTcpServer;
+class QTcpSocket;
+
+// Minimal HTTP/1.1 stand-in for uartcodes.com/xml.php, serving a fixture XML. Any path
+// returns the whole file with an ETag (SHA-1 of the content) and Last-Modified (file
+// mtime), honouring If-None-Match / If-Modified-Since with 304. "?errorCode=X" returns
+// just that entry, like the online lookup. The fixture is re-read on every request, so
+// editing it between downloads exercises the update path. One request per connection.
+class ErrorDbServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Options {
+        bool validators = true; // Send ETag / Last-Modified and answer conditional requests
+        int delayMs = 0;        // Hold every response back, e.g. to overlap client requests
+    };
+
+    explicit ErrorDbServer(const QString &fixturePath, QObject *parent = nullptr);
+    ErrorDbServer(const QString &fixturePath, const Options &options, QObject *parent = nullptr);
+
+    bool listen(const QHostAddress &address = QHostAddress::LocalHost, quint16 port = 0, QString *errorString = nullptr);
+    quint16 port() const;
+
+    quint64 requestCount() const { return m_requests; }
+    quint64 fullResponses() const { return m_fullResponses; }
+    quint64 notModifiedResponses() const { return m_notModifiedResponses; }
+    quint64 lookupResponses() const { return m_lookupResponses; }
+
+private:
+    void onNewConnection();
+    void onReadyRead(QTcpSocket *socket);
+    void respond(QTcpSocket *socket, const QByteArray &target, const QHash<QByteArray, QByteArray> &headers);
+    QByteArray lookupXml(const QByteArray &content, const QString &code) const;
+    static QByteArray httpDate(const QDateTime &dateTime);
+    static void send(QTcpSocket *socket, int status, const QByteArray &reason,
+                     const QList<QPair<QByteArray, QByteArray>> &headers, const QByteArray &body);
+
+    QString m_fixturePath;
+    Options m_options;
+    QTcpServer *m_server;
+    QHash<QTcpSocket *, QByteArray> m_buffers;
+    QDateTime m_started = QDateTime::currentDateTimeUtc();
+    quint64 m_requests = 0;
+    quint64 m_fullResponses = 0;
+    quint64 m_notModifiedResponses = 0;
+    quint64 m_lookupResponses = 0;
+};
+
+#endif // ERRORDBSERVER_H
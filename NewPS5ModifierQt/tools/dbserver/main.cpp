@@ -0,0 +1,73 @@
+// Local stand-in for the uartcodes.com error database. Prints the URL to use and serves
+// until interrupted; run the app with PS5NOR_DATABASE_URL set to that URL.
+#include "errordbserver.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QFileInfo>
+#include <QSocketNotifier>
+#include <csignal>
+#include <cstdio>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+int signalPipe[2] = { -1, -1 };
+
+void onSignal(int)
+{
+    const char c = 1;
+    [[maybe_unused]] const ssize_t written = ::write(signalPipe[1], &c, 1);
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("dbserver");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Serves a fixture errorDB.xml like uartcodes.com/xml.php.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("fixture", "XML file to serve (defaults to the bundled fixture).");
+    QCommandLineOption portOption("port", "TCP port to listen on; 0 picks a free one.", "port", "0");
+    QCommandLineOption noValidatorsOption("no-validators", "Send no ETag/Last-Modified and never answer 304.");
+    QCommandLineOption delayOption("delay-ms", "Delay before every response.", "ms", "0");
+    parser.addOptions({ portOption, noValidatorsOption, delayOption });
+    parser.process(app);
+
+    const QStringList positional = parser.positionalArguments();
+    const QString fixture = positional.isEmpty() ? QStringLiteral(":/fixtures/errorDB.xml") : positional.first();
+    if (!QFileInfo::exists(fixture)) {
+        std::fprintf(stderr, "dbserver: %s not found\n", qPrintable(fixture));
+        return 1;
+    }
+
+    ErrorDbServer::Options options;
+    options.validators = !parser.isSet(noValidatorsOption);
+    options.delayMs = parser.value(delayOption).toInt();
+    ErrorDbServer server(fixture, options);
+    QString error;
+    if (!server.listen(QHostAddress::LocalHost, quint16(parser.value(portOption).toUInt()), &error)) {
+        std::fprintf(stderr, "dbserver: %s\n", qPrintable(error));
+        return 1;
+    }
+    std::printf("http://127.0.0.1:%u/xml.php\n", unsigned(server.port()));
+    std::fflush(stdout);
+
+    // Quit cleanly on Ctrl+C / SIGTERM so the request counts are printed
+    if (::socketpair(AF_UNIX, SOCK_STREAM, 0, signalPipe) == 0) {
+        auto *notifier = new QSocketNotifier(signalPipe[0], QSocketNotifier::Read, &app);
+        QObject::connect(notifier, &QSocketNotifier::activated, &app, &QCoreApplication::quit);
+        std::signal(SIGINT, onSignal);
+        std::signal(SIGTERM, onSignal);
+    }
+    const int result = app.exec();
+    std::fprintf(stderr, "dbserver: %llu requests, %llu full, %llu not modified, %llu lookups\n",
+                 static_cast<unsigned long long>(server.requestCount()),
+                 static_cast<unsigned long long>(server.fullResponses()),
+                 static_cast<unsigned long long>(server.notModifiedResponses()),
+                 static_cast<unsigned long long>(server.lookupResponses()));
+    return result;
+}
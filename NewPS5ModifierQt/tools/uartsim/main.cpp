@@ -0,0 +1,71 @@
+// Stand-alone PS5 UART console simulator: prints the pty to connect to and answers
+// until interrupted. Point the app's serial port (or a terminal) at the printed path.
+#include "uartsimulator.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QSocketNotifier>
+#include <csignal>
+#include <cstdio>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+int signalPipe[2] = { -1, -1 };
+
+void onSignal(int)
+{
+    const char c = 1;
+    // Nothing useful to do on failure inside a signal handler; a full pipe already wakes the loop
+    [[maybe_unused]] const ssize_t written = ::write(signalPipe[1], &c, 1);
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("uartsim");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Simulates a PS5 UART console on a pseudo-terminal.");
+    parser.addHelpOption();
+    QCommandLineOption delayOption("byte-delay-us", "Delay per transmitted byte (87 ~ 115200 baud).", "us", "0");
+    QCommandLineOption jitterOption("jitter-us", "Random extra delay per byte, up to this value.", "us", "0");
+    QCommandLineOption codesOption("codes", "Comma separated error codes for errlog 0, 1, ...", "codes");
+    QCommandLineOption seedOption("seed", "Seed for the jitter generator.", "n", "1");
+    parser.addOptions({ delayOption, jitterOption, codesOption, seedOption });
+    parser.process(app);
+
+    UartSimulator::Options options;
+    options.byteDelayUs = parser.value(delayOption).toInt();
+    options.jitterUs = parser.value(jitterOption).toInt();
+    options.seed = parser.value(seedOption).toUInt();
+
+    UartSimulator simulator(options);
+    if (parser.isSet(codesOption)) {
+        simulator.setErrorLog(parser.value(codesOption).split(',', Qt::SkipEmptyParts));
+    }
+    QString error;
+    if (!simulator.start(&error)) {
+        std::fprintf(stderr, "uartsim: %s\n", qPrintable(error));
+        return 1;
+    }
+    std::printf("%s\n", qPrintable(simulator.portName()));
+    std::fflush(stdout);
+
+    // Quit cleanly on Ctrl+C / SIGTERM so the pty is released
+    if (::socketpair(AF_UNIX, SOCK_STREAM, 0, signalPipe) == 0) {
+        auto *notifier = new QSocketNotifier(signalPipe[0], QSocketNotifier::Read, &app);
+        QObject::connect(notifier, &QSocketNotifier::activated, &app, &QCoreApplication::quit);
+        std::signal(SIGINT, onSignal);
+        std::signal(SIGTERM, onSignal);
+    }
+
+    const int result = app.exec();
+    simulator.stop();
+    std::fprintf(stderr, "uartsim: %llu commands, %llu checksum errors\n",
+                 static_cast<unsigned long long>(simulator.commandsHandled()),
+                 static_cast<unsigned long long>(simulator.checksumErrors()));
+    return result;
+}
@@ -0,0 +1,225 @@
+#include "uartsimulator.h"
+#include "serialprotocol.h"
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+namespace {
+
+// Fixed status words after the code: RTC, power state, up cause, sequence, temperatures
+QString errorLogLine(const QString &code, int slot)
+{
+    return QString("OK 00000000 %1 %2 00000000 00060008 %3 00000000 2C2D")
+        .arg(code)
+        .arg(0x5F3E0000 + slot * 0x100, 8, 16, QChar('0'))
+        .arg(slot, 4, 16, QChar('0'))
+        .toUpper();
+}
+
+} // namespace
+
+UartSimulator::UartSimulator() : UartSimulator(Options())
+{
+}
+
+UartSimulator::UartSimulator(const Options &options)
+    : m_options(options),
+      m_errorLog({ "80810001", "80801101", "C0010001" }),
+      m_rng(options.seed)
+{
+}
+
+UartSimulator::~UartSimulator()
+{
+    stop();
+}
+
+bool UartSimulator::start(QString *errorString)
+{
+    if (m_running) {
+        return true;
+    }
+    m_master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (m_master < 0 || grantpt(m_master) != 0 || unlockpt(m_master) != 0) {
+        if (errorString) {
+            *errorString = QString("Could not create pty: %1").arg(std::strerror(errno));
+        }
+        stop();
+        return false;
+    }
+    m_portName = QString::fromLocal8Bit(ptsname(m_master));
+    m_slave = ::open(ptsname(m_master), O_RDWR | O_NOCTTY);
+    if (m_slave < 0) {
+        if (errorString) {
+            *errorString = QString("Could not open %1: %2").arg(m_portName, std::strerror(errno));
+        }
+        stop();
+        return false;
+    }
+
+    // Raw on both ends: no line discipline echo or CR/LF translation, like a real UART
+    termios tio;
+    if (tcgetattr(m_slave, &tio) == 0) {
+        cfmakeraw(&tio);
+        tcsetattr(m_slave, TCSANOW, &tio);
+    }
+    if (tcgetattr(m_master, &tio) == 0) {
+        cfmakeraw(&tio);
+        tcsetattr(m_master, TCSANOW, &tio);
+    }
+    // Non-blocking master: with m_slave held open here a client that stops reading never
+    // produces EIO, so a blocking write would stall run() and stop() with it
+    const int flags = fcntl(m_master, F_GETFL);
+    if (flags < 0 || fcntl(m_master, F_SETFL, flags | O_NONBLOCK) != 0) {
+        if (errorString) {
+            *errorString = QString("Could not make %1 non-blocking: %2").arg(m_portName, std::strerror(errno));
+        }
+        stop();
+        return false;
+    }
+
+    m_running = true;
+    m_thread = std::thread(&UartSimulator::run, this);
+    return true;
+}
+
+void UartSimulator::stop()
+{
+    m_running = false;
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    if (m_slave >= 0) {
+        ::close(m_slave);
+        m_slave = -1;
+    }
+    if (m_master >= 0) {
+        ::close(m_master);
+        m_master = -1;
+    }
+}
+
+void UartSimulator::setErrorLog(const QStringList &codes)
+{
+    std::lock_guard<std::mutex> lock(m_errorLogMutex);
+    m_errorLog = codes;
+}
+
+QStringList UartSimulator::errorLog() const
+{
+    std::lock_guard<std::mutex> lock(m_errorLogMutex);
+    return m_errorLog;
+}
+
+void UartSimulator::run()
+{
+    QByteArray pending;
+    char buffer[512];
+    while (m_running) {
+        pollfd pfd { m_master, POLLIN, 0 };
+        if (poll(&pfd, 1, 50) <= 0 || !(pfd.revents & POLLIN)) {
+            continue; // Re-check m_running
+        }
+        const ssize_t n = ::read(m_master, buffer, sizeof(buffer));
+        if (n <= 0) {
+            continue;
+        }
+        pending.append(buffer, n);
+        qsizetype newline;
+        while ((newline = pending.indexOf('\n')) >= 0) {
+            const QByteArray line = pending.left(newline).trimmed();
+            pending.remove(0, newline + 1);
+            if (!line.isEmpty()) {
+                handleLine(line);
+            }
+        }
+    }
+}
+
+void UartSimulator::handleLine(const QByteArray &line)
+{
+    write(line + "\r\n"); // The console echoes every line as received
+
+    const QString text = QString::fromLatin1(line);
+    const qsizetype colon = text.lastIndexOf(':');
+    const QString command = colon >= 0 ? text.left(colon) : text;
+    if (colon < 0 || text.mid(colon + 1).compare(SerialProtocol::checksum(command), Qt::CaseInsensitive) != 0) {
+        ++m_checksumErrors;
+        send("NG E0000003");
+        return;
+    }
+    ++m_commandsHandled;
+    send(QString::fromLatin1(replyFor(command)));
+}
+
+QByteArray UartSimulator::replyFor(const QString &command)
+{
+    if (command == QLatin1String("errlog clear")) {
+        setErrorLog({});
+        return "OK 00000000";
+    }
+    if (command.startsWith(QLatin1String("errlog "))) {
+        bool ok = false;
+        const int slot = command.mid(7).toInt(&ok);
+        if (ok && slot >= 0) {
+            const QStringList codes = errorLog();
+            const QString code = slot < codes.size() ? codes.at(slot) : QString("FFFFFFFF");
+            return errorLogLine(code, slot).toLatin1();
+        }
+    }
+    return "NG E0000001"; // Unknown command
+}
+
+void UartSimulator::send(const QString &line)
+{
+    write(SerialProtocol::frame(line).toLatin1() + "\r\n"); // Replies carry a checksum too
+}
+
+void UartSimulator::write(const QByteArray &bytes)
+{
+    if (m_options.byteDelayUs <= 0 && m_options.jitterUs <= 0) {
+        writeAll(bytes.constData(), size_t(bytes.size()));
+        return;
+    }
+    std::uniform_int_distribution<int> jitter(0, qMax(0, m_options.jitterUs));
+    for (char c : bytes) {
+        if (!writeAll(&c, 1)) {
+            return;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(m_options.byteDelayUs + jitter(m_rng)));
+    }
+}
+
+// Every byte reaches the pty, or the link is treated as gone: a dropped byte would look
+// like line noise to the client and skew benchmark results
+bool UartSimulator::writeAll(const char *data, size_t length)
+{
+    while (length > 0) {
+        const ssize_t n = ::write(m_master, data, length);
+        if (n > 0) {
+            data += n;
+            length -= size_t(n);
+            continue;
+        }
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            pollfd pfd { m_master, POLLOUT, 0 };
+            while (m_running.load() && poll(&pfd, 1, 50) == 0) {
+                // Client is not reading; re-check m_running so stop() is not held up
+            }
+            if (!m_running.load()) {
+                return false;
+            }
+            continue;
+        }
+        return false;
+    }
+    return true;
+}
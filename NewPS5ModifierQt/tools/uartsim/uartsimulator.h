@@ -0,0 +1,68 @@
+#ifndef UARTSIMULATOR_H
+#define UARTSIMULATOR_H
+
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+#include <atomic>
+#include <mutex>
+#include <random>
+#include <thread>
+
+// Pseudo-terminal that answers like a PS5 UART console (Linux/POSIX only). Clients open
+// portName() with QSerialPort as if it were a USB adapter. Command lines must carry the
+// ":XX" checksum computed by SerialProtocol::checksum(); the simulator echoes each line,
+// then replies with an OK/NG line. Output is written byte by byte with a configurable
+// delay and jitter to approximate the real link.
+class UartSimulator
+{
+public:
+    struct Options {
+        int byteDelayUs = 0; // 87 approximates 115200 baud 8N1
+        int jitterUs = 0;    // Uniform extra delay per byte, 0..jitterUs
+        quint32 seed = 1;
+    };
+
+    UartSimulator();
+    explicit UartSimulator(const Options &options);
+    ~UartSimulator();
+
+    UartSimulator(const UartSimulator &) = delete;
+    UartSimulator &operator=(const UartSimulator &) = delete;
+
+    bool start(QString *errorString = nullptr);
+    void stop();
+    bool isRunning() const { return m_running.load(); }
+
+    // Slave side of the pty, e.g. "/dev/pts/7".
+    QString portName() const { return m_portName; }
+
+    // Error codes reported by "errlog 0", "errlog 1", ...; slots past the end read as erased.
+    void setErrorLog(const QStringList &codes);
+    QStringList errorLog() const;
+
+    quint64 commandsHandled() const { return m_commandsHandled.load(); }
+    quint64 checksumErrors() const { return m_checksumErrors.load(); }
+
+private:
+    void run();
+    void handleLine(const QByteArray &line);
+    QByteArray replyFor(const QString &command);
+    void send(const QString &line);
+    void write(const QByteArray &bytes);
+    bool writeAll(const char *data, size_t length);
+
+    Options m_options;
+    int m_master = -1;
+    int m_slave = -1; // Held open so the pty survives clients reconnecting
+    QString m_portName;
+    std::thread m_thread;
+    std::atomic<bool> m_running { false };
+    std::atomic<quint64> m_commandsHandled { 0 };
+    std::atomic<quint64> m_checksumErrors { 0 };
+    mutable std::mutex m_errorLogMutex;
+    QStringList m_errorLog;
+    std::mt19937 m_rng;
+};
+
+#endif // UARTSIMULATOR_H